@@ -0,0 +1,113 @@
+//
+// Created on 2025/3/4.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#ifndef JEMOC_STREAM_BENCH_CORPUS_H
+#define JEMOC_STREAM_BENCH_CORPUS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * 基准测试使用的固定语料，由固定种子生成，保证不同版本之间的结果可比
+ */
+namespace BenchCorpus {
+
+class Random {
+public:
+    explicit Random(uint64_t seed) : state_(seed) {}
+    uint64_t next() {
+        state_ ^= state_ << 13;
+        state_ ^= state_ >> 7;
+        state_ ^= state_ << 17;
+        return state_;
+    }
+
+private:
+    uint64_t state_;
+};
+
+static const char *const LoremWords[] = {
+    "lorem",       "ipsum",      "dolor",     "sit",        "amet",       "consectetur", "adipiscing", "elit",
+    "sed",         "do",         "eiusmod",   "tempor",     "incididunt", "ut",          "labore",     "et",
+    "dolore",      "magna",      "aliqua",    "enim",       "ad",         "minim",       "veniam",     "quis",
+    "nostrud",     "exercitation", "ullamco", "laboris",    "nisi",       "aliquip",     "ex",         "ea",
+    "commodo",     "consequat",  "duis",      "aute",       "irure",      "in",          "reprehenderit",
+    "voluptate",   "velit",      "esse",      "cillum",     "fugiat",     "nulla",       "pariatur",   "excepteur",
+    "sint",        "occaecat",   "cupidatat", "non",        "proident",   "sunt",        "culpa",      "qui",
+    "officia",     "deserunt",   "mollit",    "anim",       "id",         "est",         "laborum"};
+
+// 与ohosTest中lorem.ets相同风格的英文段落，每行约80个字符
+inline std::string loremText(size_t size) {
+    Random random(0x6a656d6f63ULL);
+    const size_t wordCount = sizeof(LoremWords) / sizeof(LoremWords[0]);
+    std::string text;
+    text.reserve(size + 128);
+    size_t lineLength = 0;
+    bool sentenceStart = true;
+    while (text.size() < size) {
+        std::string word = LoremWords[random.next() % wordCount];
+        if (sentenceStart)
+            word[0] = static_cast<char>(word[0] - 'a' + 'A');
+        sentenceStart = random.next() % 12 == 0;
+        if (sentenceStart)
+            word += '.';
+        else if (random.next() % 9 == 0)
+            word += ',';
+        if (lineLength + word.size() + 1 > 80) {
+            text += '\n';
+            lineLength = 0;
+        } else if (lineLength > 0) {
+            text += ' ';
+            lineLength++;
+        }
+        text += word;
+        lineLength += word.size();
+    }
+    text.resize(size);
+    return text;
+}
+
+// 不可压缩数据
+inline std::vector<uint8_t> randomBytes(size_t size) {
+    Random random(0x5eed5eedULL);
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; i++)
+        data[i] = static_cast<uint8_t>(random.next() >> 24);
+    return data;
+}
+
+inline std::string xmlDocument(size_t size) {
+    Random random(0x786d6cULL);
+    std::string lorem = loremText(4096);
+    std::string xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<catalog>\n";
+    xml.reserve(size + 512);
+    long id = 0;
+    while (xml.size() < size) {
+        size_t offset = random.next() % (lorem.size() - 200);
+        size_t length = 40 + random.next() % 160;
+        std::string text = lorem.substr(offset, length);
+        for (char &ch : text) {
+            if (ch == '\n')
+                ch = ' ';
+        }
+        xml += "  <item id=\"" + std::to_string(id++) + "\" type=\"" + LoremWords[random.next() % 8] + "\">\n";
+        xml += "    <title>" + text.substr(0, 32) + "</title>\n";
+        if (id % 7 == 0)
+            xml += "    <!-- " + text.substr(0, 24) + " -->\n";
+        if (id % 5 == 0)
+            xml += "    <raw><![CDATA[" + text + "]]></raw>\n";
+        else
+            xml += "    <body>" + text + "</body>\n";
+        xml += "    <empty/>\n  </item>\n";
+    }
+    xml += "</catalog>\n";
+    return xml;
+}
+
+} // namespace BenchCorpus
+
+#endif // JEMOC_STREAM_BENCH_CORPUS_H
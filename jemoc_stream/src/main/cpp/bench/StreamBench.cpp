@@ -0,0 +1,549 @@
+//
+// Created on 2025/3/4.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#include "BenchCorpus.h"
+#include "deflate/DeflateUtils.h"
+#include "reader/StreamReader.h"
+#include "reader/XmlReader.h"
+#include "stream/AsyncFileStream.h"
+#include "stream/AsyncIoQueue.h"
+#include "stream/BrotliStream.h"
+#include "stream/DeflateStream.h"
+#include "stream/FileStream.h"
+#include "stream/MemfdStream.h"
+#include "stream/MemoryStream.h"
+#include "stream/ReadAheadStream.h"
+#include "zip/ZipArchive.h"
+#include "zip/ZipArchiveEntry.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <unistd.h>
+
+#ifndef JEMOC_STREAM_VERSION
+#define JEMOC_STREAM_VERSION "unknown"
+#endif
+
+struct BenchResult {
+    std::string name;
+    long bytes;
+    long iterations;
+    double seconds;
+    std::map<std::string, double> extra;
+};
+
+/**
+ * 每个用例先预热一次，再重复执行直到累计耗时超过minTime，按字节数换算吞吐
+ */
+class BenchRunner {
+public:
+    double minTime = 0.5;
+    std::string filter;
+
+    void run(const std::string &name, long bytes, const std::function<void()> &func,
+             const std::map<std::string, double> &extra = {}) {
+        if (!filter.empty() && name.find(filter) == std::string::npos)
+            return;
+        using Clock = std::chrono::steady_clock;
+        func();
+        long iterations = 0;
+        auto start = Clock::now();
+        double elapsed = 0;
+        do {
+            func();
+            iterations++;
+            elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        } while (elapsed < minTime);
+        results_.push_back({name, bytes, iterations, elapsed, extra});
+        std::cerr << name << ": " << throughput(results_.back()) << " MB/s" << std::endl;
+    }
+
+    void writeJson(std::ostream &out, size_t corpusSize) const {
+        out << "{\n  \"suite\": \"jemoc_stream_bench\",\n  \"version\": \"" << JEMOC_STREAM_VERSION << "\",\n"
+            << "  \"corpusSize\": " << corpusSize << ",\n  \"results\": [";
+        for (size_t i = 0; i < results_.size(); i++) {
+            const BenchResult &result = results_[i];
+            out << (i == 0 ? "\n" : ",\n") << "    {\"name\": \"" << result.name << "\", \"bytes\": " << result.bytes
+                << ", \"iterations\": " << result.iterations << ", \"seconds\": " << result.seconds
+                << ", \"nsPerIteration\": " << result.seconds * 1e9 / result.iterations
+                << ", \"mbPerSecond\": " << throughput(result);
+            for (const auto &item : result.extra)
+                out << ", \"" << item.first << "\": " << item.second;
+            out << "}";
+        }
+        out << "\n  ]\n}\n";
+    }
+
+private:
+    static double throughput(const BenchResult &result) {
+        return result.bytes * result.iterations / result.seconds / (1024 * 1024);
+    }
+
+    std::vector<BenchResult> results_;
+};
+
+static void writeChunked(IStream *stream, const void *data, size_t size, size_t chunkSize) {
+    for (size_t offset = 0; offset < size; offset += chunkSize)
+        stream->write(const_cast<void *>(data), offset, std::min(chunkSize, size - offset));
+}
+
+static long readChunked(IStream *stream, std::vector<uint8_t> &buffer) {
+    long total = 0;
+    long readBytes = 0;
+    while ((readBytes = stream->read(buffer.data(), 0, buffer.size())) > 0)
+        total += readBytes;
+    return total;
+}
+
+/**
+ * 按ChunkIterator的方式通过AsyncIoQueue逐块读取，每次等待上一块完成后再提交，衡量单次异步读取的固定开销
+ */
+static long readQueued(IStream *stream, size_t chunkSize) {
+    struct ReadTask : public AsyncIoQueue::Task {
+        IStream *stream;
+        uint8_t *buffer;
+        size_t count;
+        long result = 0;
+        void execute() override { result = stream->read(buffer, 0, count); }
+    };
+    std::vector<uint8_t> buffer(chunkSize);
+    std::mutex mutex;
+    std::condition_variable completed;
+    bool ready = false;
+    AsyncIoQueue queue;
+    queue.setNotify([&]() {
+        std::lock_guard<std::mutex> lock(mutex);
+        ready = true;
+        completed.notify_one();
+    });
+    stream->seek(0, SeekOrigin::Begin);
+    long total = 0;
+    while (true) {
+        auto task = std::make_unique<ReadTask>();
+        task->stream = stream;
+        task->buffer = buffer.data();
+        task->count = chunkSize;
+        queue.submit(std::move(task));
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            completed.wait(lock, [&]() { return ready; });
+            ready = false;
+        }
+        long readBytes = 0;
+        for (auto &done : queue.takeCompleted())
+            readBytes += static_cast<ReadTask *>(done.get())->result;
+        if (readBytes <= 0)
+            return total;
+        total += readBytes;
+    }
+}
+
+/**
+ * 通过AsyncFileStream一次性提交全部读取，等待全部完成，衡量多个请求同时在执行时的吞吐
+ */
+static long readInFlight(AsyncFileStream *stream, std::vector<uint8_t> &buffer, size_t chunkSize) {
+    stream->seek(0, SeekOrigin::Begin);
+    size_t offset = 0;
+    while (offset + chunkSize <= buffer.size()) {
+        auto request = std::make_unique<AsyncFileIo::Request>();
+        request->buffer = buffer.data() + offset;
+        request->length = chunkSize;
+        if (!stream->submitRead(std::move(request)))
+            break;
+        offset += chunkSize;
+    }
+    stream->getIo()->drain();
+    long total = 0;
+    for (auto &done : stream->getIo()->takeCompleted())
+        total += done->result;
+    return total;
+}
+
+static std::shared_ptr<MemoryStream> compressDeflate(const std::string &input, int level, int threads = 1) {
+    auto output = std::make_shared<MemoryStream>();
+    DeflateStream deflate(output, DeflateMode_Compress, -15, level, true, DEFAULT_BUFFER_SIZE, -1, threads);
+    writeChunked(&deflate, input.data(), input.size(), 64 * 1024);
+    deflate.close();
+    return output;
+}
+
+static std::shared_ptr<MemoryStream> compressBrotli(const std::string &input, int quality) {
+    auto output = std::make_shared<MemoryStream>();
+    BrotliConfig config;
+    config.quality = quality;
+    BrotliStream brotli(output, BrotliStream::Compress, config, true, 64 * 1024);
+    writeChunked(&brotli, input.data(), input.size(), 64 * 1024);
+    brotli.close();
+    return output;
+}
+
+static void benchStreams(BenchRunner &runner, const std::string &lorem) {
+    const long size = lorem.size();
+
+    runner.run("MemoryStream/write-4k", size, [&]() {
+        MemoryStream stream;
+        writeChunked(&stream, lorem.data(), lorem.size(), 4096);
+    });
+    runner.run("MemoryStream/write-4k-chunked", size, [&]() {
+        MemoryStream stream(0, MemoryStream::DefaultChunkSize);
+        writeChunked(&stream, lorem.data(), lorem.size(), 4096);
+    });
+    MemoryStream memory;
+    writeChunked(&memory, lorem.data(), lorem.size(), 64 * 1024);
+    std::vector<uint8_t> small(4096);
+    runner.run("MemoryStream/read-4k", size, [&]() {
+        memory.seek(0, SeekOrigin::Begin);
+        readChunked(&memory, small);
+    });
+
+    char path[] = "/tmp/jemoc_stream_bench_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd >= 0)
+        ::close(fd);
+    runner.run("FileStream/write-64k", size, [&]() {
+        FileStream stream(path, FILE_MODE(FILE_MODE_WRITE | FILE_MODE_TRUNC), 8192);
+        writeChunked(&stream, lorem.data(), lorem.size(), 64 * 1024);
+        stream.close();
+    });
+    runner.run("FileStream/read-4k", size, [&]() {
+        FileStream stream(path, FILE_MODE_READ, 8192);
+        readChunked(&stream, small);
+        stream.close();
+    });
+    std::vector<uint8_t> tiny(256);
+    runner.run("FileStream/read-256", size, [&]() {
+        FileStream stream(path, FILE_MODE_READ, 8192);
+        readChunked(&stream, tiny);
+        stream.close();
+    });
+    runner.run("FileStream/read-4k-mmap", size, [&]() {
+        FileStream stream(path, FILE_MODE(FILE_MODE_READ | FILE_MODE_MMAP), 8192);
+        readChunked(&stream, small);
+        stream.close();
+    });
+    std::vector<uint8_t> whole(size + 64 * 1024);
+    for (bool uring : {true, false}) {
+        AsyncFileStream stream(path, FILE_MODE_READ, 8192, 8, uring);
+        runner.run(std::string("AsyncFileStream/read-16k-depth8-") + stream.getIo()->getEngine(), size,
+                   [&]() { readInFlight(&stream, whole, 16 * 1024); });
+        stream.close();
+    }
+    runner.run("FileStream/copyTo-FileStream", size, [&]() {
+        FileStream source(path, FILE_MODE_READ, 8192);
+        std::string copyPath = std::string(path) + ".copy";
+        FileStream target(copyPath, FILE_MODE(FILE_MODE_WRITE | FILE_MODE_TRUNC), 8192);
+        source.copyTo(&target, 64 * 1024);
+        target.close();
+        source.close();
+    });
+    // 关闭时等待数据落盘，衡量的是不占页缓存的持久写入吞吐，放在读取用例之后避免影响它们的缓存
+    std::string noCachePath = std::string(path) + ".nocache";
+    runner.run("FileStream/write-64k-nocache", size, [&]() {
+        FileStream stream(noCachePath, FILE_MODE(FILE_MODE_WRITE | FILE_MODE_TRUNC | FILE_MODE_NOCACHE), 8192);
+        writeChunked(&stream, lorem.data(), lorem.size(), 64 * 1024);
+        stream.close();
+    });
+    unlink(path);
+    unlink((std::string(path) + ".copy").c_str());
+    unlink(noCachePath.c_str());
+
+    // 复用同一个MemfdStream，避免每次迭代创建新的共享内存对象
+    MemfdStream memfd;
+    runner.run("MemfdStream/write-64k", size, [&]() {
+        memfd.setLength(0);
+        memfd.seek(0, SeekOrigin::Begin);
+        writeChunked(&memfd, lorem.data(), lorem.size(), 64 * 1024);
+    });
+    runner.run("MemfdStream/read-4k", size, [&]() {
+        memfd.seek(0, SeekOrigin::Begin);
+        readChunked(&memfd, small);
+    });
+    // 长度以内的覆盖写直接写映射，不经过系统调用
+    runner.run("MemfdStream/overwrite-4k", size, [&]() {
+        memfd.seek(0, SeekOrigin::Begin);
+        writeChunked(&memfd, lorem.data(), lorem.size(), 4096);
+    });
+    memfd.close();
+
+    runner.run("AsyncIoQueue/read-8k", size, [&]() { readQueued(&memory, 8192); });
+}
+
+static void benchDeflate(BenchRunner &runner, const std::string &lorem, const std::vector<uint8_t> &random) {
+    std::vector<uint8_t> buffer(64 * 1024);
+    for (int level = 0; level <= 9; level++) {
+        double ratio = static_cast<double>(compressDeflate(lorem, level)->getLength()) / lorem.size();
+        runner.run("DeflateStream/compress/level-" + std::to_string(level), lorem.size(),
+                   [&]() { compressDeflate(lorem, level); }, {{"ratio", ratio}});
+    }
+    // 分块多线程压缩，快速模式下语料只有两三个块，完整语料才能体现加速
+    for (int threads : {2, 4}) {
+        double ratio = static_cast<double>(compressDeflate(lorem, 6, threads)->getLength()) / lorem.size();
+        runner.run("DeflateStream/compress/level-6-threads-" + std::to_string(threads), lorem.size(),
+                   [&]() { compressDeflate(lorem, 6, threads); }, {{"ratio", ratio}});
+    }
+    for (int level : {1, 6, 9}) {
+        auto compressed = compressDeflate(lorem, level);
+        runner.run("DeflateStream/decompress/level-" + std::to_string(level), lorem.size(), [&]() {
+            compressed->seek(0, SeekOrigin::Begin);
+            DeflateStream inflate(compressed, DeflateMode_Decompress, -15, level, true);
+            readChunked(&inflate, buffer);
+        });
+    }
+    // 解压后逐行解析，对比直接读取和在后台线程预读解压数据
+    auto compressed = compressDeflate(lorem, 6);
+    for (bool readAhead : {false, true}) {
+        runner.run(std::string(readAhead ? "ReadAheadStream" : "DeflateStream") + "/decompress-readLine", lorem.size(),
+                   [&]() {
+                       compressed->seek(0, SeekOrigin::Begin);
+                       std::shared_ptr<IStream> stream =
+                           std::make_shared<DeflateStream>(compressed, DeflateMode_Decompress, -15, 6, true);
+                       if (readAhead)
+                           stream = std::make_shared<ReadAheadStream>(stream, 64 * 1024, 2, 8, false);
+                       StreamReader reader(stream, false, "UTF-8", false);
+                       while (reader.Peek() != -1)
+                           reader.ReadLine();
+                   });
+    }
+    // 读取解压数据末尾4KB：没有索引时只能从头解压，有访问点索引时从最近的访问点恢复
+    auto index = std::make_shared<DeflateIndex>(64 * 1024);
+    {
+        compressed->seek(0, SeekOrigin::Begin);
+        DeflateStream inflate(compressed, DeflateMode_Decompress, -15, 6, true);
+        inflate.setIndex(index);
+        readChunked(&inflate, buffer);
+    }
+    long tail = static_cast<long>(lorem.size()) - 4096;
+    for (bool indexed : {false, true}) {
+        runner.run(std::string("DeflateStream/read-tail") + (indexed ? "-indexed" : ""), 4096, [&]() {
+            compressed->seek(0, SeekOrigin::Begin);
+            DeflateStream inflate(compressed, DeflateMode_Decompress, -15, 6, true);
+            if (indexed) {
+                inflate.setIndex(index);
+                inflate.seek(tail, SeekOrigin::Begin);
+            } else {
+                for (long skipped = 0; skipped < tail;)
+                    skipped += inflate.read(buffer.data(), 0, std::min<long>(buffer.size(), tail - skipped));
+            }
+            inflate.read(buffer.data(), 0, 4096);
+        }, {{"points", static_cast<double>(index->getCount())}});
+    }
+    // 大量1KB小消息：每条新建DeflateStream时zng_stream的初始化占主要开销，DeflateUtils复用线程内的流
+    const size_t messageSize = 1024;
+    const size_t messages = std::min<size_t>(256, lorem.size() / messageSize);
+    runner.run("DeflateStream/compress-1k-messages", messages * messageSize, [&]() {
+        for (size_t i = 0; i < messages; i++) {
+            auto output = std::make_shared<MemoryStream>();
+            DeflateStream deflate(output, DeflateMode_Compress, -15, 6, true);
+            writeChunked(&deflate, lorem.data() + i * messageSize, messageSize, messageSize);
+            deflate.close();
+        }
+    });
+    std::vector<byte> output;
+    DeflateUtils::Options options;
+    options.level = 6;
+    runner.run("DeflateUtils/compress-1k-messages", messages * messageSize, [&]() {
+        for (size_t i = 0; i < messages; i++)
+            DeflateUtils::compress(reinterpret_cast<const byte *>(lorem.data()) + i * messageSize, messageSize,
+                                   output, options);
+    });
+    std::vector<std::vector<byte>> packed(messages);
+    for (size_t i = 0; i < messages; i++) {
+        size_t size = DeflateUtils::compress(reinterpret_cast<const byte *>(lorem.data()) + i * messageSize,
+                                             messageSize, output, options);
+        packed[i].assign(output.begin(), output.begin() + size);
+    }
+    options.uncompressSize = messageSize;
+    runner.run("DeflateUtils/decompress-1k-messages", messages * messageSize, [&]() {
+        for (auto &message : packed)
+            DeflateUtils::decompress(message.data(), message.size(), output, options);
+    });
+    std::string incompressible(random.begin(), random.end());
+    runner.run("DeflateStream/compress/random-level-6", incompressible.size(),
+               [&]() { compressDeflate(incompressible, 6); });
+}
+
+static void benchBrotli(BenchRunner &runner, const std::string &lorem) {
+    std::vector<uint8_t> buffer(64 * 1024);
+    // 10、11档非常慢，用较小的输入
+    std::string small = lorem.substr(0, std::max<size_t>(lorem.size() / 8, 1));
+    for (int quality = BROTLI_MIN_QUALITY; quality <= BROTLI_MAX_QUALITY; quality++) {
+        const std::string &input = quality >= 10 ? small : lorem;
+        double ratio = static_cast<double>(compressBrotli(input, quality)->getLength()) / input.size();
+        runner.run("BrotliStream/compress/quality-" + std::to_string(quality), input.size(),
+                   [&]() { compressBrotli(input, quality); }, {{"ratio", ratio}});
+    }
+    for (int quality : {1, 6, 11}) {
+        auto compressed = compressBrotli(lorem, quality);
+        runner.run("BrotliStream/decompress/quality-" + std::to_string(quality), lorem.size(), [&]() {
+            compressed->seek(0, SeekOrigin::Begin);
+            BrotliConfig config;
+            BrotliStream brotli(compressed, BrotliStream::Decompress, config, true, 64 * 1024);
+            readChunked(&brotli, buffer);
+        });
+    }
+}
+
+static const int ZipEntryCount = 64;
+
+static std::shared_ptr<MemoryStream> createArchive(const std::string &lorem, int entryCount = ZipEntryCount) {
+    auto output = std::make_shared<MemoryStream>();
+    ZipArchive archive(output, ZipArchiveMode_Create, "", true);
+    size_t entrySize = lorem.size() / entryCount;
+    for (int i = 0; i < entryCount; i++) {
+        ZipArchiveEntry *entry = archive.createEntry("entry/" + std::to_string(i) + ".txt", CompressionLevel_Optimal);
+        std::shared_ptr<IStream> stream = entry->open();
+        writeChunked(stream.get(), lorem.data() + i * entrySize, entrySize, 64 * 1024);
+        stream->close();
+    }
+    archive.close();
+    return output;
+}
+
+static void benchZip(BenchRunner &runner, const std::string &lorem) {
+    std::vector<uint8_t> buffer(64 * 1024);
+    runner.run("ZipArchive/create", lorem.size(), [&]() { createArchive(lorem); });
+
+    auto archiveData = createArchive(lorem);
+    runner.run("ZipArchive/read", lorem.size(), [&]() {
+        archiveData->seek(0, SeekOrigin::Begin);
+        ZipArchive archive(archiveData, ZipArchiveMode_Read, "", true);
+        for (ZipArchiveEntry *entry : archive.getEntries()) {
+            std::shared_ptr<IStream> stream = entry->open();
+            readChunked(stream.get(), buffer);
+            stream->close();
+        }
+        archive.close();
+    });
+
+    char extractPath[] = "/tmp/jemoc_stream_bench_XXXXXX";
+    int extractFd = mkstemp(extractPath);
+    if (extractFd >= 0)
+        ::close(extractFd);
+    runner.run("ZipArchive/extract-to-file", lorem.size(), [&]() {
+        archiveData->seek(0, SeekOrigin::Begin);
+        ZipArchive archive(archiveData, ZipArchiveMode_Read, "", true);
+        for (ZipArchiveEntry *entry : archive.getEntries())
+            entry->extractToFile(extractPath);
+        archive.close();
+    });
+    unlink(extractPath);
+
+    // 大量小条目：每个条目一个DeflateStream，zng_stream的初始化开销由ZStreamPool复用消除
+    int smallEntries = static_cast<int>(std::min<size_t>(1024, std::max<size_t>(lorem.size() / 256, 1)));
+    runner.run("ZipArchive/create-small-entries", lorem.size(), [&]() { createArchive(lorem, smallEntries); });
+    auto smallArchive = createArchive(lorem, smallEntries);
+    runner.run("ZipArchive/read-small-entries", lorem.size(), [&]() {
+        smallArchive->seek(0, SeekOrigin::Begin);
+        ZipArchive archive(smallArchive, ZipArchiveMode_Read, "", true);
+        for (ZipArchiveEntry *entry : archive.getEntries()) {
+            std::shared_ptr<IStream> stream = entry->open();
+            readChunked(stream.get(), buffer);
+            stream->close();
+        }
+        archive.close();
+    }, {{"entries", static_cast<double>(smallEntries)}});
+
+    std::string extra = lorem.substr(0, lorem.size() / ZipEntryCount);
+    runner.run("ZipArchive/update-add-entry", archiveData->getLength(), [&]() {
+        auto copy = std::make_shared<MemoryStream>();
+        archiveData->seek(0, SeekOrigin::Begin);
+        archiveData->copyTo(copy.get(), 64 * 1024);
+        copy->seek(0, SeekOrigin::Begin);
+        ZipArchive archive(copy, ZipArchiveMode_Update, "", true);
+        ZipArchiveEntry *entry = archive.createEntry("entry/extra.txt", CompressionLevel_Optimal);
+        std::shared_ptr<IStream> stream = entry->open();
+        writeChunked(stream.get(), extra.data(), extra.size(), 64 * 1024);
+        stream->close();
+        archive.close();
+    });
+}
+
+static void benchReaders(BenchRunner &runner, const std::string &lorem, const std::string &xml) {
+    runner.run("XmlReader/parse", xml.size(), [&]() {
+        XmlReader reader(xml);
+        while (reader.Read()) {
+        }
+    });
+    auto xmlStream = std::make_shared<MemoryStream>();
+    writeChunked(xmlStream.get(), xml.data(), xml.size(), 64 * 1024);
+    runner.run("XmlReader/parse-stream", xml.size(), [&]() {
+        xmlStream->seek(0, SeekOrigin::Begin);
+        XmlReader reader(xmlStream, true);
+        while (reader.Read()) {
+        }
+    });
+
+    auto textStream = std::make_shared<MemoryStream>();
+    writeChunked(textStream.get(), lorem.data(), lorem.size(), 64 * 1024);
+    runner.run("StreamReader/readLine", lorem.size(), [&]() {
+        textStream->seek(0, SeekOrigin::Begin);
+        StreamReader reader(textStream, true, "UTF-8", true);
+        while (reader.Peek() != -1)
+            reader.ReadLine();
+    });
+    runner.run("StreamReader/readToEnd", lorem.size(), [&]() {
+        textStream->seek(0, SeekOrigin::Begin);
+        StreamReader reader(textStream, true, "UTF-8", true);
+        reader.ReadToEnd();
+    });
+}
+
+static void printUsage(const char *program) {
+    std::cerr << "usage: " << program << " [--quick] [--min-time seconds] [--corpus-size bytes] [--filter name]"
+              << " [--output file.json]" << std::endl;
+}
+
+int main(int argc, char **argv) {
+    BenchRunner runner;
+    size_t corpusSize = 4 * 1024 * 1024;
+    std::string output;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--quick") {
+            runner.minTime = 0.05;
+            corpusSize = 256 * 1024;
+        } else if (arg == "--min-time" && hasValue) {
+            runner.minTime = std::atof(argv[++i]);
+        } else if (arg == "--corpus-size" && hasValue) {
+            corpusSize = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--filter" && hasValue) {
+            runner.filter = argv[++i];
+        } else if (arg == "--output" && hasValue) {
+            output = argv[++i];
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    std::string lorem = BenchCorpus::loremText(corpusSize);
+    std::vector<uint8_t> random = BenchCorpus::randomBytes(corpusSize);
+    std::string xml = BenchCorpus::xmlDocument(corpusSize);
+    try {
+        benchStreams(runner, lorem);
+        benchDeflate(runner, lorem, random);
+        benchBrotli(runner, lorem);
+        benchZip(runner, lorem);
+        benchReaders(runner, lorem, xml);
+    } catch (const std::exception &e) {
+        std::cerr << "benchmark failed: " << e.what() << std::endl;
+        return 1;
+    }
+
+    if (output.empty()) {
+        runner.writeJson(std::cout, corpusSize);
+    } else {
+        std::ofstream file(output);
+        runner.writeJson(file, corpusSize);
+    }
+    return 0;
+}
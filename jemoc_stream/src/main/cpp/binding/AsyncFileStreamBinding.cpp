@@ -0,0 +1,263 @@
+//
+// Created on 2025/3/9.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#include "binding/StreamBinding.h"
+#include "stream/AsyncFileStream.h"
+
+std::string AsyncFileStream::ClassName = "AsyncFileStream";
+
+/**
+ * 一次异步读写，完成后在js线程上resolve
+ */
+struct FileIoRequest : public AsyncFileIo::Request {
+    napi_deferred deferred = nullptr;
+    // 调用方传入的buffer，内核读写期间保持引用，Promise结束后释放
+    napi_ref bufferRef = nullptr;
+    StreamStats::Clock::time_point submittedAt;
+};
+
+/**
+ * 线程安全函数的参数，通常只带流的弱引用，在js线程上从引擎取出已完成的请求；
+ * 流销毁时引擎把没有取走的请求直接放在requests中带过来
+ */
+struct FileIoCompletion {
+    std::weak_ptr<IStream> stream;
+    std::vector<std::unique_ptr<AsyncFileIo::Request>> requests;
+};
+
+static void settleFileIo(napi_env env, FileIoRequest *request, StreamStats *stats) {
+    napi_value result = nullptr;
+    if (request->error == 0) {
+        if (stats != nullptr && request->submittedAt != StreamStats::Clock::time_point())
+            stats->record(request->write ? StreamStats::Write : StreamStats::Read, request->result,
+                          StreamStats::toMs(StreamStats::Clock::now() - request->submittedAt));
+        napi_create_int64(env, request->result, &result);
+        napi_resolve_deferred(env, request->deferred, result);
+    } else {
+        napi_create_string_utf8(env, strerror(request->error), NAPI_AUTO_LENGTH, &result);
+        napi_reject_deferred(env, request->deferred, result);
+    }
+    if (request->bufferRef != nullptr)
+        napi_delete_reference(env, request->bufferRef);
+}
+
+// 一批请求完成后由线程安全函数调到js线程，一次resolve全部已完成的请求
+static void completeFileIo(napi_env env, napi_value jsCallback, void *context, void *data) {
+    auto *completion = static_cast<FileIoCompletion *>(data);
+    std::shared_ptr<IStream> stream = completion->stream.lock();
+    std::vector<std::unique_ptr<AsyncFileIo::Request>> requests = std::move(completion->requests);
+    delete completion;
+    // 引擎已销毁时Promise和buffer引用随引擎一起释放
+    if (env == nullptr)
+        return;
+    StreamStats *stats = nullptr;
+    if (stream != nullptr) {
+        AsyncFileStream *file = static_cast<AsyncFileStream *>(stream.get());
+        stats = file->getStatsEnabled() ? file->getStats() : nullptr;
+        for (auto &request : file->getIo()->takeCompleted())
+            requests.push_back(std::move(request));
+    }
+    for (auto &request : requests)
+        settleFileIo(env, static_cast<FileIoRequest *>(request.get()), stats);
+}
+
+static bool bindCompletion(napi_env env, std::shared_ptr<IStream> stream) {
+    napi_value name = nullptr;
+    napi_create_string_utf8(env, "fileIo", NAPI_AUTO_LENGTH, &name);
+    napi_threadsafe_function tsfn = nullptr;
+    if (napi_create_threadsafe_function(env, nullptr, nullptr, name, 0, 1, nullptr, nullptr, nullptr, completeFileIo,
+                                        &tsfn) != napi_ok)
+        return false;
+    // 没有进行中的读写时不阻止事件循环退出
+    napi_unref_threadsafe_function(env, tsfn);
+    // 线程安全函数随引擎一起释放
+    std::shared_ptr<napi_threadsafe_function__> function(
+        tsfn, [](napi_threadsafe_function tsfn) { napi_release_threadsafe_function(tsfn, napi_tsfn_release); });
+    std::weak_ptr<IStream> weakStream = stream;
+    AsyncFileIo *io = static_cast<AsyncFileStream *>(stream.get())->getIo();
+    io->setNotify([function, weakStream]() {
+        auto *data = new FileIoCompletion{weakStream, {}};
+        if (napi_call_threadsafe_function(function.get(), data, napi_tsfn_nonblocking) != napi_ok)
+            delete data;
+    });
+    // 流被回收时还没resolve的请求交给js线程处理，否则对应的Promise永远不会结束
+    io->setUncollectedHandler([function](std::vector<std::unique_ptr<AsyncFileIo::Request>> requests) {
+        auto *data = new FileIoCompletion{std::weak_ptr<IStream>(), std::move(requests)};
+        if (napi_call_threadsafe_function(function.get(), data, napi_tsfn_nonblocking) != napi_ok)
+            delete data;
+    });
+    return true;
+}
+
+/**
+ * 构造函数：new AsyncFileStream(path | fd, mode?, {depth?: number, bufferSize?: number})
+ */
+napi_value AsyncFileStream::JSConstructor(napi_env env, napi_callback_info info) {
+    GET_JS_INFO_WITHOUT_STREAM(3)
+    int depth = DefaultDepth;
+    long bufferSize = 8192;
+    napi_valuetype type;
+    NAPI_CALL(env, napi_typeof(env, argv[2], &type))
+    if (type == napi_object) {
+        napi_value val;
+        NAPI_CALL(env, napi_get_named_property(env, argv[2], "depth", &val))
+        NAPI_CALL(env, napi_typeof(env, val, &type))
+        if (type == napi_number)
+            depth = getInt(env, val);
+        NAPI_CALL(env, napi_get_named_property(env, argv[2], "bufferSize", &val))
+        NAPI_CALL(env, napi_typeof(env, val, &type))
+        if (type == napi_number)
+            bufferSize = getLong(env, val);
+    }
+    if (depth <= 0 || bufferSize < 0) {
+        napi_throw_range_error(env, ClassName.c_str(), "depth must be larger than zero and bufferSize non-negative");
+        return nullptr;
+    }
+
+    NAPI_CALL(env, napi_typeof(env, argv[1], &type))
+    int mode = type == napi_number ? getInt(env, argv[1]) : FILE_MODE_READ;
+    NAPI_CALL(env, napi_typeof(env, argv[0], &type))
+    std::shared_ptr<IStream> stream;
+    try {
+        if (type == napi_string)
+            stream = std::make_shared<AsyncFileStream>(getString(env, argv[0]), FILE_MODE(mode), bufferSize, depth);
+        else if (type == napi_number)
+            stream = std::make_shared<AsyncFileStream>(getInt(env, argv[0]), FILE_MODE(mode), bufferSize, depth);
+        else {
+            napi_throw_type_error(env, ClassName.c_str(), "path or fd is required");
+            return nullptr;
+        }
+    } catch (const std::exception &e) {
+        napi_throw_error(env, ClassName.c_str(), e.what());
+        return nullptr;
+    }
+    if (!bindCompletion(env, stream)) {
+        napi_throw_error(env, ClassName.c_str(), "create completion callback failed");
+        return nullptr;
+    }
+    return JSBind(env, _this, stream);
+}
+
+static napi_value submitIo(napi_env env, napi_callback_info info, bool write) {
+    std::string ClassName = AsyncFileStream::ClassName;
+    GET_JS_INFO(3)
+    if (stream == nullptr || stream->isClose())
+        return nullptr;
+    void *data = nullptr;
+    size_t length = 0;
+    getBuffer(env, argv[0], &data, &length);
+    if (data == nullptr) {
+        napi_throw_type_error(env, ClassName.c_str(), "buffer is null");
+        return nullptr;
+    }
+    long offset = getOffset(env, argv[1], length);
+    long count = getCount(env, argv[2], length, offset);
+
+    AsyncFileStream *file = static_cast<AsyncFileStream *>(stream.get());
+    auto request = std::make_unique<FileIoRequest>();
+    request->buffer = static_cast<byte *>(data) + offset;
+    request->length = count;
+    request->bufferIndex = file->getIo()->findRegisteredBuffer(request->buffer, count);
+    if (stream->getStatsEnabled())
+        request->submittedAt = StreamStats::Clock::now();
+    napi_value promise = nullptr;
+    NAPI_CALL(env, napi_create_promise(env, &request->deferred, &promise))
+    NAPI_CALL(env, napi_create_reference(env, argv[0], 1, &request->bufferRef))
+    napi_deferred deferred = request->deferred;
+    napi_ref bufferRef = request->bufferRef;
+    napi_value result = nullptr;
+    try {
+        if (write) {
+            file->submitWrite(std::move(request));
+            return promise;
+        } else if (file->submitRead(std::move(request))) {
+            return promise;
+        }
+        // 已到末尾，不进入引擎
+        napi_create_int64(env, 0, &result);
+        napi_resolve_deferred(env, deferred, result);
+    } catch (const std::exception &e) {
+        napi_create_string_utf8(env, e.what(), NAPI_AUTO_LENGTH, &result);
+        napi_reject_deferred(env, deferred, result);
+    }
+    napi_delete_reference(env, bufferRef);
+    return promise;
+}
+
+napi_value AsyncFileStream::JSReadAsync(napi_env env, napi_callback_info info) { return submitIo(env, info, false); }
+
+napi_value AsyncFileStream::JSWriteAsync(napi_env env, napi_callback_info info) { return submitIo(env, info, true); }
+
+/**
+ * registerBuffers(buffers: ArrayBuffer[]): boolean，注册的buffer由js对象持有，直到下一次注册
+ */
+napi_value AsyncFileStream::JSRegisterBuffers(napi_env env, napi_callback_info info) {
+    GET_JS_INFO(1)
+    if (stream == nullptr || stream->isClose())
+        return nullptr;
+    bool isArray = false;
+    NAPI_CALL(env, napi_is_array(env, argv[0], &isArray))
+    if (!isArray) {
+        napi_throw_type_error(env, ClassName.c_str(), "buffers must be an array");
+        return nullptr;
+    }
+    uint32_t count = 0;
+    NAPI_CALL(env, napi_get_array_length(env, argv[0], &count))
+    std::vector<struct iovec> buffers;
+    for (uint32_t i = 0; i < count; i++) {
+        napi_value element = nullptr;
+        NAPI_CALL(env, napi_get_element(env, argv[0], i, &element))
+        void *data = nullptr;
+        size_t length = 0;
+        getBuffer(env, element, &data, &length);
+        if (data == nullptr || length == 0) {
+            napi_throw_type_error(env, ClassName.c_str(), "buffer is null");
+            return nullptr;
+        }
+        buffers.push_back({data, length});
+    }
+    bool registered = static_cast<AsyncFileStream *>(stream.get())->getIo()->registerBuffers(buffers);
+    if (registered) {
+        napi_property_descriptor desc = {"_registeredBuffers", nullptr, nullptr, nullptr, nullptr, argv[0],
+                                         static_cast<napi_property_attributes>(napi_writable | napi_configurable),
+                                         nullptr};
+        NAPI_CALL(env, napi_define_properties(env, _this, 1, &desc))
+    }
+    RETURN_NAPI_VALUE(napi_get_boolean, registered)
+}
+
+napi_value AsyncFileStream::JSGetDepth(napi_env env, napi_callback_info info) {
+    GET_JS_INFO(0)
+    if (stream == nullptr)
+        return nullptr;
+    RETURN_NAPI_VALUE(napi_create_int32, static_cast<AsyncFileStream *>(stream.get())->getIo()->getDepth())
+}
+
+napi_value AsyncFileStream::JSGetEngine(napi_env env, napi_callback_info info) {
+    GET_JS_INFO_WITHOUT_CHECK(0)
+    if (stream == nullptr)
+        return nullptr;
+    napi_value result = nullptr;
+    NAPI_CALL(env, napi_create_string_utf8(env, static_cast<AsyncFileStream *>(stream.get())->getIo()->getEngine(),
+                                           NAPI_AUTO_LENGTH, &result))
+    return result;
+}
+
+void AsyncFileStream::Export(napi_env env, napi_value exports) {
+    napi_property_descriptor desc[] = {
+        DEFINE_NAPI_FUNCTION("readAsync", JSReadAsync, nullptr, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("writeAsync", JSWriteAsync, nullptr, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("registerBuffers", JSRegisterBuffers, nullptr, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("preallocate", JSPreallocate, nullptr, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("depth", nullptr, JSGetDepth, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("engine", nullptr, JSGetEngine, nullptr, nullptr),
+    };
+    napi_value napi_cons = nullptr;
+    NAPI_CALL(env, napi_define_class(env, ClassName.c_str(), NAPI_AUTO_LENGTH, JSConstructor, nullptr,
+                                     sizeof(desc) / sizeof(desc[0]), desc, &napi_cons))
+    Extends(env, napi_cons);
+    NAPI_CALL(env, napi_set_named_property(env, exports, ClassName.c_str(), napi_cons))
+}
@@ -0,0 +1,83 @@
+//
+// Created on 2025/2/18.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#include "binding/BrotliBinding.h"
+
+std::string BrotliStream::ClassName = "BrotliStream";
+
+void BrotliStream::Export(napi_env env, napi_value exports) {
+    napi_value cons;
+    NAPI_CALL(env,
+              napi_define_class(env, ClassName.c_str(), NAPI_AUTO_LENGTH, JSConstructor, nullptr, 0, nullptr, &cons))
+    Extends(env, cons);
+    NAPI_CALL(env, napi_set_named_property(env, exports, ClassName.c_str(), cons))
+}
+
+napi_value BrotliStream::JSConstructor(napi_env env, napi_callback_info info) {
+    napi_value _this;
+    size_t argc = 3;
+    napi_value argv[3]{nullptr};
+    NAPI_CALL(env, napi_get_cb_info(env, info, &argc, argv, &_this, nullptr))
+    std::shared_ptr<IStream> stream = IStream::GetStream(env, argv[0]);
+    if (!stream) {
+        napi_throw_type_error(env, "BrotliStream", "invalid stream");
+        return nullptr;
+    }
+    int mode = getInt(env, argv[1]);
+    int quality = BROTLI_DEFAULT_QUALITY;
+    int lgWin = BROTLI_DEFAULT_WINDOW;
+    int b_mode = BROTLI_DEFAULT_MODE;
+    bool leaveOpen = false;
+    size_t bufferSize = 1024 * 8;
+    if (argc == 3) {
+        napi_value val;
+        napi_valuetype type;
+        NAPI_CALL(env, napi_get_named_property(env, argv[2], "quality", &val))
+        NAPI_CALL(env, napi_typeof(env, val, &type))
+        if (type == napi_number) {
+            quality = getInt(env, val);
+        }
+        NAPI_CALL(env, napi_get_named_property(env, argv[2], "lgWin", &val))
+        NAPI_CALL(env, napi_typeof(env, val, &type))
+        if (type == napi_number) {
+            lgWin = getInt(env, val);
+        }
+        NAPI_CALL(env, napi_get_named_property(env, argv[2], "mode", &val))
+        NAPI_CALL(env, napi_typeof(env, val, &type))
+        if (type == napi_number) {
+            b_mode = getInt(env, val);
+        }
+        NAPI_CALL(env, napi_get_named_property(env, argv[2], "leaveOpen", &val))
+        NAPI_CALL(env, napi_typeof(env, val, &type))
+        if (type == napi_boolean) {
+            NAPI_CALL(env, napi_get_value_bool(env, val, &leaveOpen))
+        }
+        NAPI_CALL(env, napi_get_named_property(env, argv[2], "bufferSize", &val))
+        NAPI_CALL(env, napi_typeof(env, val, &type))
+        if (type == napi_number) {
+            bufferSize = getInt(env, val);
+        }
+    }
+    BrotliConfig config{.quality = quality, .lgWin = lgWin, .mode = b_mode};
+    std::shared_ptr<IStream> bs =
+        std::make_shared<BrotliStream>(stream, BrotliStream::CompressionMode(mode), config, leaveOpen, bufferSize);
+
+
+    return JSBind(env, _this, bs);
+}
+
+// void BrotliStream::JSDispose(napi_env env, void *data, void *hint) {
+//     BrotliStream *bs = static_cast<BrotliStream *>(data);
+//     bs->close();
+//     if (!bs->m_leaveOpen) {
+//         napi_value result;
+//         void *stream = nullptr;
+//         ((IStream *)stream)->close();
+//         NAPI_CALL(env, napi_get_reference_value(env, bs->stream_ref, &result))
+//         NAPI_CALL(env, napi_remove_wrap(env, result, &stream))
+//     }
+//     delete bs;
+// }
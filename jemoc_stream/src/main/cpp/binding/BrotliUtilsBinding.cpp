@@ -4,7 +4,7 @@
 // Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
 // please include "napi/native_api.h".
 
-#include "stream/BrotliStream.h"
+#include "binding/BrotliBinding.h"
 #include <cstdint>
 #include <memory>
 
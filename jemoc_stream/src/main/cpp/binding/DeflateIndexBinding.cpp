@@ -0,0 +1,145 @@
+//
+// Created on 2025/3/11.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#include "binding/StreamBinding.h"
+#include "deflate/DeflateIndex.h"
+
+std::string DeflateIndex::ClassName = "DeflateIndex";
+napi_ref DeflateIndex::cons = nullptr;
+
+#define GET_DEFLATE_INDEX_INFO(number)                                                                                 \
+    size_t argc = number;                                                                                              \
+    napi_value argv[number];                                                                                           \
+    napi_value _this = nullptr;                                                                                        \
+    NAPI_CALL(env, napi_get_cb_info(env, info, &argc, argv, &_this, nullptr))                                          \
+    std::shared_ptr<DeflateIndex> index = GetIndex(env, _this);                                                        \
+    if (index == nullptr) {                                                                                            \
+        napi_throw_error(env, ClassName.c_str(), "index is null");                                                     \
+        return nullptr;                                                                                                \
+    }
+
+std::shared_ptr<DeflateIndex> DeflateIndex::GetIndex(napi_env env, napi_value value) {
+    napi_valuetype type;
+    if (napi_typeof(env, value, &type) != napi_ok || type != napi_object)
+        return nullptr;
+    napi_value constructor = nullptr;
+    bool isIndex = false;
+    if (napi_get_reference_value(env, cons, &constructor) != napi_ok ||
+        napi_instanceof(env, value, constructor, &isIndex) != napi_ok || !isIndex)
+        return nullptr;
+    void *data = nullptr;
+    napi_unwrap(env, value, &data);
+    return data == nullptr ? nullptr : *static_cast<std::shared_ptr<DeflateIndex> *>(data);
+}
+
+/**
+ * 构造函数：new DeflateIndex(span?: number)
+ */
+napi_value DeflateIndex::JSConstructor(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
+    napi_value _this = nullptr;
+    NAPI_CALL(env, napi_get_cb_info(env, info, &argc, argv, &_this, nullptr))
+    int64_t span = DefaultSpan;
+    napi_valuetype type;
+    NAPI_CALL(env, napi_typeof(env, argv[0], &type))
+    if (type == napi_number)
+        NAPI_CALL(env, napi_get_value_int64(env, argv[0], &span))
+    if (span <= 0) {
+        napi_throw_range_error(env, ClassName.c_str(), "span must be larger than zero");
+        return nullptr;
+    }
+    auto *index = new std::shared_ptr<DeflateIndex>(std::make_shared<DeflateIndex>(span));
+    NAPI_CALL(env, napi_wrap(env, _this, index, JSDispose, nullptr, nullptr))
+    return _this;
+}
+
+void DeflateIndex::JSDispose(napi_env env, void *data, void *hint) {
+    delete static_cast<std::shared_ptr<DeflateIndex> *>(data);
+}
+
+napi_value DeflateIndex::JSGetSpan(napi_env env, napi_callback_info info) {
+    GET_DEFLATE_INDEX_INFO(0)
+    RETURN_NAPI_VALUE(napi_create_int64, static_cast<int64_t>(index->getSpan()))
+}
+
+napi_value DeflateIndex::JSGetCount(napi_env env, napi_callback_info info) {
+    GET_DEFLATE_INDEX_INFO(0)
+    RETURN_NAPI_VALUE(napi_create_int64, static_cast<int64_t>(index->getCount()))
+}
+
+napi_value DeflateIndex::JSGetComplete(napi_env env, napi_callback_info info) {
+    GET_DEFLATE_INDEX_INFO(0)
+    RETURN_BOOL(index->isComplete())
+}
+
+napi_value DeflateIndex::JSGetLength(napi_env env, napi_callback_info info) {
+    GET_DEFLATE_INDEX_INFO(0)
+    RETURN_NAPI_VALUE(napi_create_int64, index->getLength())
+}
+
+/**
+ * writeTo(stream: IStream): void，写入旁路文件或内存流
+ */
+napi_value DeflateIndex::JSWriteTo(napi_env env, napi_callback_info info) {
+    GET_DEFLATE_INDEX_INFO(1)
+    std::shared_ptr<IStream> stream = IStream::GetStream(env, argv[0]);
+    if (stream == nullptr || stream->isClose() || !stream->getCanWrite()) {
+        napi_throw_type_error(env, ClassName.c_str(), "stream is not writable");
+        return nullptr;
+    }
+    try {
+        index->writeTo(stream.get());
+    } catch (const std::exception &e) {
+        napi_throw_error(env, ClassName.c_str(), e.what());
+    }
+    return nullptr;
+}
+
+/**
+ * DeflateIndex.readFrom(stream: IStream): DeflateIndex，从流的当前位置读取writeTo写出的索引
+ */
+napi_value DeflateIndex::JSReadFrom(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
+    NAPI_CALL(env, napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr))
+    std::shared_ptr<IStream> stream = IStream::GetStream(env, argv[0]);
+    if (stream == nullptr || stream->isClose() || !stream->getCanRead()) {
+        napi_throw_type_error(env, ClassName.c_str(), "stream is not readable");
+        return nullptr;
+    }
+    std::shared_ptr<DeflateIndex> loaded;
+    try {
+        loaded = ReadFrom(stream.get());
+    } catch (const std::exception &e) {
+        napi_throw_error(env, ClassName.c_str(), e.what());
+        return nullptr;
+    }
+    napi_value constructor = nullptr;
+    napi_value result = nullptr;
+    NAPI_CALL(env, napi_get_reference_value(env, cons, &constructor))
+    NAPI_CALL(env, napi_new_instance(env, constructor, 0, nullptr, &result))
+    void *data = nullptr;
+    NAPI_CALL(env, napi_unwrap(env, result, &data))
+    *static_cast<std::shared_ptr<DeflateIndex> *>(data) = loaded;
+    return result;
+}
+
+void DeflateIndex::Export(napi_env env, napi_value exports) {
+    napi_property_descriptor desc[] = {
+        DEFINE_NAPI_FUNCTION("span", nullptr, JSGetSpan, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("count", nullptr, JSGetCount, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("complete", nullptr, JSGetComplete, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("length", nullptr, JSGetLength, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("writeTo", JSWriteTo, nullptr, nullptr, nullptr),
+        {"readFrom", nullptr, JSReadFrom, nullptr, nullptr, nullptr, napi_static, nullptr},
+    };
+    napi_value napi_cons = nullptr;
+    NAPI_CALL(env, napi_define_class(env, ClassName.c_str(), NAPI_AUTO_LENGTH, JSConstructor, nullptr,
+                                     sizeof(desc) / sizeof(desc[0]), desc, &napi_cons))
+    NAPI_CALL(env, napi_create_reference(env, napi_cons, 1, &cons))
+    NAPI_CALL(env, napi_set_named_property(env, exports, ClassName.c_str(), napi_cons))
+}
@@ -0,0 +1,120 @@
+//
+// Created on 2025/1/9.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#include "binding/StreamBinding.h"
+#include "deflate/ParallelDeflater.h"
+#include "stream/DeflateStream.h"
+
+napi_ref DeflateStream::cons = nullptr;
+std::string DeflateStream::ClassName = "DeflateStream";
+
+void DeflateStream::close(napi_env env) {
+    close();
+    napi_value retrieved_obj;
+    napi_status status = napi_get_reference_value(env, stream_weak_ref, &retrieved_obj);
+
+    //释放对象
+    if (status == napi_ok && !m_leaveOpen) {
+        void *result = nullptr;
+        napi_remove_wrap(env, retrieved_obj, &result);
+    }
+    napi_delete_reference(env, stream_weak_ref);
+    stream_weak_ref = nullptr;
+}
+
+napi_value DeflateStream::JSConstructor(napi_env env, napi_callback_info info) {
+    GET_JS_INFO_WITHOUT_STREAM(3)
+    std::shared_ptr<IStream> stream = GetStream(env, argv[0]);
+    if (!stream) {
+        napi_throw_error(env, "DeflateStream", "argument stream is null");
+        return nullptr;
+    }
+
+
+    int mode = getInt(env, argv[1]);
+    bool leaveOpen = false;
+    int windowBits = -15;
+    int compressionLevel = Z_DEFAULT_COMPRESSION;
+    long bufferSize = DEFAULT_BUFFER_SIZE;
+    long uncompressSize = -1;
+    int threads = 1;
+    int64_t blockSize = 0;
+
+    napi_value value = nullptr;
+    napi_valuetype type;
+    GET_OBJ(argv[2], "leaveOpen", napi_get_value_bool, leaveOpen)
+    GET_OBJ(argv[2], "windowBits", napi_get_value_int32, windowBits)
+    GET_OBJ(argv[2], "uncompressSize", napi_get_value_int64, uncompressSize)
+    GET_OBJ(argv[2], "bufferSize", napi_get_value_int64, bufferSize)
+    GET_OBJ(argv[2], "compressionLevel", napi_get_value_int32, compressionLevel)
+    GET_OBJ(argv[2], "threads", napi_get_value_int32, threads)
+    GET_OBJ(argv[2], "blockSize", napi_get_value_int64, blockSize)
+    std::shared_ptr<DeflateIndex> index;
+    napi_get_named_property(env, argv[2], "index", &value);
+    napi_typeof(env, value, &type);
+    if (type != napi_undefined) {
+        index = DeflateIndex::GetIndex(env, value);
+        if (index == nullptr) {
+            napi_throw_type_error(env, ClassName.c_str(), "index must be a DeflateIndex");
+            return nullptr;
+        }
+    }
+
+    std::shared_ptr<IStream> ds;
+
+    if (windowBits < Min_WINDOW_BITS || windowBits > Max_WINDOW_BITS) {
+        napi_throw_error(env, "DeflateStream", "windowBits must be greater than -15 and less than 31.");
+        return nullptr;
+    }
+    if (mode == DeflateMode_Decompress && uncompressSize < -1) {
+        napi_throw_range_error(env, "DeflateStream", "uncompressSize must greater than -1 in decompress mode");
+        return nullptr;
+    }
+
+    if (bufferSize < 1) {
+        napi_throw_range_error(env, ClassName.c_str(), "bufferSize must greater than 1");
+        return nullptr;
+    }
+    if (threads > ParallelDeflater::MaxThreads) {
+        napi_throw_range_error(env, ClassName.c_str(), "threads must not be greater than 64");
+        return nullptr;
+    }
+    if (blockSize < 0 || blockSize > static_cast<int64_t>(ParallelDeflater::MaxBlockSize)) {
+        napi_throw_range_error(env, ClassName.c_str(), "blockSize must be between 0 and 64MB");
+        return nullptr;
+    }
+
+    try {
+        ds = std::make_shared<DeflateStream>(stream, DeflateMode(mode), windowBits, compressionLevel, leaveOpen,
+                                             bufferSize, uncompressSize, threads, blockSize);
+        if (index != nullptr)
+            static_cast<DeflateStream *>(ds.get())->setIndex(index);
+
+    } catch (const std::exception &e) {
+        napi_throw_error(env, ClassName.c_str(), e.what());
+        return nullptr;
+    }
+
+    NAPI_CALL(env, napi_create_reference(env, argv[0], 0, &((DeflateStream *)ds.get())->stream_weak_ref));
+
+    return JSBind(env, _this, ds);
+}
+
+// void DeflateStream::JSDispose(napi_env env, void *data, void *hint) {
+////    DeflateStream *stream = static_cast<DeflateStream *>(data);
+////    delete stream;
+////    stream = nullptr;
+//    SharedPtrWrapper *wrapper = static_cast<SharedPtrWrapper *>(data);
+//    delete wrapper;
+//}
+
+void DeflateStream::Export(napi_env env, napi_value exports) {
+
+    napi_value napi_cons = nullptr;
+    napi_define_class(env, ClassName.c_str(), NAPI_AUTO_LENGTH, JSConstructor, nullptr, 0, nullptr, &napi_cons);
+    Extends(env, napi_cons);
+    napi_set_named_property(env, exports, ClassName.c_str(), napi_cons);
+}
@@ -0,0 +1,191 @@
+//
+// Created on 2025/3/12.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#include "binding/NapiHelper.h"
+#include "deflate/DeflateUtils.h"
+#include <string>
+
+static const char *TagName = "DeflateUtils";
+// 同步调用复用的输出缓冲区超过此大小时用完即释放
+static constexpr size_t MaxRetainedOutput = 1024 * 1024;
+
+/**
+ * 一次异步压缩/解压，输入为字符串时拷贝保存，为buffer时持有引用直到完成
+ */
+struct DeflateUtilsAsyncData {
+    napi_async_work work = nullptr;
+    napi_deferred deferred = nullptr;
+    napi_ref input = nullptr;
+    std::string text;
+    const byte *data = nullptr;
+    size_t length = 0;
+    bool compress = true;
+    DeflateUtils::Options options;
+    std::vector<byte> output;
+    size_t size = 0;
+    std::string error;
+};
+
+// 读取字符串或buffer输入，isString返回输入是否为字符串，字符串内容拷贝到text中
+static bool getInput(napi_env env, napi_value value, std::string &text, const byte **data, size_t *length,
+                     bool *isString) {
+    napi_valuetype type;
+    NAPI_CALL(env, napi_typeof(env, value, &type))
+    *isString = type == napi_string;
+    if (*isString) {
+        text = getString(env, value);
+        *data = reinterpret_cast<const byte *>(text.data());
+        *length = text.size();
+        return true;
+    }
+    void *buffer = nullptr;
+    getBuffer(env, value, &buffer, length);
+    *data = static_cast<const byte *>(buffer);
+    if (buffer == nullptr && *length == 0) {
+        bool isBuffer = false;
+        napi_is_arraybuffer(env, value, &isBuffer);
+        if (!isBuffer)
+            napi_is_typedarray(env, value, &isBuffer);
+        return isBuffer;
+    }
+    return true;
+}
+
+static void getOptions(napi_env env, napi_value options, DeflateUtils::Options &result) {
+    napi_valuetype type;
+    NAPI_CALL(env, napi_typeof(env, options, &type))
+    if (type != napi_object)
+        return;
+    napi_value value = nullptr;
+    int64_t uncompressSize = result.uncompressSize;
+    GET_OBJ(options, "level", napi_get_value_int32, result.level)
+    GET_OBJ(options, "windowBits", napi_get_value_int32, result.windowBits)
+    GET_OBJ(options, "strategy", napi_get_value_int32, result.strategy)
+    GET_OBJ(options, "uncompressSize", napi_get_value_int64, uncompressSize)
+    result.uncompressSize = uncompressSize;
+}
+
+static napi_value run(napi_env env, napi_callback_info info, bool compress) {
+    napi_value argv[2]{nullptr};
+    size_t argc = 2;
+    NAPI_CALL(env, napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr))
+    std::string text;
+    const byte *data = nullptr;
+    size_t length = 0;
+    bool isString = false;
+    if (argc < 1 || !getInput(env, argv[0], text, &data, &length, &isString)) {
+        napi_throw_type_error(env, TagName, "invalid argument");
+        return nullptr;
+    }
+    DeflateUtils::Options options;
+    if (argc > 1)
+        getOptions(env, argv[1], options);
+
+    thread_local std::vector<byte> output;
+    napi_value result = nullptr;
+    try {
+        size_t size = compress ? DeflateUtils::compress(data, length, output, options)
+                               : DeflateUtils::decompress(data, length, output, options);
+        void *resultData = nullptr;
+        NAPI_CALL(env, napi_create_arraybuffer(env, size, &resultData, &result))
+        if (size > 0)
+            memcpy(resultData, output.data(), size);
+    } catch (const std::exception &e) {
+        napi_throw_error(env, TagName, e.what());
+    }
+    if (output.capacity() > MaxRetainedOutput)
+        std::vector<byte>().swap(output);
+    return result;
+}
+
+static napi_value runAsync(napi_env env, napi_callback_info info, bool compress) {
+    napi_value argv[2]{nullptr};
+    size_t argc = 2;
+    NAPI_CALL(env, napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr))
+    auto *data = new DeflateUtilsAsyncData();
+    data->compress = compress;
+    bool isString = false;
+    if (argc < 1 || !getInput(env, argv[0], data->text, &data->data, &data->length, &isString)) {
+        delete data;
+        napi_throw_type_error(env, TagName, "invalid argument");
+        return nullptr;
+    }
+    // 字符串已拷贝到text中，只有buffer需要保持引用
+    if (!isString)
+        NAPI_CALL(env, napi_create_reference(env, argv[0], 1, &data->input))
+    if (argc > 1)
+        getOptions(env, argv[1], data->options);
+
+    napi_value resourceName = nullptr;
+    napi_value promise = nullptr;
+    NAPI_CALL(env, napi_create_string_utf8(env, compress ? "compressAsync" : "decompressAsync", NAPI_AUTO_LENGTH,
+                                           &resourceName))
+    NAPI_CALL(env, napi_create_promise(env, &data->deferred, &promise))
+    NAPI_CALL(env, napi_create_async_work(
+                       env, nullptr, resourceName,
+                       [](napi_env env, void *data) {
+                           auto *asyncData = static_cast<DeflateUtilsAsyncData *>(data);
+                           try {
+                               asyncData->size =
+                                   asyncData->compress
+                                       ? DeflateUtils::compress(asyncData->data, asyncData->length, asyncData->output,
+                                                                asyncData->options)
+                                       : DeflateUtils::decompress(asyncData->data, asyncData->length,
+                                                                  asyncData->output, asyncData->options);
+                           } catch (const std::exception &e) {
+                               asyncData->error = e.what();
+                           }
+                       },
+                       [](napi_env env, napi_status status, void *data) {
+                           auto *asyncData = static_cast<DeflateUtilsAsyncData *>(data);
+                           napi_value result = nullptr;
+                           if (status != napi_ok || !asyncData->error.empty()) {
+                               napi_create_string_utf8(env,
+                                                       asyncData->error.empty() ? "async work failed"
+                                                                                : asyncData->error.c_str(),
+                                                       NAPI_AUTO_LENGTH, &result);
+                               napi_reject_deferred(env, asyncData->deferred, result);
+                           } else {
+                               void *resultData = nullptr;
+                               napi_create_arraybuffer(env, asyncData->size, &resultData, &result);
+                               if (asyncData->size > 0)
+                                   memcpy(resultData, asyncData->output.data(), asyncData->size);
+                               napi_resolve_deferred(env, asyncData->deferred, result);
+                           }
+                           if (asyncData->input != nullptr)
+                               napi_delete_reference(env, asyncData->input);
+                           napi_delete_async_work(env, asyncData->work);
+                           delete asyncData;
+                       },
+                       data, &data->work))
+    NAPI_CALL(env, napi_queue_async_work(env, data->work))
+    return promise;
+}
+
+napi_value DeflateUtils::JSCompress(napi_env env, napi_callback_info info) { return run(env, info, true); }
+
+napi_value DeflateUtils::JSDecompress(napi_env env, napi_callback_info info) { return run(env, info, false); }
+
+napi_value DeflateUtils::JSCompressAsync(napi_env env, napi_callback_info info) { return runAsync(env, info, true); }
+
+napi_value DeflateUtils::JSDecompressAsync(napi_env env, napi_callback_info info) {
+    return runAsync(env, info, false);
+}
+
+void DeflateUtils::Export(napi_env env, napi_value exports) {
+    napi_property_descriptor desc[] = {
+        {"compress", nullptr, JSCompress, nullptr, nullptr, nullptr, napi_static, nullptr},
+        {"decompress", nullptr, JSDecompress, nullptr, nullptr, nullptr, napi_static, nullptr},
+        {"compressAsync", nullptr, JSCompressAsync, nullptr, nullptr, nullptr, napi_static, nullptr},
+        {"decompressAsync", nullptr, JSDecompressAsync, nullptr, nullptr, nullptr, napi_static, nullptr},
+    };
+    napi_value cons;
+    NAPI_CALL(env, napi_define_class(
+                       env, TagName, NAPI_AUTO_LENGTH,
+                       [](napi_env env, napi_callback_info info) -> napi_value { return nullptr; }, nullptr,
+                       sizeof(desc) / sizeof(desc[0]), desc, &cons))
+    NAPI_CALL(env, napi_set_named_property(env, exports, TagName, cons))
+}
@@ -0,0 +1,161 @@
+//
+// Created on 2025/1/9.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#include "binding/NapiHelper.h"
+#include "deflate/Deflater.h"
+
+#define GET_DEFLATER_INFO(number)                                                                                      \
+    size_t argc = number;                                                                                              \
+    napi_value argv[number];                                                                                           \
+    napi_value _this = nullptr;                                                                                        \
+    napi_get_cb_info(env, info, &argc, argv, &_this, nullptr);
+
+#define GET_DEFLATER_INFO_WITH_DEFLATER(number)                                                                        \
+    GET_DEFLATER_INFO(number)                                                                                          \
+    void *p = nullptr;                                                                                                 \
+    napi_unwrap(env, _this, &p);                                                                                       \
+    if (p == nullptr)                                                                                                  \
+        napi_throw_error(env, "Deflater", "deflater is disposed");                                                     \
+    Deflater *deflater = static_cast<Deflater *>(p);
+
+napi_value Deflater::JSConstructor(napi_env env, napi_callback_info info) {
+    GET_DEFLATER_INFO(3)
+    int windowBits = -15;
+    int level = Z_DEFAULT_COMPRESSION;
+    int strategy = Z_DEFAULT_STRATEGY;
+    napi_valuetype type;
+    NAPI_CALL(env, napi_typeof(env, argv[0], &type))
+    if (type == napi_number) {
+        NAPI_CALL(env, napi_get_value_int32(env, argv[0], &windowBits))
+    }
+    NAPI_CALL(env, napi_typeof(env, argv[1], &type))
+    if (type == napi_number) {
+        NAPI_CALL(env, napi_get_value_int32(env, argv[1], &level))
+    }
+    NAPI_CALL(env, napi_typeof(env, argv[2], &type))
+    if (type == napi_number) {
+        NAPI_CALL(env, napi_get_value_int32(env, argv[1], &strategy))
+    }
+    try {
+        Deflater *deflater = new Deflater(windowBits, level, strategy);
+        NAPI_CALL(env, napi_wrap(env, _this, deflater, JSDispose, nullptr, nullptr))
+        return _this;
+    } catch (const std::exception &e) {
+        return nullptr;
+    }
+}
+
+void Deflater::JSDispose(napi_env env, void *data, void *hint) {
+    Deflater *deflater = static_cast<Deflater *>(data);
+    delete deflater;
+    deflater = nullptr;
+}
+
+napi_value Deflater::JSSetInput(napi_env env, napi_callback_info info) {
+    GET_DEFLATER_INFO_WITH_DEFLATER(3)
+    void *buffer = nullptr;
+    size_t length = 0;
+    getBuffer(env, argv[0], &buffer, &length);
+    long offset = getOffset(env, argv[1], length);
+    size_t count = getCount(env, argv[2], length, offset);
+    deflater->setInput(offset_pointer(buffer, offset), count);
+    return nullptr;
+}
+
+napi_value Deflater::JSNeedInput(napi_env env, napi_callback_info info) {
+    GET_DEFLATER_INFO_WITH_DEFLATER(0)
+    napi_value result = nullptr;
+    napi_get_boolean(env, deflater->needInput(), &result);
+    return result;
+}
+
+napi_value Deflater::JSDispose(napi_env env, napi_callback_info info) {
+    GET_DEFLATER_INFO(0)
+    void *result = nullptr;
+    NAPI_CALL(env, napi_remove_wrap(env, _this, &result))
+    return nullptr;
+}
+
+napi_value Deflater::JSIsDisposed(napi_env env, napi_callback_info info) {
+    GET_DEFLATER_INFO(0)
+    void *deflater = nullptr;
+    NAPI_CALL(env, napi_unwrap(env, _this, &deflater))
+    bool value = deflater == nullptr;
+    napi_value result = nullptr;
+    napi_get_boolean(env, value, &result);
+    return result;
+}
+
+napi_value Deflater::JSFlush(napi_env env, napi_callback_info info) {
+    GET_DEFLATER_INFO_WITH_DEFLATER(4)
+    void *buffer = nullptr;
+    size_t length = 0;
+    getBuffer(env, argv[0], &buffer, &length);
+    long offset = getOffset(env, argv[1], length);
+    size_t count = getCount(env, argv[2], length, offset);
+    size_t bytesRead = 0;
+    bool success = deflater->flush(offset_pointer(buffer, offset), count, &bytesRead);
+    napi_value values[2]{nullptr};
+    NAPI_CALL(env, napi_get_boolean(env, success, &values[0]))
+    NAPI_CALL(env, napi_create_int64(env, bytesRead, &values[1]))
+    napi_property_descriptor desc[] = {
+        {"result", nullptr, nullptr, nullptr, nullptr, argv[0], napi_default, nullptr},
+        {"readBytes", nullptr, nullptr, nullptr, nullptr, argv[1], napi_default, nullptr},
+    };
+    napi_value result = nullptr;
+    NAPI_CALL(env, napi_create_object_with_properties(env, &result, 2, desc))
+    return result;
+}
+
+napi_value Deflater::JSFinish(napi_env env, napi_callback_info info) {
+    GET_DEFLATER_INFO_WITH_DEFLATER(4)
+    void *buffer = nullptr;
+    size_t length = 0;
+    getBuffer(env, argv[0], &buffer, &length);
+    long offset = getOffset(env, argv[1], length);
+    size_t count = getCount(env, argv[2], length, offset);
+    size_t bytesRead = 0;
+    bool success = deflater->finish(offset_pointer(buffer, offset), count, &bytesRead);
+    napi_value values[2]{nullptr};
+    NAPI_CALL(env, napi_get_boolean(env, success, &values[0]))
+    NAPI_CALL(env, napi_create_int64(env, bytesRead, &values[1]))
+    napi_property_descriptor desc[] = {
+        {"result", nullptr, nullptr, nullptr, nullptr, argv[0], napi_default, nullptr},
+        {"readBytes", nullptr, nullptr, nullptr, nullptr, argv[1], napi_default, nullptr},
+    };
+    napi_value result = nullptr;
+    NAPI_CALL(env, napi_create_object_with_properties(env, &result, 2, desc))
+    return result;
+}
+
+napi_value Deflater::JSDeflate(napi_env env, napi_callback_info info) {
+    GET_DEFLATER_INFO_WITH_DEFLATER(4)
+    void *buffer = nullptr;
+    size_t length = 0;
+    getBuffer(env, argv[0], &buffer, &length);
+    long offset = getOffset(env, argv[1], length);
+    size_t count = getCount(env, argv[2], length, offset);
+    long readBytes = deflater->getDeflateOutput(offset_pointer(buffer, offset), count);
+    napi_value result = nullptr;
+    NAPI_CALL(env, napi_create_int64(env, readBytes, &result))
+    return result;
+}
+
+void Deflater::Export(napi_env env, napi_value exports) {
+    napi_property_descriptor desc[] = {
+        DEFINE_NAPI_FUNCTION("setInput", JSSetInput, nullptr, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("needInput", nullptr, JSNeedInput, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("dispose", JSDispose, nullptr, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("isDisposed", nullptr, JSIsDisposed, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("flush", JSFlush, nullptr, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("finish", JSFinish, nullptr, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("deflate", JSDeflate, nullptr, nullptr, nullptr),
+    };
+    napi_value cons = nullptr;
+    NAPI_CALL(env, napi_define_class(env, "Deflater", NAPI_AUTO_LENGTH, JSConstructor, nullptr,
+                                     sizeof(desc) / sizeof(desc[0]), desc, &cons))
+    NAPI_CALL(env, napi_set_named_property(env, exports, "Deflater", cons))
+}
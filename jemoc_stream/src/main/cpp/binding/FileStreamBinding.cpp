@@ -0,0 +1,97 @@
+//
+// Created on 2025/1/9.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#include "binding/StreamBinding.h"
+#include "stream/FileStream.h"
+
+#define DEFAULT_BUFFER_SIZE 8192
+
+std::string FileStream::ClassName = "FileStream";
+napi_ref FileStream::cons = nullptr;
+
+void FileStream::Export(napi_env env, napi_value exports) {
+    napi_property_descriptor desc[] = {
+        DEFINE_NAPI_FUNCTION("preallocate", JSPreallocate, nullptr, nullptr, nullptr),
+    };
+    napi_value napi_cons = nullptr;
+    napi_define_class(env, ClassName.c_str(), NAPI_AUTO_LENGTH, JSConstructor, nullptr,
+                      sizeof(desc) / sizeof(desc[0]), desc, &napi_cons);
+    Extends(env, napi_cons);
+
+    napi_set_named_property(env, exports, ClassName.c_str(), napi_cons);
+}
+
+napi_value FileStream::JSConstructor(napi_env env, napi_callback_info info) {
+    GET_JS_INFO_WITHOUT_STREAM(3);
+
+    napi_valuetype type;
+
+    NAPI_CALL(env, napi_typeof(env, argv[2], &type))
+    long bufferSize = DEFAULT_BUFFER_SIZE;
+    if (type == napi_number)
+        bufferSize = getLong(env, argv[2]);
+    if (bufferSize < 0) {
+        napi_throw_range_error(env, "JSFileStream", "bufferSize must be non-negative");
+        return nullptr;
+    }
+
+    NAPI_CALL(env, napi_typeof(env, argv[0], &type))
+
+
+    int mode = getInt(env, argv[1]);
+//    FileStream *stream = nullptr;
+    std::shared_ptr<IStream> stream;
+    try {
+        if (type == napi_string) {
+            std::string path = getString(env, argv[0]);
+            stream = std::make_shared<FileStream>(path, FILE_MODE(mode), bufferSize);
+        } else if (type == napi_number) {
+            int fd = getInt(env, argv[0]);
+            stream = std::make_shared<FileStream>(fd, FILE_MODE(mode), bufferSize);
+        } else {
+            napi_value js_fd = nullptr;
+            napi_value js_offset = nullptr;
+            napi_value js_length = nullptr;
+            NAPI_CALL(env, napi_get_named_property(env, argv[0], "fd", &js_fd))
+            NAPI_CALL(env, napi_get_named_property(env, argv[0], "offset", &js_offset))
+            NAPI_CALL(env, napi_get_named_property(env, argv[0], "length", &js_length))
+            int fd = 0;
+            long offset = 0;
+            long length = 0;
+            NAPI_CALL(env, napi_get_value_int32(env, js_fd, &fd))
+            NAPI_CALL(env, napi_get_value_int64(env, js_offset, &offset))
+            NAPI_CALL(env, napi_get_value_int64(env, js_length, &length))
+            stream = std::make_shared<FileStream>(fd, offset, length, (mode & FILE_MODE_MMAP) != 0);
+        }
+    } catch (const std::ios_base::failure &e) {
+        napi_throw_error(env, "JSFileStream", e.what());
+        return nullptr;
+    }
+
+//    napi_wrap(env, _this, stream, JSDispose, nullptr, nullptr);
+//    return _this;
+    return JSBind(env, _this, stream);
+}
+
+// void FileStream::JSDispose(napi_env env, void *data, void *hint) {
+//     FileStream *stream = static_cast<FileStream *>(data);
+//     stream->close();
+//
+//     delete stream;
+// }
+
+napi_value FileStream::JSPreallocate(napi_env env, napi_callback_info info) {
+    GET_JS_INFO(1)
+    if (stream == nullptr || stream->isClose())
+        return nullptr;
+    long length = getLong(env, argv[0]);
+    try {
+        RETURN_NAPI_VALUE(napi_get_boolean, static_cast<FileStream *>(stream.get())->preallocate(length))
+    } catch (const std::exception &e) {
+        napi_throw_error(env, ClassName.c_str(), e.what());
+    }
+    return nullptr;
+}
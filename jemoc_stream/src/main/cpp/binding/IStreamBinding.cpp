@@ -0,0 +1,1053 @@
+//
+// Created on 2025/1/8.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#include "BufferPool.h"
+#include "binding/StreamBinding.h"
+#include "stream/AsyncIoQueue.h"
+#include "stream/DeflateStream.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <thread>
+#include <vector>
+
+napi_value IStream::cons = nullptr;
+std::string IStream::ClassName = "StreamBase";
+
+DEFINE_ISTREAM_GET_STATE(JSGetCanRead, getCanRead)
+DEFINE_ISTREAM_GET_STATE(JSGetCanWrite, getCanWrite)
+DEFINE_ISTREAM_GET_STATE(JSGetCanSeek, getCanSeek)
+DEFINE_ISTREAM_GET_LONG_FUNCTION(JSGetPosition, getPosition)
+DEFINE_ISTREAM_GET_LONG_FUNCTION(JSGetLength, getLength)
+
+
+/**
+ * copyTo写入js流时使用的暂存ArrayBuffer，传入BufferPool时从池中获取，用完后detach并归还，供下次调用复用
+ */
+struct CopyStagingBuffer {
+    jemoc_stream::BufferPool *pool = nullptr;
+    std::shared_ptr<uint8_t> holder;
+    napi_value value = nullptr;
+    void *data = nullptr;
+    long size = 0;
+
+    void acquire(napi_env env, long bufferSize) {
+        release(env);
+        // 池已用尽或bufferSize超过池的块大小时acquire返回空，退回普通ArrayBuffer
+        if (pool != nullptr)
+            holder = pool->acquire(bufferSize);
+        if (holder != nullptr) {
+            data = holder.get();
+            NAPI_CALL(env, napi_create_external_arraybuffer(
+                               env, data, bufferSize, [](napi_env env, void *data, void *hint) {}, nullptr, &value))
+        } else {
+            NAPI_CALL(env, napi_create_arraybuffer(env, bufferSize, &data, &value))
+        }
+        size = bufferSize;
+    }
+
+    void release(napi_env env) {
+        if (value == nullptr)
+            return;
+        if (holder != nullptr) {
+            // 先detach，防止js侧继续持有已归还的内存
+            NAPI_CALL(env, napi_detach_arraybuffer(env, value))
+            pool->release(holder);
+            holder = nullptr;
+        }
+        value = nullptr;
+        data = nullptr;
+        size = 0;
+    }
+};
+
+/**
+ * 解析copyTo的options参数：{bufferSize?: number, maxBufferSize?: number, bufferPool?: BufferPool}
+ */
+static void getCopyToJSOptions(napi_env env, napi_value value, long *bufferSize, long *maxBufferSize,
+                               jemoc_stream::BufferPool **pool) {
+    napi_valuetype type;
+    napi_value jsVal = nullptr;
+    NAPI_CALL(env, napi_get_named_property(env, value, "bufferSize", &jsVal))
+    NAPI_CALL(env, napi_typeof(env, jsVal, &type))
+    if (napi_number == type)
+        *bufferSize = getLong(env, jsVal);
+
+    NAPI_CALL(env, napi_get_named_property(env, value, "maxBufferSize", &jsVal))
+    NAPI_CALL(env, napi_typeof(env, jsVal, &type))
+    if (napi_number == type)
+        *maxBufferSize = getLong(env, jsVal);
+
+    NAPI_CALL(env, napi_get_named_property(env, value, "bufferPool", &jsVal))
+    NAPI_CALL(env, napi_typeof(env, jsVal, &type))
+    if (napi_object == type) {
+        void *data = nullptr;
+        NAPI_CALL(env, napi_unwrap(env, jsVal, &data))
+        *pool = static_cast<jemoc_stream::BufferPool *>(data);
+    }
+}
+
+napi_value IStream::JSCopyTo(napi_env env, napi_callback_info info) {
+    GET_JS_INFO(2)
+    if (!stream->getCanRead()) {
+        napi_throw_error(env, ClassName.c_str(), "stream not readable");
+    }
+    std::shared_ptr<IStream> target = GetStream(env, argv[0]);
+    napi_valuetype type;
+    NAPI_CALL(env, napi_typeof(env, argv[1], &type))
+    long bufferSize = 8192;
+    long maxBufferSize = 1024 * 1024;
+    jemoc_stream::BufferPool *pool = nullptr;
+    if (napi_object == type) {
+        getCopyToJSOptions(env, argv[1], &bufferSize, &maxBufferSize, &pool);
+    } else if (napi_undefined != type) {
+        bufferSize = getLong(env, argv[1]);
+    }
+    if (bufferSize <= 0) {
+        NAPI_CALL(env, napi_throw_error(env, ClassName.c_str(), "bufferSize is must larget than zero"))
+        return nullptr;
+    }
+
+    if (!stream->getCanRead()) {
+        NAPI_CALL(env, napi_throw_error(env, ClassName.c_str(), "source stream not writeable"))
+        return nullptr;
+    }
+
+    if (target) {
+        if (target->isClose()) {
+            NAPI_CALL(env, napi_throw_error(env, ClassName.c_str(), "target stream is closed"));
+            return nullptr;
+        }
+        if (!target->getCanWrite()) {
+            NAPI_CALL(env, napi_throw_error(env, ClassName.c_str(), "target stream not writeable"))
+            return nullptr;
+        }
+
+        try {
+            stream->copyTo(target.get(), bufferSize);
+        } catch (const std::ios_base::failure &e) {
+            NAPI_CALL(env, napi_throw_error(env, ClassName.c_str(), e.what()))
+        }
+    } else {
+        napi_value jsStatus = nullptr;
+        bool status = false;
+        NAPI_CALL(env, napi_get_named_property(env, argv[0], "isClosed", &jsStatus))
+        NAPI_CALL(env, napi_get_value_bool(env, jsStatus, &status))
+        if (status) {
+            NAPI_CALL(env, napi_throw_error(env, ClassName.c_str(), "target stream is closed"))
+            return nullptr;
+        }
+        NAPI_CALL(env, napi_get_named_property(env, argv[0], "canWrite", &jsStatus))
+        NAPI_CALL(env, napi_get_value_bool(env, jsStatus, &status))
+        if (!status) {
+            NAPI_CALL(env, napi_throw_error(env, ClassName.c_str(), "target stream not writeable"))
+            return nullptr;
+        }
+        napi_value writeFunc = nullptr;
+        NAPI_CALL(env, napi_get_named_property(env, argv[0], "write", &writeFunc))
+        NAPI_CALL(env, napi_typeof(env, writeFunc, &type))
+
+        if (type != napi_function) {
+            NAPI_CALL(env, napi_throw_error(env, ClassName.c_str(), "target function is not callable"))
+            return nullptr;
+        }
+
+        // 每次调用js的write都要跨越N-API，块大小从bufferSize开始，读满一块且写入吞吐没有下降时翻倍，
+        // 直到maxBufferSize
+        using Clock = std::chrono::steady_clock;
+        maxBufferSize = std::max(bufferSize, maxBufferSize);
+        long chunkSize = bufferSize;
+        bool growing = chunkSize < maxBufferSize;
+        double lastRate = 0;
+        CopyStagingBuffer staging{.pool = pool};
+        napi_value jsOffset = nullptr;
+        NAPI_CALL(env, napi_create_int32(env, 0, &jsOffset))
+        std::string catch_error;
+        while (true) {
+            if (staging.size != chunkSize) {
+                try {
+                    staging.acquire(env, chunkSize);
+                } catch (const std::exception &e) {
+                    catch_error = e.what();
+                    break;
+                }
+            }
+            long readBytes = 0;
+            try {
+                readBytes = stream->tracked(StreamStats::Read,
+                                            [&]() { return stream->read(staging.data, 0, chunkSize); });
+            } catch (const std::ios_base::failure &e) {
+                catch_error = e.what();
+                break;
+            }
+            if (readBytes <= 0)
+                break;
+
+            napi_handle_scope scope = nullptr;
+            NAPI_CALL(env, napi_open_handle_scope(env, &scope))
+            napi_value jsReadBytes = nullptr;
+            napi_value jsResult = nullptr;
+            NAPI_CALL(env, napi_create_int64(env, readBytes, &jsReadBytes))
+            napi_value targetArgv[3] = {staging.value, jsOffset, jsReadBytes};
+            auto begin = Clock::now();
+            if (napi_call_function(env, argv[0], writeFunc, 3, targetArgv, &jsResult) == napi_pending_exception) {
+                napi_value error;
+                napi_get_and_clear_last_exception(env, &error);
+                napi_value errorMessage;
+                napi_coerce_to_string(env, error, &errorMessage);
+                char message[1024];
+                size_t len;
+                napi_get_value_string_utf8(env, errorMessage, message, sizeof(message), &len);
+                catch_error = message;
+                NAPI_CALL(env, napi_close_handle_scope(env, scope))
+                break;
+            }
+            double elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+            // 目标流没有全部写入说明跟不上，不再增大块
+            NAPI_CALL(env, napi_typeof(env, jsResult, &type))
+            if (type == napi_number && getLong(env, jsResult) < readBytes)
+                growing = false;
+            NAPI_CALL(env, napi_close_handle_scope(env, scope))
+
+            if (growing && readBytes == chunkSize) {
+                double rate = readBytes / std::max(elapsed, 1e-9);
+                if (rate >= lastRate * 0.9) {
+                    lastRate = rate;
+                    chunkSize = std::min(chunkSize * 2, maxBufferSize);
+                    growing = chunkSize < maxBufferSize;
+                } else {
+                    growing = false;
+                }
+            }
+        }
+        staging.release(env);
+        if (!catch_error.empty()) {
+            NAPI_CALL(env, napi_throw_error(env, ClassName.c_str(), catch_error.c_str()))
+        }
+    }
+
+    return nullptr;
+}
+
+napi_value IStream::JSSeek(napi_env env, napi_callback_info info) {
+    GET_JS_INFO(2)
+    try {
+        if (!stream->getCanSeek()) {
+            napi_throw_error(env, ClassName.c_str(), "stream not seekable");
+        }
+        long pos = getLong(env, argv[0]);
+        int origin = getInt(env, argv[1]);
+        long seekResult = 0;
+        seekResult = stream->tracked(StreamStats::Seek, [&]() { return stream->seek(pos, SeekOrigin(origin)); });
+        RETURN_NAPI_VALUE(napi_create_int64, seekResult)
+
+    } catch (const std::ios_base::failure &e) {
+        napi_throw_error(env, ClassName.c_str(), e.what());
+        return nullptr;
+    }
+}
+
+napi_value IStream::JSRead(napi_env env, napi_callback_info info) {
+    GET_JS_INFO(3)
+    if (!stream->getCanRead()) {
+        napi_throw_error(env, ClassName.c_str(), "stream not readable");
+    }
+    void *data = nullptr;
+    size_t length = 0;
+    getBuffer(env, argv[0], &data, &length);
+    if (data == nullptr) {
+        napi_throw_type_error(env, ClassName.c_str(), "buffer is null");
+        return nullptr;
+    }
+    long offset = getOffset(env, argv[1], length);
+    long count = getCount(env, argv[2], length, offset);
+    long readBytes = 0;
+    try {
+        readBytes = stream->tracked(StreamStats::Read, [&]() { return stream->read(data, offset, count); });
+    } catch (const std::ios_base::failure &e) {
+        napi_throw_error(env, ClassName.c_str(), e.what());
+    }
+    RETURN_NAPI_VALUE(napi_create_int64, readBytes)
+}
+
+napi_value IStream::JSSetLength(napi_env env, napi_callback_info info) {
+    GET_JS_INFO(1)
+    long length = getLong(env, argv[0]);
+
+    if (!stream->m_canSetLength)
+        napi_throw_error(env, ClassName.c_str(), "stream not supported set length");
+
+    try {
+        stream->setLength(length);
+    } catch (const std::exception &e) {
+        napi_throw_error(env, ClassName.c_str(), e.what());
+    }
+    return nullptr;
+}
+
+
+napi_value IStream::JSWrite(napi_env env, napi_callback_info info) {
+    GET_JS_INFO(3)
+    if (!stream->getCanWrite()) {
+        napi_throw_error(env, ClassName.c_str(), "stream not writeable");
+    }
+    void *data = nullptr;
+    size_t length = 0;
+    getBuffer(env, argv[0], &data, &length);
+    if (data == nullptr) {
+        napi_throw_type_error(env, ClassName.c_str(), "buffer is null");
+        return nullptr;
+    }
+    long offset = getOffset(env, argv[1], length);
+    long count = getCount(env, argv[2], length, offset);
+    long readBytes = 0;
+    try {
+        readBytes = stream->tracked(StreamStats::Write, [&]() { return stream->write(data, offset, count); });
+    } catch (const std::ios_base::failure &e) {
+        napi_throw_error(env, ClassName.c_str(), e.what());
+    }
+    RETURN_NAPI_VALUE(napi_create_int64, readBytes)
+}
+
+/**
+ * 将js数组中的buffer转换成iovec，数组元素可以是ArrayBuffer或TypedArray
+ * @param env
+ * @param value
+ * @param iov
+ * @return 转换成功返回true，失败时已抛出js异常
+ */
+static bool getIovec(napi_env env, napi_value value, std::vector<struct iovec> &iov) {
+    bool isArray = false;
+    NAPI_CALL(env, napi_is_array(env, value, &isArray))
+    if (!isArray) {
+        napi_throw_type_error(env, IStream::ClassName.c_str(), "buffers must be an array");
+        return false;
+    }
+    uint32_t length = 0;
+    NAPI_CALL(env, napi_get_array_length(env, value, &length))
+    iov.reserve(length);
+    for (uint32_t i = 0; i < length; i++) {
+        napi_value element = nullptr;
+        NAPI_CALL(env, napi_get_element(env, value, i, &element))
+        void *data = nullptr;
+        size_t size = 0;
+        getBuffer(env, element, &data, &size);
+        if (data == nullptr && size != 0) {
+            napi_throw_type_error(env, IStream::ClassName.c_str(), "buffer is null");
+            return false;
+        }
+        iov.push_back({data, size});
+    }
+    return true;
+}
+
+napi_value IStream::JSReadv(napi_env env, napi_callback_info info) {
+    GET_JS_INFO(1)
+    if (!stream->getCanRead()) {
+        napi_throw_error(env, ClassName.c_str(), "stream not readable");
+        return nullptr;
+    }
+    std::vector<struct iovec> iov;
+    if (!getIovec(env, argv[0], iov))
+        return nullptr;
+    long readBytes = 0;
+    try {
+        readBytes = stream->tracked(StreamStats::Read, [&]() { return stream->readv(iov.data(), iov.size()); });
+    } catch (const std::exception &e) {
+        napi_throw_error(env, ClassName.c_str(), e.what());
+        return nullptr;
+    }
+    RETURN_NAPI_VALUE(napi_create_int64, readBytes)
+}
+
+napi_value IStream::JSWritev(napi_env env, napi_callback_info info) {
+    GET_JS_INFO(1)
+    if (!stream->getCanWrite()) {
+        napi_throw_error(env, ClassName.c_str(), "stream not writeable");
+        return nullptr;
+    }
+    std::vector<struct iovec> iov;
+    if (!getIovec(env, argv[0], iov))
+        return nullptr;
+    long writeBytes = 0;
+    try {
+        writeBytes = stream->tracked(StreamStats::Write, [&]() { return stream->writev(iov.data(), iov.size()); });
+    } catch (const std::exception &e) {
+        napi_throw_error(env, ClassName.c_str(), e.what());
+        return nullptr;
+    }
+    RETURN_NAPI_VALUE(napi_create_int64, writeBytes)
+}
+
+napi_value IStream::JSReadAt(napi_env env, napi_callback_info info) {
+    GET_JS_INFO(4)
+    if (!stream->getCanRead()) {
+        napi_throw_error(env, ClassName.c_str(), "stream not readable");
+        return nullptr;
+    }
+    long position = getLong(env, argv[0]);
+    void *data = nullptr;
+    size_t length = 0;
+    getBuffer(env, argv[1], &data, &length);
+    if (data == nullptr) {
+        napi_throw_type_error(env, ClassName.c_str(), "buffer is null");
+        return nullptr;
+    }
+    long offset = getOffset(env, argv[2], length);
+    long count = getCount(env, argv[3], length, offset);
+    long readBytes = 0;
+    try {
+        readBytes = stream->tracked(StreamStats::Read,
+                                    [&]() { return stream->readAt(position, data, offset, count); });
+    } catch (const std::exception &e) {
+        napi_throw_error(env, ClassName.c_str(), e.what());
+        return nullptr;
+    }
+    RETURN_NAPI_VALUE(napi_create_int64, readBytes)
+}
+
+napi_value IStream::JSWriteAt(napi_env env, napi_callback_info info) {
+    GET_JS_INFO(4)
+    if (!stream->getCanWrite()) {
+        napi_throw_error(env, ClassName.c_str(), "stream not writeable");
+        return nullptr;
+    }
+    long position = getLong(env, argv[0]);
+    void *data = nullptr;
+    size_t length = 0;
+    getBuffer(env, argv[1], &data, &length);
+    if (data == nullptr) {
+        napi_throw_type_error(env, ClassName.c_str(), "buffer is null");
+        return nullptr;
+    }
+    long offset = getOffset(env, argv[2], length);
+    long count = getCount(env, argv[3], length, offset);
+    long writeBytes = 0;
+    try {
+        writeBytes = stream->tracked(StreamStats::Write,
+                                     [&]() { return stream->writeAt(position, data, offset, count); });
+    } catch (const std::exception &e) {
+        napi_throw_error(env, ClassName.c_str(), e.what());
+        return nullptr;
+    }
+    RETURN_NAPI_VALUE(napi_create_int64, writeBytes)
+}
+
+napi_value IStream::JSFlush(napi_env env, napi_callback_info info) {
+    GET_JS_INFO(0);
+    try {
+        stream->tracked(StreamStats::Flush, [&]() {
+            stream->flush();
+            return 0l;
+        });
+
+    } catch (const std::ios_base::failure &e) {
+        napi_throw_error(env, ClassName.c_str(), e.what());
+    }
+    return nullptr;
+}
+
+napi_value IStream::JSClose(napi_env env, napi_callback_info info) {
+    GET_JS_INFO_WITHOUT_STREAM(0)
+    std::shared_ptr<IStream> stream = GetStream(env, _this);
+    if (!stream) {
+        return nullptr;
+    }
+    // DeflateStream关闭时还需要释放它持有的底层流js对象
+    DeflateStream *deflateStream = dynamic_cast<DeflateStream *>(stream.get());
+    if (deflateStream != nullptr)
+        deflateStream->close(env);
+    else
+        stream->close();
+    void *result = nullptr;
+    napi_remove_wrap(env, _this, &result);
+
+    return nullptr;
+}
+
+/**
+ * 记录一次异步任务的排队和执行耗时，统计未开启或任务提交时未开启时不记录
+ */
+class TrackAsync {
+public:
+    TrackAsync(IStream *stream, StreamStats::Clock::time_point queuedAt) : stream_(stream), queuedAt_(queuedAt) {
+        if (queuedAt != StreamStats::Clock::time_point())
+            started_ = StreamStats::Clock::now();
+    }
+    ~TrackAsync() {
+        StreamStats *stats = stream_->getStatsEnabled() ? stream_->getStats() : nullptr;
+        if (stats == nullptr || started_ == StreamStats::Clock::time_point())
+            return;
+        stats->recordAsync(StreamStats::toMs(started_ - queuedAt_),
+                           StreamStats::toMs(StreamStats::Clock::now() - started_));
+    }
+
+private:
+    IStream *stream_;
+    StreamStats::Clock::time_point queuedAt_;
+    StreamStats::Clock::time_point started_;
+};
+
+/**
+ * 提交到AsyncIoQueue的一次读写，持有流防止执行前被回收，完成后在js线程上resolve
+ */
+struct StreamIoTask : public AsyncIoQueue::Task {
+    std::shared_ptr<IStream> stream;
+    std::function<long()> func;
+    bool resolveResult = true;
+    long result = 0;
+    std::string error;
+    napi_deferred deferred = nullptr;
+    // 读写的目标buffer，任务完成前保持引用
+    napi_ref buffer = nullptr;
+
+    void execute() override {
+        try {
+            result = func();
+        } catch (const std::exception &e) {
+            error = e.what();
+        }
+    }
+};
+
+// 工作线程上一批任务完成后由线程安全函数调到js线程，一次resolve全部已完成的任务
+static void completeIoTasks(napi_env env, napi_value jsCallback, void *context, void *data) {
+    auto *weakQueue = static_cast<std::weak_ptr<AsyncIoQueue> *>(data);
+    std::shared_ptr<AsyncIoQueue> queue = weakQueue->lock();
+    delete weakQueue;
+    if (env == nullptr || queue == nullptr)
+        return;
+    for (auto &task : queue->takeCompleted()) {
+        StreamIoTask *ioTask = static_cast<StreamIoTask *>(task.get());
+        napi_value result = nullptr;
+        if (ioTask->error.empty()) {
+            if (ioTask->resolveResult)
+                napi_create_int64(env, ioTask->result, &result);
+            else
+                napi_get_undefined(env, &result);
+            napi_resolve_deferred(env, ioTask->deferred, result);
+        } else {
+            napi_create_string_utf8(env, ioTask->error.c_str(), NAPI_AUTO_LENGTH, &result);
+            napi_reject_deferred(env, ioTask->deferred, result);
+        }
+        if (ioTask->buffer != nullptr)
+            napi_delete_reference(env, ioTask->buffer);
+    }
+}
+
+static std::shared_ptr<AsyncIoQueue> createIoQueue(napi_env env) {
+    napi_value name = nullptr;
+    napi_create_string_utf8(env, "streamIo", NAPI_AUTO_LENGTH, &name);
+    napi_threadsafe_function tsfn = nullptr;
+    if (napi_create_threadsafe_function(env, nullptr, nullptr, name, 0, 1, nullptr, nullptr, nullptr,
+                                        completeIoTasks, &tsfn) != napi_ok)
+        return nullptr;
+    // 队列空闲时不阻止事件循环退出
+    napi_unref_threadsafe_function(env, tsfn);
+    // 线程安全函数随队列一起释放
+    std::shared_ptr<napi_threadsafe_function__> function(
+        tsfn, [](napi_threadsafe_function tsfn) { napi_release_threadsafe_function(tsfn, napi_tsfn_release); });
+    auto queue = std::make_shared<AsyncIoQueue>();
+    std::weak_ptr<AsyncIoQueue> weakQueue = queue;
+    queue->setNotify([function, weakQueue]() {
+        auto *data = new std::weak_ptr<AsyncIoQueue>(weakQueue);
+        if (napi_call_threadsafe_function(function.get(), data, napi_tsfn_nonblocking) != napi_ok)
+            delete data;
+    });
+    return queue;
+}
+
+napi_value IStream::queueIo(napi_env env, std::shared_ptr<IStream> stream, bool resolveResult,
+                            std::function<long()> func, napi_value buffer) {
+    if (stream->m_ioQueue == nullptr) {
+        stream->m_ioQueue = createIoQueue(env);
+        if (stream->m_ioQueue == nullptr) {
+            napi_throw_error(env, ClassName.c_str(), "create async queue failed");
+            return nullptr;
+        }
+    }
+    auto task = std::make_unique<StreamIoTask>();
+    task->stream = stream;
+    task->func = std::move(func);
+    task->resolveResult = resolveResult;
+    napi_value promise = nullptr;
+    NAPI_CALL(env, napi_create_promise(env, &task->deferred, &promise))
+    if (buffer != nullptr)
+        NAPI_CALL(env, napi_create_reference(env, buffer, 1, &task->buffer))
+    stream->m_ioQueue->submit(std::move(task));
+    return promise;
+}
+
+napi_value IStream::JSReadAsync(napi_env env, napi_callback_info info) {
+    GET_JS_INFO(3)
+    if (!stream->getCanRead()) {
+        napi_throw_error(env, "IStream::read", "stream not readable");
+    }
+    void *data = nullptr;
+    size_t length = 0;
+    getBuffer(env, argv[0], &data, &length);
+    if (data == nullptr) {
+        napi_throw_type_error(env, "IStream::read", "buffer is null");
+        return nullptr;
+    }
+    long offset = getOffset(env, argv[1], length);
+    long count = getCount(env, argv[2], length, offset);
+
+    IStream *target = stream.get();
+    StreamStats::Clock::time_point queuedAt;
+    if (stream->getStatsEnabled())
+        queuedAt = StreamStats::Clock::now();
+    return queueIo(env, stream, true, [target, data, offset, count, queuedAt]() {
+        std::lock_guard<std::mutex> lock(target->mutex_);
+        TrackAsync track(target, queuedAt);
+        return target->tracked(StreamStats::Read, [&]() { return target->read(data, offset, count); });
+    }, argv[0]);
+}
+
+napi_value IStream::JSWriteAsync(napi_env env, napi_callback_info info) {
+    GET_JS_INFO(3)
+    if (!stream->getCanWrite()) {
+        napi_throw_error(env, "IStream::wirte", "stream not writeable");
+    }
+    void *data = nullptr;
+    size_t length = 0;
+    getBuffer(env, argv[0], &data, &length);
+    if (data == nullptr) {
+        napi_throw_type_error(env, "IStream::write", "buffer is null");
+        return nullptr;
+    }
+    long offset = getOffset(env, argv[1], length);
+    long count = getCount(env, argv[2], length, offset);
+
+    IStream *target = stream.get();
+    StreamStats::Clock::time_point queuedAt;
+    if (stream->getStatsEnabled())
+        queuedAt = StreamStats::Clock::now();
+    return queueIo(env, stream, true, [target, data, offset, count, queuedAt]() {
+        std::lock_guard<std::mutex> lock(target->mutex_);
+        TrackAsync track(target, queuedAt);
+        return target->tracked(StreamStats::Write, [&]() { return target->write(data, offset, count); });
+    }, argv[0]);
+}
+
+struct PipelineCopyWorkData {
+    std::shared_ptr<IStream> stream;
+    std::shared_ptr<IStream> target;
+    long bufferSize;
+    int depth;
+    PipelineCopyStats stats;
+    std::string error;
+    napi_deferred deferred;
+    napi_async_work work;
+};
+
+/**
+ * 解析copyToAsync的options参数：{bufferSize?: number, pipeline?: boolean, depth?: number}
+ */
+static void getCopyToOptions(napi_env env, napi_value value, long *bufferSize, bool *pipeline, int *depth) {
+    napi_valuetype type;
+    napi_value jsVal = nullptr;
+    *bufferSize = 8192;
+    NAPI_CALL(env, napi_get_named_property(env, value, "bufferSize", &jsVal))
+    NAPI_CALL(env, napi_typeof(env, jsVal, &type))
+    if (napi_number == type)
+        *bufferSize = getLong(env, jsVal);
+
+    NAPI_CALL(env, napi_get_named_property(env, value, "pipeline", &jsVal))
+    NAPI_CALL(env, napi_typeof(env, jsVal, &type))
+    if (napi_boolean == type)
+        NAPI_CALL(env, napi_get_value_bool(env, jsVal, pipeline))
+
+    NAPI_CALL(env, napi_get_named_property(env, value, "depth", &jsVal))
+    NAPI_CALL(env, napi_typeof(env, jsVal, &type))
+    if (napi_number == type)
+        *depth = std::max(2, std::min(getInt(env, jsVal), 64));
+}
+
+static napi_value createPipelineCopyStats(napi_env env, const PipelineCopyStats &stats) {
+    napi_value result = nullptr;
+    napi_value value = nullptr;
+    NAPI_CALL(env, napi_create_object(env, &result))
+    NAPI_CALL(env, napi_create_int64(env, stats.bytes, &value))
+    NAPI_CALL(env, napi_set_named_property(env, result, "bytes", value))
+    NAPI_CALL(env, napi_create_double(env, stats.elapsedTime, &value))
+    NAPI_CALL(env, napi_set_named_property(env, result, "elapsedTime", value))
+    NAPI_CALL(env, napi_create_double(env, stats.readStallTime, &value))
+    NAPI_CALL(env, napi_set_named_property(env, result, "readStallTime", value))
+    NAPI_CALL(env, napi_create_double(env, stats.writeStallTime, &value))
+    NAPI_CALL(env, napi_set_named_property(env, result, "writeStallTime", value))
+    return result;
+}
+
+/**
+ * copyToAsync的流水线模式，读线程为async work的工作线程，写线程由copyToPipelined创建
+ */
+napi_value IStream::copyToPipelinedAsync(napi_env env, std::shared_ptr<IStream> stream,
+                                         std::shared_ptr<IStream> target, long bufferSize, int depth) {
+    napi_value promise = nullptr;
+    napi_value resouce_name = nullptr;
+    napi_create_string_utf8(env, "copyToAsync", NAPI_AUTO_LENGTH, &resouce_name);
+    PipelineCopyWorkData *asyncData = new PipelineCopyWorkData{
+        .stream = stream, .target = target, .bufferSize = bufferSize, .depth = depth};
+    napi_create_promise(env, &asyncData->deferred, &promise);
+    napi_create_async_work(
+        env, nullptr, resouce_name,
+        [](napi_env env, void *data) {
+            PipelineCopyWorkData *asyncData = static_cast<PipelineCopyWorkData *>(data);
+            std::lock_guard<std::mutex> lock(asyncData->stream->mutex_);
+            try {
+                asyncData->stats = asyncData->stream->copyToPipelined(asyncData->target.get(), asyncData->bufferSize,
+                                                                      asyncData->depth);
+            } catch (const std::exception &e) {
+                asyncData->error = e.what();
+            }
+        },
+        [](napi_env env, napi_status status, void *data) {
+            PipelineCopyWorkData *asyncData = static_cast<PipelineCopyWorkData *>(data);
+            napi_value result = nullptr;
+            if (status == napi_ok && asyncData->error.empty()) {
+                result = createPipelineCopyStats(env, asyncData->stats);
+                napi_resolve_deferred(env, asyncData->deferred, result);
+            } else {
+                const char *message = asyncData->error.empty() ? "io error" : asyncData->error.c_str();
+                napi_create_string_utf8(env, message, NAPI_AUTO_LENGTH, &result);
+                napi_reject_deferred(env, asyncData->deferred, result);
+            }
+            napi_delete_async_work(env, asyncData->work);
+            delete asyncData;
+        },
+        asyncData, &asyncData->work);
+
+    napi_queue_async_work(env, asyncData->work);
+    return promise;
+}
+
+napi_value IStream::JSCopyToAsync(napi_env env, napi_callback_info info) {
+    GET_JS_INFO(2)
+    if (!stream->getCanRead()) {
+        napi_throw_error(env, "IStream::copyTo", "stream not readable");
+    }
+    std::shared_ptr<IStream> target = GetStream(env, argv[0]);
+    if (target == nullptr) {
+        napi_throw_error(env, "IStream::copyTo", "target stream is null");
+        return nullptr;
+    }
+    if (!target->getCanWrite()) {
+        napi_throw_error(env, "IStream::copyTo", "stream not writeable");
+    }
+    napi_valuetype type;
+    napi_typeof(env, argv[1], &type);
+    long bufferSize = 0;
+    bool pipeline = false;
+    int depth = 4;
+    if (napi_undefined == type) {
+        bufferSize = 8192;
+    } else if (napi_object == type) {
+        getCopyToOptions(env, argv[1], &bufferSize, &pipeline, &depth);
+    } else {
+        bufferSize = getLong(env, argv[1]);
+    }
+    if (bufferSize <= 0) {
+        napi_throw_error(env, "IStream::copyTo", "bufferSize is must larget than zero");
+        return nullptr;
+    }
+    if (pipeline)
+        return copyToPipelinedAsync(env, stream, target, bufferSize, depth);
+
+    napi_value promise = nullptr;
+    napi_value resouce_name = nullptr;
+    napi_create_string_utf8(env, "copyToAsync", NAPI_AUTO_LENGTH, &resouce_name);
+    AsyncWorkData *asyncData =
+        new AsyncWorkData{.bufferSize = bufferSize, .stream = stream.get(), .targetStream = target.get()};
+    napi_create_promise(env, &asyncData->deferred, &promise);
+    napi_create_async_work(
+        env, nullptr, resouce_name,
+        [](napi_env env, void *data) {
+            AsyncWorkData *asyncData = static_cast<AsyncWorkData *>(data);
+            std::lock_guard<std::mutex> lock(asyncData->stream->mutex_);
+            asyncData->stream->copyTo(asyncData->targetStream, asyncData->bufferSize);
+        },
+        [](napi_env env, napi_status status, void *data) {
+            AsyncWorkData *asyncData = static_cast<AsyncWorkData *>(data);
+            napi_value result = nullptr;
+            if (status == napi_ok) {
+                napi_get_undefined(env, &result);
+                napi_resolve_deferred(env, asyncData->deferred, result);
+            } else {
+                napi_create_string_utf8(env, "io error", NAPI_AUTO_LENGTH, &result);
+                napi_reject_deferred(env, asyncData->deferred, result);
+            }
+            napi_delete_async_work(env, asyncData->work);
+            delete asyncData;
+        },
+        asyncData, &asyncData->work);
+
+    napi_queue_async_work(env, asyncData->work);
+    return promise;
+}
+
+
+napi_value IStream::JSFlushAsync(napi_env env, napi_callback_info info) {
+    GET_JS_INFO(0);
+    IStream *target = stream.get();
+    StreamStats::Clock::time_point queuedAt;
+    if (stream->getStatsEnabled())
+        queuedAt = StreamStats::Clock::now();
+    // 与readAsync/writeAsync使用同一队列，保证在之前提交的写入之后执行
+    return queueIo(env, stream, false, [target, queuedAt]() {
+        std::lock_guard<std::mutex> lock(target->mutex_);
+        TrackAsync track(target, queuedAt);
+        return target->tracked(StreamStats::Flush, [&]() {
+            target->flush();
+            return 0l;
+        });
+    });
+}
+
+napi_value IStream::JSCloseAsync(napi_env env, napi_callback_info info) {
+    GET_JS_INFO(0);
+    napi_value promise = nullptr;
+    napi_value resouce_name = nullptr;
+    napi_create_string_utf8(env, "closeAsync", NAPI_AUTO_LENGTH, &resouce_name);
+    AsyncWorkData *asyncData = new AsyncWorkData{.stream = stream.get()};
+    napi_create_promise(env, &asyncData->deferred, &promise);
+    napi_create_async_work(
+        env, nullptr, resouce_name,
+        [](napi_env env, void *data) {
+            AsyncWorkData *asyncData = static_cast<AsyncWorkData *>(data);
+            asyncData->stream->close();
+        },
+        [](napi_env env, napi_status status, void *data) {
+            AsyncWorkData *asyncData = static_cast<AsyncWorkData *>(data);
+            std::lock_guard<std::mutex> lock(asyncData->stream->mutex_);
+            napi_value result = nullptr;
+            if (status == napi_ok) {
+                napi_get_undefined(env, &result);
+                napi_resolve_deferred(env, asyncData->deferred, result);
+            } else {
+                napi_create_string_utf8(env, "io error", NAPI_AUTO_LENGTH, &result);
+                napi_reject_deferred(env, asyncData->deferred, result);
+            }
+            napi_delete_async_work(env, asyncData->work);
+            delete asyncData;
+        },
+        asyncData, &asyncData->work);
+
+    napi_queue_async_work(env, asyncData->work);
+    return promise;
+}
+
+napi_value IStream::JSCreateInterface(napi_env env, std::shared_ptr<IStream> stream) {
+    napi_value result = nullptr;
+    napi_property_descriptor desc[] = {DEFINE_NAPI_ISTREAM_PROPERTY(nullptr)};
+    SharedPtrWrapper *wrapper = new SharedPtrWrapper(stream);
+    NAPI_CALL(env, napi_create_object_with_properties(env, &result, sizeof(desc) / sizeof(desc[0]), desc))
+    NAPI_CALL(env, napi_wrap(
+                       env, result, wrapper,
+                       [](napi_env env, void *data, void *hint) {
+                           SharedPtrWrapper *wrapper = static_cast<SharedPtrWrapper *>(data);
+                           delete wrapper;
+                       },
+                       nullptr, nullptr))
+    return result;
+}
+
+napi_value IStream::JSBind(napi_env env, napi_value value, std::shared_ptr<IStream> stream) {
+//    NAPI_CALL(env,)
+    napi_wrap(
+        env, value, new SharedPtrWrapper(stream),
+        [](napi_env env, void *data, void *hint) {
+            if (data) {
+                delete static_cast<SharedPtrWrapper *>(data);
+            }
+        },
+        nullptr, nullptr);
+    return value;
+}
+
+
+napi_value IStream::JSGetIsClosed(napi_env env, napi_callback_info info) {
+    GET_JS_INFO_WITHOUT_CHECK(0)
+
+    bool value = false;
+    try {
+        value = stream == nullptr || stream->isClose();
+    } catch (const std::exception &e) {
+        value = true;
+    }
+    napi_value result = nullptr;
+    NAPI_CALL(env, napi_get_boolean(env, value, &result))
+    return result;
+}
+
+
+static napi_value createOpStats(napi_env env, const StreamOpStats &stats) {
+    napi_value result = nullptr;
+    napi_value value = nullptr;
+    NAPI_CALL(env, napi_create_object(env, &result))
+    NAPI_CALL(env, napi_create_int64(env, stats.count, &value))
+    NAPI_CALL(env, napi_set_named_property(env, result, "count", value))
+    NAPI_CALL(env, napi_create_int64(env, stats.bytes, &value))
+    NAPI_CALL(env, napi_set_named_property(env, result, "bytes", value))
+    NAPI_CALL(env, napi_create_double(env, stats.totalTime, &value))
+    NAPI_CALL(env, napi_set_named_property(env, result, "totalTime", value))
+    NAPI_CALL(env, napi_create_double(env, stats.maxTime, &value))
+    NAPI_CALL(env, napi_set_named_property(env, result, "maxTime", value))
+    NAPI_CALL(env, napi_create_int64(env, stats.minorFaults, &value))
+    NAPI_CALL(env, napi_set_named_property(env, result, "minorFaults", value))
+    NAPI_CALL(env, napi_create_int64(env, stats.majorFaults, &value))
+    NAPI_CALL(env, napi_set_named_property(env, result, "majorFaults", value))
+    return result;
+}
+
+static napi_value createAsyncStats(napi_env env, const StreamAsyncStats &stats) {
+    napi_value result = nullptr;
+    napi_value value = nullptr;
+    NAPI_CALL(env, napi_create_object(env, &result))
+    NAPI_CALL(env, napi_create_int64(env, stats.count, &value))
+    NAPI_CALL(env, napi_set_named_property(env, result, "count", value))
+    NAPI_CALL(env, napi_create_double(env, stats.queuedTime, &value))
+    NAPI_CALL(env, napi_set_named_property(env, result, "queuedTime", value))
+    NAPI_CALL(env, napi_create_double(env, stats.maxQueuedTime, &value))
+    NAPI_CALL(env, napi_set_named_property(env, result, "maxQueuedTime", value))
+    NAPI_CALL(env, napi_create_double(env, stats.executeTime, &value))
+    NAPI_CALL(env, napi_set_named_property(env, result, "executeTime", value))
+    NAPI_CALL(env, napi_create_double(env, stats.maxExecuteTime, &value))
+    NAPI_CALL(env, napi_set_named_property(env, result, "maxExecuteTime", value))
+    return result;
+}
+
+napi_value IStream::JSGetStats(napi_env env, napi_callback_info info) {
+    GET_JS_INFO_WITHOUT_CHECK(0)
+    napi_value result = nullptr;
+    if (stream == nullptr || stream->getStats() == nullptr) {
+        NAPI_CALL(env, napi_get_undefined(env, &result))
+        return result;
+    }
+    StreamStats::Snapshot stats = stream->getStats()->snapshot();
+    NAPI_CALL(env, napi_create_object(env, &result))
+    NAPI_CALL(env, napi_set_named_property(env, result, "read", createOpStats(env, stats.read)))
+    NAPI_CALL(env, napi_set_named_property(env, result, "write", createOpStats(env, stats.write)))
+    NAPI_CALL(env, napi_set_named_property(env, result, "flush", createOpStats(env, stats.flush)))
+    NAPI_CALL(env, napi_set_named_property(env, result, "seek", createOpStats(env, stats.seek)))
+    NAPI_CALL(env, napi_set_named_property(env, result, "async", createAsyncStats(env, stats.async)))
+    return result;
+}
+
+napi_value IStream::JSResetStats(napi_env env, napi_callback_info info) {
+    GET_JS_INFO_WITHOUT_CHECK(0)
+    if (stream != nullptr && stream->getStats() != nullptr)
+        stream->getStats()->reset();
+    return nullptr;
+}
+
+/**
+ * slice(start: number, length?: number): IStream，返回的子流持有本流的js对象，本流不会先于子流被回收
+ */
+napi_value IStream::JSSlice(napi_env env, napi_callback_info info) {
+    GET_JS_INFO(2)
+    if (stream == nullptr || stream->isClose())
+        return nullptr;
+    long start = getLong(env, argv[0]);
+    long length = stream->getLength();
+    napi_valuetype type;
+    NAPI_CALL(env, napi_typeof(env, argv[1], &type))
+    if (type == napi_number)
+        length = getLong(env, argv[1]);
+    std::shared_ptr<IStream> slice;
+    try {
+        slice = Slice(stream, start, length);
+    } catch (const std::exception &e) {
+        napi_throw_error(env, ClassName.c_str(), e.what());
+        return nullptr;
+    }
+    napi_value result = JSCreateInterface(env, slice);
+    if (result == nullptr)
+        return nullptr;
+    napi_property_descriptor desc = {"_parent", nullptr, nullptr, nullptr, nullptr, _this, napi_default, nullptr};
+    NAPI_CALL(env, napi_define_properties(env, result, 1, &desc))
+    return result;
+}
+
+napi_value IStream::JSGetStatsEnabled(napi_env env, napi_callback_info info) {
+    GET_JS_INFO_WITHOUT_CHECK(0)
+    RETURN_BOOL(stream != nullptr && stream->getStatsEnabled())
+}
+
+napi_value IStream::JSSetStatsEnabled(napi_env env, napi_callback_info info) {
+    GET_JS_INFO(1)
+    bool enabled = false;
+    NAPI_CALL(env, napi_get_value_bool(env, argv[0], &enabled))
+    stream->setStatsEnabled(enabled);
+    return nullptr;
+}
+
+napi_value IStream::JSSetGlobalStatsEnabled(napi_env env, napi_callback_info info) {
+    GET_JS_INFO_WITHOUT_STREAM(1)
+    bool enabled = false;
+    NAPI_CALL(env, napi_get_value_bool(env, argv[0], &enabled))
+    SetGlobalStatsEnabled(enabled);
+    return nullptr;
+}
+
+
+void IStream::Export(napi_env env, napi_value exports) {
+    napi_property_descriptor desc[] = {
+        DEFINE_NAPI_FUNCTION("canRead", nullptr, IStream::JSGetCanRead, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("canWrite", nullptr, IStream::JSGetCanWrite, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("canSeek", nullptr, IStream::JSGetCanSeek, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("position", nullptr, IStream::JSGetPosition, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("length", nullptr, IStream::JSGetLength, IStream::JSSetLength, nullptr),
+        DEFINE_NAPI_FUNCTION("copyTo", IStream::JSCopyTo, nullptr, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("seek", IStream::JSSeek, nullptr, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("read", IStream::JSRead, nullptr, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("write", IStream::JSWrite, nullptr, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("readv", IStream::JSReadv, nullptr, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("writev", IStream::JSWritev, nullptr, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("readAt", IStream::JSReadAt, nullptr, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("writeAt", IStream::JSWriteAt, nullptr, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("flush", IStream::JSFlush, nullptr, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("close", IStream::JSClose, nullptr, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("readAsync", IStream::JSReadAsync, nullptr, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("writeAsync", IStream::JSWriteAsync, nullptr, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("copyToAsync", IStream::JSCopyToAsync, nullptr, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("flushAsync", IStream::JSFlushAsync, nullptr, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("closeAsync", IStream::JSCloseAsync, nullptr, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("isClosed", nullptr, IStream::JSGetIsClosed, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("stats", nullptr, IStream::JSGetStats, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("statsEnabled", nullptr, IStream::JSGetStatsEnabled, IStream::JSSetStatsEnabled, nullptr),
+        DEFINE_NAPI_FUNCTION("resetStats", IStream::JSResetStats, nullptr, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("slice", IStream::JSSlice, nullptr, nullptr, nullptr),
+        {"setGlobalStatsEnabled", nullptr, IStream::JSSetGlobalStatsEnabled, nullptr, nullptr, nullptr, napi_static,
+         nullptr},
+    };
+    NAPI_CALL(env, napi_define_class(
+                       env, ClassName.c_str(), NAPI_AUTO_LENGTH,
+                       [](napi_env env, napi_callback_info info) -> napi_value { return nullptr; }, nullptr,
+                       sizeof(desc) / sizeof(desc[0]), desc, &cons));
+
+    NAPI_CALL(env, napi_set_named_property(env, exports, ClassName.c_str(), cons))
+}
+
+void IStream::Extends(napi_env env, napi_value constructor) {
+    napi_value baseCon = nullptr;
+    napi_value extendCon = nullptr;
+    NAPI_CALL(env, napi_get_named_property(env, cons, "prototype", &baseCon))
+    NAPI_CALL(env, napi_get_named_property(env, constructor, "prototype", &extendCon))
+    NAPI_CALL(env, napi_set_named_property(env, extendCon, "__proto__", baseCon))
+}
+
+IStream::SharedPtrWrapper *IStream::MakePtr(IStream *stream) {
+    return new IStream::SharedPtrWrapper(std::shared_ptr<IStream>(stream));
+}
+
+std::shared_ptr<IStream> IStream::GetStream(napi_env env, napi_value value) {
+    void *result = nullptr;
+    NAPI_CALL(env, napi_unwrap(env, value, &result))
+    if (result == nullptr)
+        return nullptr;
+    return static_cast<SharedPtrWrapper *>(result)->ptr;
+}
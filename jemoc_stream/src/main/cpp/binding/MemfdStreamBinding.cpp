@@ -0,0 +1,337 @@
+//
+// Created on 2025/2/11.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#include "binding/StreamBinding.h"
+#include "stream/MemfdStream.h"
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+std::string MemfdStream::ClassName = "MemfdStream";
+napi_ref MemfdStream::cons = nullptr;
+
+napi_value MemfdStream::JSConstructor(napi_env env, napi_callback_info info) {
+    GET_JS_INFO_WITHOUT_STREAM(1)
+
+    napi_valuetype type;
+    NAPI_CALL(env, napi_typeof(env, argv[0], &type))
+
+//    MemfdStream *stream = nullptr;
+    std::shared_ptr<IStream> stream;
+    try {
+        if (type == napi_undefined) {
+            stream = std::make_shared<MemfdStream>();
+        } else {
+            void *data = nullptr;
+            size_t length = 0;
+            getBuffer(env, argv[0], &data, &length);
+            stream = std::make_shared<MemfdStream>(data, length);
+        }
+    } catch (const std::exception &e) {
+        napi_throw_error(env, tagName, e.what());
+        return nullptr;
+    }
+//    NAPI_CALL(env, napi_wrap(env, _this, stream, JSDisposed, nullptr, nullptr))
+//    return _this;
+    return JSBind(env, _this, stream);
+}
+
+// void MemfdStream::JSDisposed(napi_env env, void *data, void *hint) {
+//     try {
+//         MemfdStream *stream = static_cast<MemfdStream *>(data);
+//         stream->close();
+//         delete stream;
+//     } catch (const std::exception &e) {
+//     }
+// }
+
+napi_value MemfdStream::JSToArrayBuffer(napi_env env, napi_callback_info info) {
+    GET_JS_INFO(1)
+    try {
+        long offset = 0;
+        long length = stream->getLength();
+        if (argc > 0) {
+            getToArrayBufferOptions(env, argv[0], &offset, &length);
+        }
+        napi_value result = static_cast<MemfdStream *>(stream.get())->readAllFromFd(env, offset, length);
+        return result;
+    } catch (const std::exception &e) {
+        NAPI_CALL(env, napi_throw_error(env, tagName, e.what()))
+        return nullptr;
+    }
+}
+
+napi_value MemfdStream::readAllFromFd(napi_env env, long offset, long length) {
+    offset = std::max(0L, std::min(offset, m_length));
+    length = std::max(0L, std::min(length, m_length - offset));
+    void *data = nullptr;
+    napi_value result = nullptr;
+    NAPI_CALL(env, napi_create_arraybuffer(env, length, &data, &result))
+
+    // 直接从映射拷贝，不改变流指针位置
+    if (length > 0) {
+        readAt(offset, data, 0, length);
+    }
+    return result;
+}
+
+napi_value MemfdStream::JSGetFd(napi_env env, napi_callback_info info) {
+    GET_JS_INFO(0)
+    napi_value result = nullptr;
+    int fd = static_cast<MemfdStream *>(stream.get())->getFd();
+
+    NAPI_CALL(env, napi_create_int32(env, fd, &result));
+    return result;
+}
+
+napi_value MemfdStream::JSSendFile(napi_env env, napi_callback_info info) {
+//     GET_JS_INFO(3)
+//     napi_valuetype type;
+//     int fd = -1;
+//     napi_value result;
+//     bool autoClose = false;
+//     long offset = 0;
+//     long length = stream->getLength();
+//     int optionsIndex = 0;
+//
+//
+//     NAPI_CALL(env, napi_typeof(env, argv[0], &type))
+//     if (type == napi_number) {
+//         NAPI_CALL(env, napi_get_value_int32(env, argv[0], &fd))
+//         optionsIndex = 1;
+//     } else if (type == napi_string) {
+//         NAPI_CALL(env, napi_typeof(env, argv[1], &type))
+//         if (type != napi_number) {
+//             napi_throw_type_error(env, "MemfdStream", "mode must be number");
+//             return nullptr;
+//         }
+//         autoClose = true;
+//         int openMode = 0;
+//         NAPI_CALL(env, napi_get_value_int32(env, argv[1], &openMode))
+//
+//         size_t bufsize = 0;
+//         NAPI_CALL(env, napi_get_value_string_utf8(env, argv[0], nullptr, 0, &bufsize))
+//         std::unique_ptr<char[]> buffer(new char[bufsize + 1]{'\0'});
+//         NAPI_CALL(env, napi_get_value_string_utf8(env, argv[0], buffer.get(), bufsize + 1, &bufsize))
+//         fd = open(buffer.get(), openMode, 0644);
+//
+//         optionsIndex = 2;
+//     } else {
+//         napi_throw_type_error(env, ClassName.c_str(), "invalid parameter type");
+//         return nullptr;
+//     }
+//
+//     if (fd == -1) {
+//         OH_LOG_ERROR(LOG_APP, "%s", "fd error, fd = -1, errno:%d", errno);
+//         NAPI_CALL(env, napi_get_boolean(env, false, &result))
+//         return result;
+//     }
+//
+//
+//     NAPI_CALL(env, napi_typeof(env, argv[optionsIndex], &type))
+//     if (type == napi_object) {
+//         napi_value js_offset;
+//         napi_value js_length;
+//         napi_value js_auto_close;
+//         NAPI_CALL(env, napi_get_named_property(env, argv[1], "offset", &js_offset))
+//         NAPI_CALL(env, napi_get_named_property(env, argv[1], "length", &js_length))
+//         NAPI_CALL(env, napi_get_named_property(env, argv[1], "autoClose", &js_auto_close))
+//         NAPI_CALL(env, napi_typeof(env, js_offset, &type))
+//         if (type == napi_number) {
+//             NAPI_CALL(env, napi_get_value_int64(env, js_offset, &offset))
+//         }
+//
+//         NAPI_CALL(env, napi_typeof(env, js_length, &type))
+//         if (type == napi_number) {
+//             NAPI_CALL(env, napi_get_value_int64(env, js_length, &length))
+//         }
+//         if (optionsIndex == 1) {
+//             NAPI_CALL(env, napi_typeof(env, js_auto_close, &type))
+//             if (type == napi_boolean) {
+//                 NAPI_CALL(env, napi_get_value_bool(env, js_auto_close, &autoClose));
+//             }
+//         }
+//     }
+//
+//     try {
+//         static_cast<MemfdStream *>(stream)->sendFile(fd, offset, length);
+//         NAPI_CALL(env, napi_get_boolean(env, true, &result))
+//     } catch (const std::exception &e) {
+//         OH_LOG_ERROR(LOG_APP, "%s", e.what());
+//         NAPI_CALL(env, napi_get_boolean(env, false, &result))
+//     }
+//
+//     if (autoClose) {
+//         ::close(fd);
+//     }
+//
+//     return result;
+
+    int fd = -1;
+    bool autoClose = false;
+    long offset = 0;
+    long length = 0;
+    MemfdStream *stream = nullptr;
+
+    initSendFile(env, info, fd, offset, length, autoClose, &stream);
+
+    bool val = stream->sendFile(fd, offset, length);
+
+    if (autoClose) {
+        ::close(fd);
+    }
+
+    napi_value result = nullptr;
+
+    NAPI_CALL(env, napi_get_boolean(env, val, &result))
+    return result;
+}
+
+void MemfdStream::initSendFile(napi_env env, napi_callback_info info, int &fd, long &offset, long &length,
+                               bool &autoClose, MemfdStream **fdStream) {
+    GET_JS_INFO(3)
+    napi_valuetype type;
+    fd = -1;
+    napi_value result;
+    autoClose = false;
+    offset = 0;
+    length = stream->getLength();
+    int optionsIndex = 0;
+
+    *fdStream = static_cast<MemfdStream *>(stream.get());
+
+
+    NAPI_CALL(env, napi_typeof(env, argv[0], &type))
+    if (type == napi_number) {
+        NAPI_CALL(env, napi_get_value_int32(env, argv[0], &fd))
+        optionsIndex = 1;
+    } else if (type == napi_string) {
+        NAPI_CALL(env, napi_typeof(env, argv[1], &type))
+        if (type != napi_number) {
+            napi_throw_type_error(env, "MemfdStream", "mode must be number");
+        }
+        autoClose = true;
+        int openMode = 0;
+        NAPI_CALL(env, napi_get_value_int32(env, argv[1], &openMode))
+
+        size_t bufsize = 0;
+        NAPI_CALL(env, napi_get_value_string_utf8(env, argv[0], nullptr, 0, &bufsize))
+        std::unique_ptr<char[]> buffer(new char[bufsize + 1]{'\0'});
+        NAPI_CALL(env, napi_get_value_string_utf8(env, argv[0], buffer.get(), bufsize + 1, &bufsize))
+        fd = open(buffer.get(), openMode, 0644);
+
+        optionsIndex = 2;
+    } else {
+        napi_throw_type_error(env, ClassName.c_str(), "invalid parameter type");
+    }
+
+    NAPI_CALL(env, napi_typeof(env, argv[optionsIndex], &type))
+    if (type == napi_object) {
+        napi_value js_offset;
+        napi_value js_length;
+        napi_value js_auto_close;
+        NAPI_CALL(env, napi_get_named_property(env, argv[1], "offset", &js_offset))
+        NAPI_CALL(env, napi_get_named_property(env, argv[1], "length", &js_length))
+        NAPI_CALL(env, napi_get_named_property(env, argv[1], "autoClose", &js_auto_close))
+        NAPI_CALL(env, napi_typeof(env, js_offset, &type))
+        if (type == napi_number) {
+            NAPI_CALL(env, napi_get_value_int64(env, js_offset, &offset))
+        }
+
+        NAPI_CALL(env, napi_typeof(env, js_length, &type))
+        if (type == napi_number) {
+            NAPI_CALL(env, napi_get_value_int64(env, js_length, &length))
+        }
+        if (optionsIndex == 1) {
+            NAPI_CALL(env, napi_typeof(env, js_auto_close, &type))
+            if (type == napi_boolean) {
+                NAPI_CALL(env, napi_get_value_bool(env, js_auto_close, &autoClose));
+            }
+        }
+    }
+}
+
+napi_value MemfdStream::JSSendFileAsync(napi_env env, napi_callback_info info) {
+    int fd = -1;
+    bool autoClose = false;
+    long offset = 0;
+    long length = 0;
+    MemfdStream *stream = nullptr;
+
+    initSendFile(env, info, fd, offset, length, autoClose, &stream);
+
+    SendFileData *data = new SendFileData{
+        .stream = stream, .fd = fd, .offset = offset, .length = length, .result = false, .autoClose = autoClose};
+    napi_value resourceName = nullptr;
+    NAPI_CALL(env, napi_create_string_utf8(env, "sendFileAsync", NAPI_AUTO_LENGTH, &resourceName))
+    napi_value result = nullptr;
+    NAPI_CALL(env, napi_create_promise(env, &data->deferred, &result))
+    napi_create_async_work(
+        env, nullptr, resourceName,
+        [](napi_env env, void *data) {
+            SendFileData *asyncData = static_cast<SendFileData *>(data);
+            asyncData->result = asyncData->stream->sendFile(asyncData->fd, asyncData->offset, asyncData->length);
+        },
+        [](napi_env env, napi_status status, void *data) {
+            SendFileData *asyncData = static_cast<SendFileData *>(data);
+            napi_value result = nullptr;
+            if (asyncData->autoClose) {
+                ::close(asyncData->fd);
+            }
+            NAPI_CALL(env, napi_get_boolean(env, asyncData->result, &result))
+            if (status == napi_ok) {
+                NAPI_CALL(env, napi_resolve_deferred(env, asyncData->deferred, result))
+            } else {
+                NAPI_CALL(env, napi_reject_deferred(env, asyncData->deferred, nullptr))
+            }
+            NAPI_CALL(env, napi_delete_async_work(env, asyncData->work))
+        },
+        data, &data->work);
+
+    NAPI_CALL(env, napi_queue_async_work(env, data->work))
+    return result;
+}
+
+/**
+ * 封印memfd，之后流只读，fd可交给其他进程或worker作为不可变数据映射读取
+ */
+napi_value MemfdStream::JSSeal(napi_env env, napi_callback_info info) {
+    GET_JS_INFO(0)
+    if (stream == nullptr || stream->isClose())
+        return nullptr;
+    try {
+        static_cast<MemfdStream *>(stream.get())->seal();
+    } catch (const std::exception &e) {
+        napi_throw_error(env, ClassName.c_str(), e.what());
+    }
+    return nullptr;
+}
+
+napi_value MemfdStream::JSGetSealed(napi_env env, napi_callback_info info) {
+    GET_JS_INFO_WITHOUT_CHECK(0)
+    if (stream == nullptr)
+        return nullptr;
+    RETURN_NAPI_VALUE(napi_get_boolean, static_cast<MemfdStream *>(stream.get())->isSealed())
+}
+
+
+void MemfdStream::Export(napi_env env, napi_value exports) {
+    napi_property_descriptor desc[] = {
+//        DEFINE_NAPI_ISTREAM_PROPERTY((void *)ClassName.c_str()),
+        DEFINE_NAPI_FUNCTION("fd", nullptr, JSGetFd, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("toArrayBuffer", JSToArrayBuffer, nullptr, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("sendFile", JSSendFile, nullptr, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("sendFileAsync", JSSendFileAsync, nullptr, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("seal", JSSeal, nullptr, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("sealed", nullptr, JSGetSealed, nullptr, nullptr),
+    };
+    napi_value napi_cons = nullptr;
+    napi_define_class(env, ClassName.c_str(), NAPI_AUTO_LENGTH, JSConstructor, nullptr, sizeof(desc) / sizeof(desc[0]),
+                      desc, &napi_cons);
+    napi_create_reference(env, napi_cons, 1, &cons);
+    Extends(env, napi_cons);
+    napi_set_named_property(env, exports, ClassName.c_str(), napi_cons);
+}
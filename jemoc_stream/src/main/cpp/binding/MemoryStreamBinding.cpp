@@ -0,0 +1,196 @@
+//
+// Created on 2025/1/8.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#include "binding/StreamBinding.h"
+#include "stream/MemoryStream.h"
+
+std::string MemoryStream::ClassName = "MemoryStream";
+napi_ref MemoryStream::cons = nullptr;
+
+/**
+ * MemoryStream构造函数，入参可能是个number、arraybuffer，或者是{chunked?: boolean, chunkSize?: number, capacity?: number}。
+ * 传入arraybuffer时第二个参数可以是{view?: boolean, writable?: boolean}，view为true时直接包装这块内存，不拷贝
+ * @param env
+ * @param info
+ * @return
+ */
+napi_value MemoryStream::JSConstructor(napi_env env, napi_callback_info info) {
+    GET_JS_INFO_WITHOUT_STREAM(2);
+    napi_valuetype type;
+    NAPI_CALL(env, napi_typeof(env, argv[0], &type))
+//    MemoryStream *stream = new MemoryStream();
+    std::shared_ptr<IStream> stream = std::make_shared<MemoryStream>();
+    if (type != napi_undefined) {
+        bool isBuffer = false;
+        if (type == napi_object) {
+            bool isArrayBuffer = false;
+            bool isTypedArray = false;
+            NAPI_CALL(env, napi_is_arraybuffer(env, argv[0], &isArrayBuffer))
+            NAPI_CALL(env, napi_is_typedarray(env, argv[0], &isTypedArray))
+            isBuffer = isArrayBuffer || isTypedArray;
+        }
+        if (type == napi_number) {
+            long capacity = getLong(env, argv[0]);
+            ((MemoryStream *)stream.get())->setCapacity(capacity);
+            stream = std::make_shared<MemoryStream>(capacity);
+        } else if (type == napi_object && !isBuffer) {
+            bool chunked = false;
+            long chunkSize = DefaultChunkSize;
+            long capacity = 0;
+            napi_value val;
+            NAPI_CALL(env, napi_get_named_property(env, argv[0], "chunked", &val))
+            NAPI_CALL(env, napi_typeof(env, val, &type))
+            if (type == napi_boolean) {
+                NAPI_CALL(env, napi_get_value_bool(env, val, &chunked))
+            }
+            NAPI_CALL(env, napi_get_named_property(env, argv[0], "chunkSize", &val))
+            NAPI_CALL(env, napi_typeof(env, val, &type))
+            if (type == napi_number)
+                chunkSize = getLong(env, val);
+            NAPI_CALL(env, napi_get_named_property(env, argv[0], "capacity", &val))
+            NAPI_CALL(env, napi_typeof(env, val, &type))
+            if (type == napi_number)
+                capacity = getLong(env, val);
+            if (capacity < 0 || (chunked && chunkSize <= 0)) {
+                napi_throw_range_error(env, ClassName.c_str(), "capacity or chunkSize is out of range");
+                return nullptr;
+            }
+            stream = std::make_shared<MemoryStream>(capacity, chunked ? chunkSize : 0);
+        } else {
+            void *data = nullptr;
+            size_t length = 0;
+            getBuffer(env, argv[0], &data, &length);
+            bool view = false;
+            bool writable = false;
+            NAPI_CALL(env, napi_typeof(env, argv[1], &type))
+            if (type == napi_object) {
+                napi_value val;
+                NAPI_CALL(env, napi_get_named_property(env, argv[1], "view", &val))
+                NAPI_CALL(env, napi_typeof(env, val, &type))
+                if (type == napi_boolean) {
+                    NAPI_CALL(env, napi_get_value_bool(env, val, &view))
+                }
+                NAPI_CALL(env, napi_get_named_property(env, argv[1], "writable", &val))
+                NAPI_CALL(env, napi_typeof(env, val, &type))
+                if (type == napi_boolean) {
+                    NAPI_CALL(env, napi_get_value_bool(env, val, &writable))
+                }
+            }
+            if (view && data != nullptr) {
+                // 持有buffer的引用，流析构前js侧不会回收这块内存
+                napi_ref ref = nullptr;
+                NAPI_CALL(env, napi_create_reference(env, argv[0], 1, &ref))
+                stream = std::make_shared<MemoryStream>(static_cast<byte *>(data), length, writable,
+                                                        [env, ref]() { napi_delete_reference(env, ref); });
+            } else if (data != nullptr) {
+                stream->write(data, 0, length);
+            }
+        }
+    }
+//    napi_wrap(env, _this, MakePtr(stream), JSDisposed, nullptr, nullptr);
+//    return _this;
+    return JSBind(env, _this, stream);
+}
+
+napi_value MemoryStream::JSToArrayBuffer(napi_env env, napi_callback_info info) {
+    GET_JS_INFO(1)
+    void *data = nullptr;
+    napi_value buffer = nullptr;
+    long length = stream->getLength();
+    long offset = 0;
+    if (argc > 0) {
+        getToArrayBufferOptions(env, argv[0], &offset, &length);
+    }
+    NAPI_CALL(env, napi_create_arraybuffer(env, length, &data, &buffer));
+
+    // 分段存储时数据不连续，统一按位置读出
+    stream->readAt(offset, data, 0, length);
+    return buffer;
+}
+
+/**
+ * 把内部缓冲区直接交给js作为ArrayBuffer，不拷贝数据，调用后流被关闭
+ */
+napi_value MemoryStream::JSDetachToArrayBuffer(napi_env env, napi_callback_info info) {
+    GET_JS_INFO(0)
+    napi_value buffer = nullptr;
+    long length = 0;
+    long capacity = 0;
+    byte *data = nullptr;
+    try {
+        data = static_cast<MemoryStream *>(stream.get())->detach(&length, &capacity);
+    } catch (const std::exception &e) {
+        napi_throw_error(env, ClassName.c_str(), e.what());
+        return nullptr;
+    }
+    // 分配大小决定了释放方式，通过hint带给finalizer
+    napi_status status = napi_create_external_arraybuffer(
+        env, data, length,
+        [](napi_env env, void *data, void *hint) {
+            jemoc_stream::PageAllocator::deallocate(static_cast<byte *>(data), reinterpret_cast<size_t>(hint));
+        },
+        reinterpret_cast<void *>(static_cast<size_t>(capacity)), &buffer);
+    if (status != napi_ok) {
+        jemoc_stream::PageAllocator::deallocate(data, capacity);
+        napi_throw_error(env, ClassName.c_str(), "create external arraybuffer failed");
+        return nullptr;
+    }
+    return buffer;
+}
+
+napi_value MemoryStream::JSGetCapacity(napi_env env, napi_callback_info info) {
+    GET_JS_INFO(0)
+    RETURN_NAPI_VALUE(napi_create_int64, static_cast<MemoryStream *>(stream.get())->getCapacity());
+}
+
+napi_value MemoryStream::JSSetCapacity(napi_env env, napi_callback_info info) {
+    GET_JS_INFO(1)
+    long capacity = getLong(env, argv[0]);
+    if (capacity < 0 || capacity < stream->getPosition()) {
+        napi_throw_range_error(env, "MemoryStream::setCapacity", "capacity is out of range");
+    }
+    try {
+        static_cast<MemoryStream *>(stream.get())->setCapacity(capacity);
+    } catch (const std::exception &e) {
+        napi_throw_error(env, ClassName.c_str(), e.what());
+    }
+    return nullptr;
+}
+
+napi_value MemoryStream::JSGetChunked(napi_env env, napi_callback_info info) {
+    GET_JS_INFO(0)
+    RETURN_NAPI_VALUE(napi_get_boolean, static_cast<MemoryStream *>(stream.get())->isChunked());
+}
+
+napi_value MemoryStream::JSGetChunkSize(napi_env env, napi_callback_info info) {
+    GET_JS_INFO(0)
+    RETURN_NAPI_VALUE(napi_create_int64, static_cast<MemoryStream *>(stream.get())->getChunkSize());
+}
+
+//void MemoryStream::JSDisposed(napi_env env, void *data, void *hint) {
+//    MemoryStream *stream = static_cast<MemoryStream *>(data);
+//    stream->close();
+//    delete stream;
+//}
+
+
+void MemoryStream::Export(napi_env env, napi_value exports) {
+    napi_property_descriptor desc[] = {
+//        DEFINE_NAPI_ISTREAM_PROPERTY((void *)ClassName.c_str()),
+        DEFINE_NAPI_FUNCTION("capacity", nullptr, JSGetCapacity, JSSetCapacity, nullptr),
+        DEFINE_NAPI_FUNCTION("toArrayBuffer", JSToArrayBuffer, nullptr, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("detachToArrayBuffer", JSDetachToArrayBuffer, nullptr, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("chunked", nullptr, JSGetChunked, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("chunkSize", nullptr, JSGetChunkSize, nullptr, nullptr),
+    };
+    napi_value napi_cons = nullptr;
+    napi_define_class(env, ClassName.c_str(), NAPI_AUTO_LENGTH, JSConstructor, nullptr, sizeof(desc) / sizeof(desc[0]),
+                      desc, &napi_cons);
+//    napi_create_reference(env, napi_cons, 1, &cons);
+    Extends(env, napi_cons);
+
+    napi_set_named_property(env, exports, ClassName.c_str(), napi_cons);
+}
@@ -0,0 +1,115 @@
+//
+// Created on 2025/3/7.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#include "binding/StreamBinding.h"
+#include "stream/ReadAheadStream.h"
+
+std::string ReadAheadStream::ClassName = "ReadAheadStream";
+
+/**
+ * readBlock交给js的块，ArrayBuffer被回收时把块归还给流
+ */
+struct ReadAheadBlockHolder {
+    std::shared_ptr<IStream> stream;
+    std::unique_ptr<ReadAheadStream::Block> block;
+};
+
+/**
+ * 构造函数：new ReadAheadStream(stream, {blockSize?: number, depth?: number, maxDepth?: number, leaveOpen?: boolean})
+ */
+napi_value ReadAheadStream::JSConstructor(napi_env env, napi_callback_info info) {
+    GET_JS_INFO_WITHOUT_STREAM(2)
+    std::shared_ptr<IStream> stream = IStream::GetStream(env, argv[0]);
+    if (!stream) {
+        napi_throw_type_error(env, ClassName.c_str(), "invalid stream");
+        return nullptr;
+    }
+    if (stream->isClose() || !stream->getCanRead()) {
+        napi_throw_error(env, ClassName.c_str(), "stream not readable");
+        return nullptr;
+    }
+    long blockSize = 64 * 1024;
+    int depth = 2;
+    int maxDepth = 8;
+    bool leaveOpen = false;
+    napi_valuetype type;
+    NAPI_CALL(env, napi_typeof(env, argv[1], &type))
+    if (type == napi_object) {
+        napi_value val;
+        NAPI_CALL(env, napi_get_named_property(env, argv[1], "blockSize", &val))
+        NAPI_CALL(env, napi_typeof(env, val, &type))
+        if (type == napi_number)
+            blockSize = getLong(env, val);
+        NAPI_CALL(env, napi_get_named_property(env, argv[1], "depth", &val))
+        NAPI_CALL(env, napi_typeof(env, val, &type))
+        if (type == napi_number)
+            depth = getInt(env, val);
+        NAPI_CALL(env, napi_get_named_property(env, argv[1], "maxDepth", &val))
+        NAPI_CALL(env, napi_typeof(env, val, &type))
+        if (type == napi_number)
+            maxDepth = getInt(env, val);
+        NAPI_CALL(env, napi_get_named_property(env, argv[1], "leaveOpen", &val))
+        NAPI_CALL(env, napi_typeof(env, val, &type))
+        if (type == napi_boolean) {
+            NAPI_CALL(env, napi_get_value_bool(env, val, &leaveOpen))
+        }
+    }
+    if (blockSize <= 0 || depth <= 0) {
+        napi_throw_range_error(env, ClassName.c_str(), "blockSize and depth must be larger than zero");
+        return nullptr;
+    }
+    std::shared_ptr<IStream> readAhead =
+        std::make_shared<ReadAheadStream>(stream, blockSize, depth, maxDepth, leaveOpen);
+    return JSBind(env, _this, readAhead);
+}
+
+/**
+ * 返回下一个预读块，不拷贝数据，流结束时返回undefined
+ */
+napi_value ReadAheadStream::JSReadBlock(napi_env env, napi_callback_info info) {
+    GET_JS_INFO(0)
+    ReadAheadStream *readAhead = static_cast<ReadAheadStream *>(stream.get());
+    napi_value result = nullptr;
+    try {
+        std::unique_ptr<Block> block = readAhead->takeBlock();
+        if (block == nullptr) {
+            napi_get_undefined(env, &result);
+            return result;
+        }
+        void *data = block->data.get() + block->offset;
+        size_t length = block->length - block->offset;
+        ReadAheadBlockHolder *holder = new ReadAheadBlockHolder{stream, std::move(block)};
+        NAPI_CALL(env, napi_create_external_arraybuffer(
+                           env, data, length,
+                           [](napi_env env, void *data, void *hint) {
+                               ReadAheadBlockHolder *holder = static_cast<ReadAheadBlockHolder *>(hint);
+                               static_cast<ReadAheadStream *>(holder->stream.get())->recycle(std::move(holder->block));
+                               delete holder;
+                           },
+                           holder, &result))
+    } catch (const std::exception &e) {
+        napi_throw_error(env, ClassName.c_str(), e.what());
+        return nullptr;
+    }
+    return result;
+}
+
+napi_value ReadAheadStream::JSGetDepth(napi_env env, napi_callback_info info) {
+    GET_JS_INFO(0)
+    RETURN_NAPI_VALUE(napi_create_int32, static_cast<ReadAheadStream *>(stream.get())->getDepth())
+}
+
+void ReadAheadStream::Export(napi_env env, napi_value exports) {
+    napi_property_descriptor desc[] = {
+        DEFINE_NAPI_FUNCTION("readBlock", JSReadBlock, nullptr, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("depth", nullptr, JSGetDepth, nullptr, nullptr),
+    };
+    napi_value napi_cons = nullptr;
+    NAPI_CALL(env, napi_define_class(env, ClassName.c_str(), NAPI_AUTO_LENGTH, JSConstructor, nullptr,
+                                     sizeof(desc) / sizeof(desc[0]), desc, &napi_cons))
+    Extends(env, napi_cons);
+    NAPI_CALL(env, napi_set_named_property(env, exports, ClassName.c_str(), napi_cons))
+}
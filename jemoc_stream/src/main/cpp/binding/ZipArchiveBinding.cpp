@@ -0,0 +1,297 @@
+//
+// Created on 2025/1/11.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#include "binding/StreamBinding.h"
+#include "deflate/ParallelDeflater.h"
+#include "zip/ZipArchive.h"
+#include "zip/ZipArchiveEntry.h"
+
+#ifndef ZIPARCHIVE_NAPI_FUNCTION
+#define ZIPARCHIVE_NAPI_FUNCTION
+
+#define GET_ZIPARCHIVE_INFO(number)                                                                                    \
+    napi_value argv[number];                                                                                           \
+    size_t argc = number;                                                                                              \
+    napi_value _this = nullptr;                                                                                        \
+    NAPI_CALL(env, napi_get_cb_info(env, info, &argc, argv, &_this, nullptr))                                          \
+    ZipArchive *archive = getZipArchive(env, _this);
+
+
+std::string ZipArchive::ClassName = "ZipArchive";
+napi_ref ZipArchive::cons = nullptr;
+
+void ZipArchive::close(napi_env env) {
+    close();
+    for (auto entry = m_entries.begin(); entry != m_entries.end(); entry++) {
+        (*entry)->releaseJSEntry(env);
+//         delete (*entry);
+    }
+    m_entries.clear();
+    m_entriesDictionary.clear();
+}
+
+ZipArchive *ZipArchive::getZipArchive(napi_env env, napi_value value) {
+    napi_valuetype type;
+    NAPI_CALL(env, napi_typeof(env, value, &type));
+    if (type == napi_undefined)
+        napi_throw_error(env, "ZipArchive", "archive is null");
+
+    void *result = nullptr;
+    NAPI_CALL(env, napi_unwrap(env, value, &result))
+    if (result == nullptr)
+        napi_throw_error(env, "ZipArchive", "archive is null");
+    return static_cast<ZipArchive *>(result);
+}
+
+/**
+ * ZipArchiveOption: {mode?: ZipArchiveMode, leaveOpen?: bool, password?: string)
+ * constructor(stream: IStream, option?: ZipArchiveOption)
+ * constructor(path: string, option?: ZipArchiveOption)
+ */
+napi_value ZipArchive::JSConstructor(napi_env env, napi_callback_info info) {
+    GET_JS_INFO_WITHOUT_STREAM(2)
+    napi_valuetype type;
+    ZipArchive *zip = nullptr;
+    bool leaveOpen = false;
+    int mode = ZipArchiveMode_Read;
+    std::string passwd;
+
+    NAPI_CALL(env, napi_typeof(env, argv[1], &type))
+
+    if (type == napi_string) {
+        passwd = getString(env, argv[1]);
+
+    } else if (type == napi_object) {
+        napi_value value = nullptr;
+
+        // 获取leaveOpen
+        NAPI_CALL(env, napi_get_named_property(env, argv[1], "leaveOpen", &value))
+        NAPI_CALL(env, napi_typeof(env, value, &type));
+        if (type == napi_boolean) {
+            NAPI_CALL(env, napi_get_value_bool(env, value, &leaveOpen));
+        }
+
+        // 获取ZipArchiveMode
+        NAPI_CALL(env, napi_get_named_property(env, argv[1], "mode", &value))
+        NAPI_CALL(env, napi_typeof(env, value, &type))
+        if (type == napi_number) {
+            NAPI_CALL(env, napi_get_value_int32(env, value, &mode));
+        }
+
+        // 获取password
+        NAPI_CALL(env, napi_get_named_property(env, argv[1], "password", &value))
+        NAPI_CALL(env, napi_typeof(env, value, &type))
+        if (type == napi_string) {
+            passwd = getString(env, value);
+        }
+    }
+
+    // 根据第一参数决定构造函数
+    NAPI_CALL(env, napi_typeof(env, argv[0], &type));
+    try {
+        if (napi_string == type) {
+            std::string path = getString(env, argv[0]);
+            zip = new ZipArchive(path, ZipArchiveMode(mode), passwd);
+        } else {
+            std::shared_ptr<IStream> stream = IStream::GetStream(env, argv[0]);
+            if (stream == nullptr) {
+                napi_value js_fd = nullptr;
+                napi_value js_offset = nullptr;
+                napi_value js_length = nullptr;
+                NAPI_CALL(env, napi_get_named_property(env, argv[0], "fd", &js_fd))
+                NAPI_CALL(env, napi_get_named_property(env, argv[0], "offset", &js_offset))
+                NAPI_CALL(env, napi_get_named_property(env, argv[0], "length", &js_length))
+                int fd = 0;
+                long offset = 0;
+                long length = 0;
+                NAPI_CALL(env, napi_get_value_int32(env, js_fd, &fd))
+                NAPI_CALL(env, napi_get_value_int64(env, js_offset, &offset))
+                NAPI_CALL(env, napi_get_value_int64(env, js_length, &length))
+                zip = new ZipArchive(fd, offset, length, passwd);
+            } else {
+                zip = new ZipArchive(stream, ZipArchiveMode(mode), passwd, leaveOpen);
+            }
+//                 napi_throw_error(env, ClassName.c_str(), "invalid argument stream, stream is null");
+        }
+    } catch (const std::ios::failure &e) {
+        napi_throw_error(env, ClassName.c_str(), e.what());
+        return nullptr;
+    }
+
+    if (zip == nullptr) {
+        napi_throw_error(env, ClassName.c_str(), "create ziparchive failed.");
+        return nullptr;
+    }
+
+    NAPI_CALL(env, napi_wrap(env, _this, zip, JSDispose, nullptr, nullptr));
+
+    return _this;
+}
+
+void ZipArchive::Export(napi_env env, napi_value exports) {
+    napi_property_descriptor desc[] = {
+        DEFINE_NAPI_FUNCTION("comment", nullptr, JSGetComment, JSSetComment, nullptr),
+        DEFINE_NAPI_FUNCTION("getEntry", JSGetEntry, nullptr, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("entries", nullptr, JSGetEntries, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("mode", nullptr, JSGetMode, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("createEntry", JSCreateEntry, nullptr, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("close", JSClose, nullptr, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("isClosed", nullptr, JSGetIsClosed, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("entryNames", nullptr, JSGetEntryNames, nullptr, nullptr),
+    };
+    napi_value napi_cons = nullptr;
+    NAPI_CALL(env, napi_define_class(env, ClassName.c_str(), NAPI_AUTO_LENGTH, JSConstructor, nullptr,
+                                     sizeof(desc) / sizeof(desc[0]), desc, &napi_cons))
+    NAPI_CALL(env, napi_set_named_property(env, exports, ClassName.c_str(), napi_cons))
+    NAPI_CALL(env, napi_create_reference(env, napi_cons, 1, &cons))
+}
+
+napi_value ZipArchive::JSGetComment(napi_env env, napi_callback_info info) {
+    GET_ZIPARCHIVE_INFO(0)
+    napi_value result = nullptr;
+    NAPI_CALL(env, napi_create_string_utf8(env, archive->getComment().c_str(), NAPI_AUTO_LENGTH, &result))
+    return result;
+}
+
+napi_value ZipArchive::JSSetComment(napi_env env, napi_callback_info info) {
+    GET_ZIPARCHIVE_INFO(1);
+    if (argc < 1)
+        napi_throw_error(env, "ZipArchive", "set comment invalid argument");
+    napi_valuetype type;
+    NAPI_CALL(env, napi_typeof(env, argv[0], &type))
+    if (type != napi_string)
+        napi_throw_error(env, "ZipArchive", "set comment invalid argument");
+
+    std::string comment = getString(env, argv[0]);
+    archive->setComment(comment);
+    return nullptr;
+}
+
+napi_value ZipArchive::getEntries(napi_env env) {
+    napi_value arr = nullptr;
+    std::vector<ZipArchiveEntry *> list = getEntries();
+    napi_value jsValue = nullptr;
+    NAPI_CALL(env, napi_create_array_with_length(env, list.size(), &arr))
+    for (int i = 0; i < list.size(); i++) {
+        jsValue = list[i]->getJSEntry(env);
+        NAPI_CALL(env, napi_set_element(env, arr, i, jsValue))
+    }
+    return arr;
+}
+
+napi_value ZipArchive::JSGetEntries(napi_env env, napi_callback_info info) {
+    GET_ZIPARCHIVE_INFO(0);
+    return archive->getEntries(env);
+}
+
+napi_value ZipArchive::JSGetMode(napi_env env, napi_callback_info info) {
+    GET_ZIPARCHIVE_INFO(0)
+    napi_value result = nullptr;
+    NAPI_CALL(env, napi_create_int32(env, archive->getMode(), &result))
+    return result;
+}
+
+napi_value ZipArchive::getEntry(napi_env env, const std::string &entryName) {
+    ZipArchiveEntry *entry = getEntry(entryName);
+
+    if (entry == nullptr)
+        return nullptr;
+
+    auto it = m_entriesDictionary.find(entryName);
+    if (it == m_entriesDictionary.end())
+        return nullptr;
+
+    return it->second->getJSEntry(env);
+}
+
+
+napi_value ZipArchive::JSGetEntry(napi_env env, napi_callback_info info) {
+    GET_ZIPARCHIVE_INFO(1)
+    std::string entryName = getString(env, argv[0]);
+    return archive->getEntry(env, entryName);
+}
+
+
+napi_value ZipArchive::createEntry(napi_env env, const std::string &entryName, int compressionLevel) {
+    ZipArchiveEntry *entry = createEntry(entryName, compressionLevel);
+    if (entry == nullptr)
+        return nullptr;
+    return entry->getJSEntry(env);
+}
+
+/**
+ * createEntry(name: string, level?: number, options?: {threads?: number, blockSize?: number})
+ */
+napi_value ZipArchive::JSCreateEntry(napi_env env, napi_callback_info info) {
+    GET_ZIPARCHIVE_INFO(3)
+    std::string entryName = getString(env, argv[0]);
+    int level = 0;
+    napi_valuetype type;
+    NAPI_CALL(env, napi_typeof(env, argv[1], &type))
+    if (type == napi_number) {
+        NAPI_CALL(env, napi_get_value_int32(env, argv[1], &level))
+    }
+    int threads = 1;
+    int64_t blockSize = 0;
+    NAPI_CALL(env, napi_typeof(env, argv[2], &type))
+    if (type == napi_object) {
+        napi_value value = nullptr;
+        GET_OBJ(argv[2], "threads", napi_get_value_int32, threads)
+        GET_OBJ(argv[2], "blockSize", napi_get_value_int64, blockSize)
+    }
+    if (threads > ParallelDeflater::MaxThreads) {
+        napi_throw_range_error(env, ClassName.c_str(), "threads must not be greater than 64");
+        return nullptr;
+    }
+    if (blockSize < 0 || blockSize > static_cast<int64_t>(ParallelDeflater::MaxBlockSize)) {
+        napi_throw_range_error(env, ClassName.c_str(), "blockSize must be between 0 and 64MB");
+        return nullptr;
+    }
+    ZipArchiveEntry *entry = archive->createEntry(entryName, level);
+    if (entry == nullptr)
+        return nullptr;
+    entry->setDeflateThreads(threads, blockSize);
+    return entry->getJSEntry(env);
+}
+
+napi_value ZipArchive::JSClose(napi_env env, napi_callback_info info) {
+    GET_ZIPARCHIVE_INFO(0)
+    archive->close(env);
+    void *result = nullptr;
+    NAPI_CALL(env, napi_remove_wrap(env, _this, &result))
+    return nullptr;
+}
+
+void ZipArchive::JSDispose(napi_env env, void *data, void *hint) {
+    ZipArchive *archive = static_cast<ZipArchive *>(data);
+    archive->close(env);
+    delete archive;
+}
+
+
+napi_value ZipArchive::JSGetIsClosed(napi_env env, napi_callback_info info) {
+    GET_ZIPARCHIVE_INFO(0)
+    bool value = archive == nullptr || archive->isClosed();
+    napi_value result = nullptr;
+    NAPI_CALL(env, napi_get_boolean(env, value, &result))
+    return result;
+}
+
+napi_value ZipArchive::JSGetEntryNames(napi_env env, napi_callback_info info) {
+    GET_ZIPARCHIVE_INFO(0)
+    auto entries = archive->getEntries();
+    napi_value result = nullptr;
+    NAPI_CALL(env, napi_create_array_with_length(env, entries.size(), &result))
+    napi_value jsName;
+    for (int i = 0; i < entries.size(); i++) {
+        auto name = entries[i]->getFullName();
+        NAPI_CALL(env, napi_create_string_utf8(env, name.c_str(), name.size(), &jsName));
+        NAPI_CALL(env, napi_set_element(env, result, i, jsName));
+    }
+    return result;
+}
+
+#endif // ZIPARCHIVE_NAPI_FUNCTION
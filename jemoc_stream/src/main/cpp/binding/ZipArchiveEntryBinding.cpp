@@ -0,0 +1,304 @@
+//
+// Created on 2025/1/11.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#include "binding/StreamBinding.h"
+#include "zip/ZipArchive.h"
+#include "zip/ZipArchiveEntry.h"
+
+#ifndef DEFINE_ZipArchiveEntry_NAPI
+#define DEFINE_ZipArchiveEntry_NAPI
+#define GET_ZIPARCHIVE_ENTRY_INFO(number)                                                                              \
+    napi_value argv[number];                                                                                           \
+    size_t argc = number;                                                                                              \
+    napi_value _this = nullptr;                                                                                        \
+    NAPI_CALL(env, napi_get_cb_info(env, info, &argc, argv, &_this, nullptr))
+
+#define GET_ZIPARCHIVE_ENTRY_INFO_WITH_ENTRY(number)                                                                   \
+    GET_ZIPARCHIVE_ENTRY_INFO(number)                                                                                  \
+    ZipArchiveEntry *entry = getEntry(env, _this);                                                                     \
+    if (entry == nullptr)                                                                                              \
+        napi_throw_error(env, "ZipArchiveEntry", "entry is null");
+
+
+std::string ZipArchiveEntry::ClassName = "ZipArchiveEntry";
+napi_ref ZipArchiveEntry::cons = nullptr;
+
+void ZipArchiveEntry::Export(napi_env env, napi_value exports) {
+    napi_property_descriptor desc[] = {
+        DEFINE_NAPI_FUNCTION("open", JSOpen, nullptr, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("extractToFile", JSExtractToFile, nullptr, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("isEncrypted", nullptr, JSGetIsEncrypted, JSSetIsEncrypted, nullptr),
+        DEFINE_NAPI_FUNCTION("compressionLevel", nullptr, JSGetCompressionLevel, JSSetCompressionLevel, nullptr),
+        DEFINE_NAPI_FUNCTION("fileComment", nullptr, JSGetFileComment, JSSetFileComment, nullptr),
+        DEFINE_NAPI_FUNCTION("fullName", nullptr, JSGetFullName, JSSetFullName, nullptr),
+        DEFINE_NAPI_FUNCTION("compressionMethod", nullptr, JSGetCompressionMethod, JSSetCompressionMethod, nullptr),
+        DEFINE_NAPI_FUNCTION("lastModifier", nullptr, JSGetLastModifier, JSSetLastModifier, nullptr),
+        DEFINE_NAPI_FUNCTION("isOpened", nullptr, JSGetIsOpened, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("crc32", nullptr, JSGetCRC, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("delete", JSDelete, nullptr, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("isDeleted", nullptr, JSGetIsDeleted, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("uncompressedSize", nullptr, JSGetUnCompressedSize, nullptr, nullptr),
+        DEFINE_NAPI_FUNCTION("compressedSize", nullptr, JSGetCompressedSize, nullptr, nullptr)
+
+    };
+    napi_value napi_cons = nullptr;
+    NAPI_CALL(env, napi_define_class(env, ClassName.c_str(), NAPI_AUTO_LENGTH, JSConstructor, nullptr,
+                                     sizeof(desc) / sizeof(desc[0]), desc, &napi_cons))
+    NAPI_CALL(env, napi_set_named_property(env, exports, ClassName.c_str(), napi_cons))
+    NAPI_CALL(env, napi_create_reference(env, napi_cons, 1, &cons))
+}
+
+napi_value ZipArchiveEntry::JSConstructor(napi_env env, napi_callback_info info) {
+    GET_ZIPARCHIVE_ENTRY_INFO(0)
+    return _this;
+}
+
+
+ZipArchiveEntry *ZipArchiveEntry::getEntry(napi_env env, napi_value value) {
+    napi_valuetype type;
+    NAPI_CALL(env, napi_typeof(env, value, &type))
+    if (napi_undefined == type)
+        return nullptr;
+    void *result = nullptr;
+    napi_unwrap(env, value, &result);
+    return static_cast<ZipArchiveEntry *>(result);
+}
+
+void ZipArchiveEntry::JSDispose(napi_env env, void *data, void *hint) {
+    ZipArchiveEntry *entry = static_cast<ZipArchiveEntry *>(data);
+    delete entry;
+    entry = nullptr;
+}
+
+napi_value ZipArchiveEntry::open(napi_env env, std::shared_ptr<DeflateIndex> index) {
+    std::shared_ptr<IStream> stream = open(index);
+//    openingStream = stream;
+    napi_value result = IStream::JSCreateInterface(env, stream);
+//     NAPI_CALL(env, napi_create_reference(env, result, 1, &jsOpeningStream))
+    return result;
+}
+
+napi_value ZipArchiveEntry::JSOpen(napi_env env, napi_callback_info info) {
+    GET_ZIPARCHIVE_ENTRY_INFO_WITH_ENTRY(1)
+    std::shared_ptr<DeflateIndex> index = DeflateIndex::GetIndex(env, argv[0]);
+    try {
+        return entry->open(env, index);
+    } catch (const std::exception &e) {
+        napi_throw_error(env, "ZipArchiveEntry", (std::string("open failed: ") + e.what()).c_str());
+    }
+    return nullptr;
+}
+
+napi_value ZipArchiveEntry::JSExtractToFile(napi_env env, napi_callback_info info) {
+    GET_ZIPARCHIVE_ENTRY_INFO_WITH_ENTRY(1)
+    if (entry == nullptr)
+        return nullptr;
+    std::string path = getString(env, argv[0]);
+    try {
+        entry->extractToFile(path);
+    } catch (const std::exception &e) {
+        napi_throw_error(env, ClassName.c_str(), (std::string("extract failed: ") + e.what()).c_str());
+    }
+    return nullptr;
+}
+
+napi_value ZipArchiveEntry::getJSEntry(napi_env env) {
+    napi_value result = nullptr;
+    if (jsEntry != nullptr) {
+        NAPI_CALL(env, napi_get_reference_value(env, jsEntry, &result));
+    } else {
+        napi_value napi_cons = nullptr;
+        NAPI_CALL(env, napi_get_reference_value(env, cons, &napi_cons))
+        NAPI_CALL(env, napi_new_instance(env, napi_cons, 0, nullptr, &result))
+        napi_wrap(env, result, this, JSDispose, nullptr, &jsEntry);
+    }
+    return result;
+}
+
+void ZipArchiveEntry::releaseJSEntry(napi_env env) {
+    if (jsEntry == nullptr)
+        return;
+
+    napi_value value = nullptr;
+    NAPI_CALL(env, napi_get_reference_value(env, jsEntry, &value))
+    if (value == nullptr)
+        return;
+
+    uint ref_count = 0;
+    NAPI_CALL(env, napi_reference_unref(env, jsEntry, &ref_count))
+    if (ref_count > 0) {
+        NAPI_CALL(env, napi_delete_reference(env, jsEntry))
+    }
+    void *_this = nullptr;
+    NAPI_CALL(env, napi_remove_wrap(env, value, &_this))
+
+
+    jsEntry = nullptr;
+}
+
+napi_value ZipArchiveEntry::JSSetIsEncrypted(napi_env env, napi_callback_info info) {
+    GET_ZIPARCHIVE_ENTRY_INFO_WITH_ENTRY(1)
+    if (entry->m_archive->getMode() == ZipArchiveMode_Read)
+        napi_throw_error(env, ClassName.c_str(), "can not set isEncrypted in read mode.");
+    if (entry->m_everOpenedForWrite)
+        napi_throw_error(env, ClassName.c_str(), "can not set isEncrypted after open.");
+    bool isEncrypted = false;
+    NAPI_CALL(env, napi_get_value_bool(env, argv[0], &isEncrypted))
+    entry->setIsEncrypted(isEncrypted);
+    return nullptr;
+}
+
+napi_value ZipArchiveEntry::JSGetIsEncrypted(napi_env env, napi_callback_info info) {
+    GET_ZIPARCHIVE_ENTRY_INFO_WITH_ENTRY(0)
+    napi_value result = nullptr;
+    NAPI_CALL(env, napi_get_boolean(env, entry->getIsEncrypted(), &result))
+    return result;
+}
+
+napi_value ZipArchiveEntry::JSGetCompressionLevel(napi_env env, napi_callback_info info) {
+    GET_ZIPARCHIVE_ENTRY_INFO_WITH_ENTRY(0)
+    napi_value result = nullptr;
+    NAPI_CALL(env, napi_create_int32(env, entry->getCompressionLevel(), &result))
+    return result;
+}
+
+napi_value ZipArchiveEntry::JSSetCompressionLevel(napi_env env, napi_callback_info info) {
+    GET_ZIPARCHIVE_ENTRY_INFO_WITH_ENTRY(1)
+    if (entry->m_archive->getMode() == ZipArchiveMode_Read)
+        napi_throw_error(env, ClassName.c_str(), "can not set compression level in read mode.");
+    if (entry->m_everOpenedForWrite)
+        napi_throw_error(env, ClassName.c_str(), "can not set compression level after open.");
+    int level = 0;
+    NAPI_CALL(env, napi_get_value_int32(env, argv[0], &level))
+    entry->setCompressionLevel(CompressionLevel(level));
+    return nullptr;
+}
+
+napi_value ZipArchiveEntry::JSSetFileComment(napi_env env, napi_callback_info info) {
+    GET_ZIPARCHIVE_ENTRY_INFO_WITH_ENTRY(1)
+    if (entry->m_archive->getMode() == ZipArchiveMode_Read)
+        napi_throw_error(env, ClassName.c_str(), "can not set file comment in read mode.");
+    std::string comment = getString(env, argv[0]);
+    entry->setComment(comment);
+    return nullptr;
+}
+
+napi_value ZipArchiveEntry::JSGetFileComment(napi_env env, napi_callback_info info) {
+    GET_ZIPARCHIVE_ENTRY_INFO_WITH_ENTRY(1)
+    napi_value result = nullptr;
+    NAPI_CALL(env, napi_create_string_utf8(env, entry->getComment().c_str(), NAPI_AUTO_LENGTH, &result))
+    return result;
+}
+
+napi_value ZipArchiveEntry::JSGetFullName(napi_env env, napi_callback_info info) {
+    GET_ZIPARCHIVE_ENTRY_INFO_WITH_ENTRY(1)
+    napi_value result = nullptr;
+    NAPI_CALL(env, napi_create_string_utf8(env, entry->getFullName().c_str(), NAPI_AUTO_LENGTH, &result))
+    return result;
+}
+napi_value ZipArchiveEntry::JSSetFullName(napi_env env, napi_callback_info info) {
+    GET_ZIPARCHIVE_ENTRY_INFO_WITH_ENTRY(1)
+    if (entry->m_archive->getMode() == ZipArchiveMode_Read)
+        napi_throw_error(env, ClassName.c_str(), "can not set fullName in read mode.");
+    std::string name = getString(env, argv[0]);
+    entry->setFullName(name);
+    return nullptr;
+}
+napi_value ZipArchiveEntry::JSGetCompressionMethod(napi_env env, napi_callback_info info) {
+    GET_ZIPARCHIVE_ENTRY_INFO_WITH_ENTRY(0)
+    napi_value result = nullptr;
+    NAPI_CALL(env, napi_create_int32(env, entry->getCompressionMethod(), &result))
+    return result;
+}
+napi_value ZipArchiveEntry::JSSetCompressionMethod(napi_env env, napi_callback_info info) {
+    GET_ZIPARCHIVE_ENTRY_INFO_WITH_ENTRY(1)
+    if (entry->m_archive->getMode() == ZipArchiveMode_Read)
+        napi_throw_error(env, ClassName.c_str(), "can not set compression method in read mode.");
+    if (entry->m_everOpenedForWrite)
+        napi_throw_error(env, ClassName.c_str(), "can not set compression method after open.");
+    int method = 0;
+    NAPI_CALL(env, napi_get_value_int32(env, argv[0], &method))
+    entry->setCompressionMethod(CompressionMethod(method));
+    return nullptr;
+}
+napi_value ZipArchiveEntry::JSSetLastModifier(napi_env env, napi_callback_info info) {
+    GET_ZIPARCHIVE_ENTRY_INFO_WITH_ENTRY(1)
+    double timestamp = 0;
+    NAPI_CALL(env, napi_get_date_value(env, argv[0], &timestamp))
+    entry->setLastModifier(timestamp);
+    return nullptr;
+}
+
+napi_value ZipArchiveEntry::JSGetLastModifier(napi_env env, napi_callback_info info) {
+    GET_ZIPARCHIVE_ENTRY_INFO_WITH_ENTRY(0)
+    napi_value result = nullptr;
+    NAPI_CALL(env, napi_create_date(env, entry->getLastModifier(), &result))
+    return result;
+}
+
+napi_value ZipArchiveEntry::JSGetIsOpened(napi_env env, napi_callback_info info) {
+    GET_ZIPARCHIVE_ENTRY_INFO_WITH_ENTRY(0)
+    napi_value result = nullptr;
+    NAPI_CALL(env, napi_get_boolean(env, entry->m_everOpenedForWrite, &result))
+    return result;
+}
+
+napi_value ZipArchiveEntry::JSGetCRC(napi_env env, napi_callback_info info) {
+    GET_ZIPARCHIVE_ENTRY_INFO_WITH_ENTRY(0)
+    napi_value result = nullptr;
+    NAPI_CALL(env, napi_create_uint32(env, entry->crc, &result))
+    return result;
+}
+
+void ZipArchiveEntry::Delete(napi_env env) {
+    Delete();
+    releaseJSEntry(env);
+}
+
+napi_value ZipArchiveEntry::JSDelete(napi_env env, napi_callback_info info) {
+    GET_ZIPARCHIVE_ENTRY_INFO_WITH_ENTRY(0)
+    try {
+        entry->Delete(env);
+    } catch (const std::exception &e) {
+        napi_throw_error(env, ClassName.c_str(), e.what());
+    }
+    return nullptr;
+}
+
+napi_value ZipArchiveEntry::JSGetIsDeleted(napi_env env, napi_callback_info info) {
+    GET_ZIPARCHIVE_ENTRY_INFO(0)
+    ZipArchiveEntry *entry = getEntry(env, _this);
+    bool value = entry == nullptr;
+    napi_value result = nullptr;
+    NAPI_CALL(env, napi_get_boolean(env, value, &result))
+    return result;
+}
+
+napi_value ZipArchiveEntry::JSGetUnCompressedSize(napi_env env, napi_callback_info info) {
+    GET_ZIPARCHIVE_ENTRY_INFO_WITH_ENTRY(0)
+    napi_value result = nullptr;
+    long size = 0;
+    entry->getArchive()->getMode();
+    if (entry->getArchive()->getMode() != ZipArchiveMode_Create && !entry->m_everOpenedForWrite) {
+        size = entry->uncompressedSize;
+    }
+    NAPI_CALL(env, napi_create_int64(env, size, &result));
+    return result;
+}
+napi_value ZipArchiveEntry::JSGetCompressedSize(napi_env env, napi_callback_info info) {
+    GET_ZIPARCHIVE_ENTRY_INFO_WITH_ENTRY(0)
+    napi_value result = nullptr;
+    long size = 0;
+    entry->getArchive()->getMode();
+    if (entry->getArchive()->getMode() != ZipArchiveMode_Create && !entry->m_everOpenedForWrite) {
+        size = entry->compressedSize;
+    }
+    NAPI_CALL(env, napi_create_int64(env, size, &result));
+    return result;
+}
+
+
+#endif // DEFINE_ZipArchiveEntry_NAPI
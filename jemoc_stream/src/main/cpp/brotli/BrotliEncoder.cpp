@@ -9,6 +9,16 @@
 
 BrotliEncoder::BrotliEncoder(const BrotliConfig &config) : m_encoder(nullptr) {
     m_encoder = BrotliEncoderCreateInstance(nullptr, nullptr, nullptr);
+    if (m_encoder == nullptr)
+        return;
+    // 超出范围的值由brotli在开始压缩时修正
+    BrotliEncoderSetParameter(m_encoder, BROTLI_PARAM_QUALITY, config.quality);
+    BrotliEncoderSetParameter(m_encoder, BROTLI_PARAM_LGWIN, config.lgWin);
+    BrotliEncoderSetParameter(m_encoder, BROTLI_PARAM_MODE, config.mode);
+    if (config.lgBlock > 0)
+        BrotliEncoderSetParameter(m_encoder, BROTLI_PARAM_LGBLOCK, config.lgBlock);
+    if (config.largeWindow)
+        BrotliEncoderSetParameter(m_encoder, BROTLI_PARAM_LARGE_WINDOW, BROTLI_TRUE);
 }
 BrotliEncoder::~BrotliEncoder() {
     if (m_encoder != nullptr) {
@@ -29,10 +29,7 @@ shared_ptr<uint8_t> DynamicBufferPool::acquire(size_t size) {
     
     // Allocate new chunk
     size_t allocSize = std::max(size, chunkSize_);
-    auto memory = std::shared_ptr<uint8_t>(
-        new uint8_t[allocSize],
-        [](uint8_t* p) { delete[] p; }
-    );
+    auto memory = allocateAlignedBuffer(allocSize);
     
     chunks_.push_back({memory, allocSize, true});
     chunkMap_[memory.get()] = &chunks_.back();
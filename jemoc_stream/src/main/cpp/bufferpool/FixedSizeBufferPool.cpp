@@ -28,7 +28,7 @@ shared_ptr<uint8_t> FixedSizeBufferPool::acquire(size_t size) {
     }
 
     if (usedList_.size() + freeList_.size() < maxBuffers_) {
-        auto buffer = std::shared_ptr<uint8_t>(new uint8_t[bufferSize_], [](uint8_t *p) { delete[] p; });
+        auto buffer = allocateAlignedBuffer(bufferSize_);
         usedList_.push_back(buffer);
         updateStats(true);
         return buffer;
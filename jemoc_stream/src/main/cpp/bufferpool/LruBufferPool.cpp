@@ -7,8 +7,6 @@
 
 namespace jemoc_stream {
 
-std::string LruBufferPool::ClassName = "LruBufferPool";
-
 LruBufferPool::LruBufferPool(size_t maxSize) : maxSize_(maxSize) {}
 
 LruBufferPool::~LruBufferPool() = default;
@@ -38,7 +36,7 @@ shared_ptr<uint8_t> LruBufferPool::acquire(size_t size) {
     }
 
     // Allocate new buffer
-    auto buffer = std::shared_ptr<uint8_t>(static_cast<uint8_t *>(malloc(size)), [](uint8_t *ptr) { free(ptr); });
+    auto buffer = allocateAlignedBuffer(size);
 
     // Add to buffer map
     bufferMap_[buffer.get()] = {buffer, size};
@@ -64,35 +62,4 @@ void LruBufferPool::release(shared_ptr<uint8_t> buffer) {
     lruList_.push_front(buffer);
 }
 
-napi_value LruBufferPool::JSConstructor(napi_env env, napi_callback_info info) {
-    napi_value _this = nullptr;
-    size_t argc = 1;
-    napi_value argv[1];
-    NAPI_CALL(env, napi_get_cb_info(env, info, &argc, argv, &_this, nullptr))
-    long size = 0;
-    napi_valuetype type;
-    NAPI_CALL(env, napi_typeof(env, argv[0], &type))
-    if (type != napi_number) {
-        napi_throw_type_error(env, ClassName.c_str(), "size must be a number");
-        return nullptr;
-    }
-    NAPI_CALL(env, napi_get_value_int64(env, argv[0], &size))
-    if (size <= 0) {
-        napi_throw_range_error(env, ClassName.c_str(), "size must >= 0");
-        return nullptr;
-    }
-    LruBufferPool *pool = new LruBufferPool(size);
-    NAPI_CALL(env, napi_wrap(
-                       env, _this, pool, [](napi_env env, void *data, void *hint) {}, nullptr, nullptr))
-    return _this;
-}
-
-void LruBufferPool::Export(napi_env env, napi_value exports) {
-    napi_value js_cons;
-    NAPI_CALL(env,
-              napi_define_class(env, ClassName.c_str(), NAPI_AUTO_LENGTH, JSConstructor, nullptr, 0, nullptr, &js_cons))
-    Extends(env, js_cons);
-    NAPI_CALL(env, napi_set_named_property(env, exports, ClassName.c_str(), js_cons));
-}
-
 }
@@ -0,0 +1,66 @@
+//
+// Created on 2025/3/8.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#include "PageAllocator.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <sys/mman.h>
+
+namespace jemoc_stream {
+
+size_t PageAllocator::alignCapacity(size_t size) {
+    if (size >= HugePageThreshold)
+        return (size + HugePageSize - 1) & ~(HugePageSize - 1);
+    return alignPage(size);
+}
+
+static byte *mapPages(size_t size) {
+    void *buffer = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buffer == MAP_FAILED)
+        throw std::bad_alloc();
+#ifdef MADV_HUGEPAGE
+    if (size >= PageAllocator::HugePageThreshold)
+        madvise(buffer, size, MADV_HUGEPAGE);
+#endif
+    return static_cast<byte *>(buffer);
+}
+
+byte *PageAllocator::allocate(size_t size) {
+    if (isMapped(size))
+        return mapPages(size);
+    return new byte[std::max<size_t>(size, 1)];
+}
+
+byte *PageAllocator::reallocate(byte *buffer, size_t oldSize, size_t newSize, size_t used) {
+    if (buffer == nullptr)
+        return allocate(newSize);
+    if (isMapped(oldSize) && isMapped(newSize)) {
+        void *result = mremap(buffer, oldSize, newSize, MREMAP_MAYMOVE);
+        if (result == MAP_FAILED)
+            throw std::bad_alloc();
+#ifdef MADV_HUGEPAGE
+        if (newSize >= HugePageThreshold)
+            madvise(result, newSize, MADV_HUGEPAGE);
+#endif
+        return static_cast<byte *>(result);
+    }
+    byte *result = allocate(newSize);
+    memcpy(result, buffer, std::min(used, std::min(oldSize, newSize)));
+    deallocate(buffer, oldSize);
+    return result;
+}
+
+void PageAllocator::deallocate(byte *buffer, size_t size) {
+    if (buffer == nullptr)
+        return;
+    if (isMapped(size))
+        munmap(buffer, size);
+    else
+        delete[] buffer;
+}
+
+} // namespace jemoc_stream
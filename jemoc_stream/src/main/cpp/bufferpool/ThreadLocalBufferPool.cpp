@@ -18,7 +18,7 @@ shared_ptr<uint8_t> ThreadLocalBufferPool::acquire(size_t size) {
     thread_local std::shared_ptr<uint8_t> currentBuffer;
 
     if (!currentBuffer || localPool.empty()) {
-        currentBuffer = std::shared_ptr<uint8_t>(new uint8_t[bufferSize_], [](uint8_t *p) { delete[] p; });
+        currentBuffer = allocateAlignedBuffer(bufferSize_);
         localPool.push_back(currentBuffer);
     }
 
@@ -0,0 +1,155 @@
+//
+// Created on 2025/3/11.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#include "deflate/DeflateIndex.h"
+#include "zlib-ng.h"
+#include <algorithm>
+#include <cstring>
+
+// "JDIX"
+static constexpr uint32_t IndexMagic = 0x5849444a;
+static constexpr uint32_t IndexVersion = 1;
+
+DeflateIndex::DeflateIndex(uint64_t span) : m_span(span > 0 ? span : DefaultSpan) {}
+
+size_t DeflateIndex::getCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_points.size();
+}
+
+bool DeflateIndex::isComplete() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_complete;
+}
+
+long DeflateIndex::getLength() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_complete ? static_cast<long>(m_length) : -1;
+}
+
+bool DeflateIndex::needPoint(uint64_t output) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_complete)
+        return false;
+    uint64_t last = m_points.empty() ? 0 : m_points.back().output;
+    return output >= last + m_span;
+}
+
+void DeflateIndex::addPoint(AccessPoint point) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // 从较早的访问点重新读取时不重复记录
+    if (!m_points.empty() && point.output <= m_points.back().output)
+        return;
+    m_points.push_back(std::move(point));
+}
+
+void DeflateIndex::setComplete(uint64_t length) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_complete = true;
+    m_length = length;
+}
+
+const DeflateIndex::AccessPoint *DeflateIndex::find(uint64_t offset) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = std::upper_bound(m_points.begin(), m_points.end(), offset,
+                               [](uint64_t value, const AccessPoint &point) { return value < point.output; });
+    if (it == m_points.begin())
+        return nullptr;
+    return &*(it - 1);
+}
+
+template <typename T> static void put(std::vector<byte> &buffer, T value) {
+    size_t size = buffer.size();
+    buffer.resize(size + sizeof(T));
+    memcpy(buffer.data() + size, &value, sizeof(T));
+}
+
+template <typename T> static T take(IStream *stream) {
+    T value;
+    byte *p = reinterpret_cast<byte *>(&value);
+    size_t n = 0;
+    while (n < sizeof(T)) {
+        long bytesRead = stream->read(p, n, sizeof(T) - n);
+        if (bytesRead <= 0)
+            throw std::ios_base::failure("DeflateIndex: index data is truncated.");
+        n += bytesRead;
+    }
+    return value;
+}
+
+static void readFully(IStream *stream, byte *buffer, size_t count) {
+    size_t n = 0;
+    while (n < count) {
+        long bytesRead = stream->read(buffer, n, count - n);
+        if (bytesRead <= 0)
+            throw std::ios_base::failure("DeflateIndex: index data is truncated.");
+        n += bytesRead;
+    }
+}
+
+void DeflateIndex::writeTo(IStream *stream) const {
+    std::vector<byte> buffer;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    put<uint32_t>(buffer, IndexMagic);
+    put<uint32_t>(buffer, IndexVersion);
+    put<uint64_t>(buffer, m_span);
+    put<uint8_t>(buffer, m_complete);
+    put<uint64_t>(buffer, m_length);
+    put<uint64_t>(buffer, m_points.size());
+    stream->write(buffer.data(), 0, buffer.size());
+
+    std::vector<byte> compressed(zng_compressBound(WindowSize));
+    for (const AccessPoint &point : m_points) {
+        size_t compressedSize = compressed.size();
+        if (zng_compress2(compressed.data(), &compressedSize, point.window.data(), point.window.size(),
+                          Z_DEFAULT_COMPRESSION) != Z_OK)
+            throw std::ios_base::failure("DeflateIndex: failed to compress window.");
+        buffer.clear();
+        put<uint64_t>(buffer, point.output);
+        put<uint64_t>(buffer, point.input);
+        put<uint8_t>(buffer, point.bits);
+        put<uint8_t>(buffer, point.value);
+        put<uint32_t>(buffer, point.window.size());
+        put<uint32_t>(buffer, compressedSize);
+        buffer.insert(buffer.end(), compressed.begin(), compressed.begin() + compressedSize);
+        stream->write(buffer.data(), 0, buffer.size());
+    }
+}
+
+std::shared_ptr<DeflateIndex> DeflateIndex::ReadFrom(IStream *stream) {
+    if (take<uint32_t>(stream) != IndexMagic)
+        throw std::ios_base::failure("DeflateIndex: not a deflate index.");
+    if (take<uint32_t>(stream) != IndexVersion)
+        throw std::ios_base::failure("DeflateIndex: unsupported index version.");
+    auto index = std::make_shared<DeflateIndex>(take<uint64_t>(stream));
+    index->m_complete = take<uint8_t>(stream) != 0;
+    index->m_length = take<uint64_t>(stream);
+    uint64_t count = take<uint64_t>(stream);
+
+    std::vector<byte> compressed;
+    for (uint64_t i = 0; i < count; i++) {
+        AccessPoint point;
+        point.output = take<uint64_t>(stream);
+        point.input = take<uint64_t>(stream);
+        point.bits = take<uint8_t>(stream);
+        point.value = take<uint8_t>(stream);
+        uint32_t windowSize = take<uint32_t>(stream);
+        uint32_t compressedSize = take<uint32_t>(stream);
+        if (point.bits > 7 || windowSize > WindowSize || compressedSize > zng_compressBound(WindowSize) ||
+            (!index->m_points.empty() && point.output <= index->m_points.back().output))
+            throw std::ios_base::failure("DeflateIndex: index data is corrupted.");
+        compressed.resize(compressedSize);
+        readFully(stream, compressed.data(), compressedSize);
+        point.window.resize(windowSize);
+        size_t outputSize = windowSize;
+        size_t inputSize = compressedSize;
+        if (zng_uncompress2(point.window.data(), &outputSize, compressed.data(), &inputSize) != Z_OK ||
+            outputSize != windowSize)
+            throw std::ios_base::failure("DeflateIndex: index data is corrupted.");
+        index->m_points.push_back(std::move(point));
+    }
+    return index;
+}
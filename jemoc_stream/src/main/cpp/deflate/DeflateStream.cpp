@@ -6,10 +6,8 @@
 
 #include "stream/DeflateStream.h"
 
-napi_ref DeflateStream::cons = nullptr;
-std::string DeflateStream::ClassName = "DeflateStream";
 DeflateStream::DeflateStream(std::shared_ptr<IStream> stream, DeflateMode mode, int windowBits, int compressionLevel,
-                             bool leaveOpen, size_t bufferSize, long uncompressSize)
+                             bool leaveOpen, size_t bufferSize, long uncompressSize, int threads, size_t blockSize)
     : m_stream(stream), m_mode(mode), m_windowBits(windowBits), m_compressionLevel(compressionLevel),
       m_leaveOpen(leaveOpen), m_uncompressSize(uncompressSize), m_bufferSize(bufferSize) {
 
@@ -29,7 +27,11 @@ DeflateStream::DeflateStream(std::shared_ptr<IStream> stream, DeflateMode mode,
             throw std::ios_base::failure("DeflateStream: The target stream is not writable.");
         }
         m_canWrite = true;
-        deflater = new Deflater(m_windowBits, m_compressionLevel, Z_DEFAULT_STRATEGY);
+        if (threads > 1)
+            parallelDeflater = new ParallelDeflater(m_stream.get(), m_windowBits, m_compressionLevel,
+                                                    Z_DEFAULT_STRATEGY, threads, blockSize);
+        else
+            deflater = new Deflater(m_windowBits, m_compressionLevel, Z_DEFAULT_STRATEGY);
 
         break;
     case DeflateMode_Decompress:
@@ -50,10 +52,86 @@ bool DeflateStream::inflaterIsFinished() const {
     return inflater != nullptr && inflater->isFinished() && (!inflater->isGzipStream() || !inflater->needInput());
 }
 
-long DeflateStream::getPosition() const { throw std::ios_base::failure("DeflateStream: get position not supported."); }
-long DeflateStream::getLength() const { throw std::ios_base::failure("DeflateStream: get length not supported."); }
+void DeflateStream::setIndex(std::shared_ptr<DeflateIndex> index) {
+    if (m_mode != DeflateMode_Decompress)
+        throw std::ios_base::failure("DeflateStream: index is only supported in decompress mode.");
+    if (m_inputFed != 0)
+        throw std::ios_base::failure("DeflateStream: index must be set before reading.");
+    m_index = index;
+    if (m_index == nullptr)
+        return;
+    m_canGetPosition = true;
+    m_canGetLength = m_index->isComplete();
+    if (m_stream->getCanSeek()) {
+        m_inputStart = m_stream->getPosition();
+        m_canSeek = true;
+    }
+}
+
+long DeflateStream::getPosition() const {
+    if (!m_canGetPosition)
+        throw std::ios_base::failure("DeflateStream: get position not supported.");
+    return m_position;
+}
+
+long DeflateStream::getLength() const {
+    if (m_index == nullptr || !m_index->isComplete())
+        throw std::ios_base::failure("DeflateStream: get length not supported.");
+    return m_index->getLength();
+}
+
 long DeflateStream::seek(long offset, SeekOrigin origin) {
-    throw std::ios_base::failure("DeflateStream: seek operation not supported.");
+    if (!m_canSeek)
+        throw std::ios_base::failure("DeflateStream: seek operation not supported.");
+    if (m_closed)
+        throw std::ios::failure("DeflateStream: stream is closed");
+    long target = 0;
+    switch (origin) {
+    case Begin:
+        target = offset;
+        break;
+    case Current:
+        target = m_position + offset;
+        break;
+    case End:
+        target = getLength() + offset;
+        break;
+    default:
+        throw std::ios_base::failure("origin is out of range");
+    }
+    if (target < 0)
+        throw std::ios_base::failure("seek error");
+
+    // 向后seek，或目标前有比当前位置更近的访问点时从访问点恢复，否则从当前位置继续解压
+    const DeflateIndex::AccessPoint *point = m_index->find(target);
+    if (target < m_position || (point != nullptr && static_cast<long>(point->output) > m_position))
+        restart(point);
+    skip(target - m_position);
+    return m_position;
+}
+
+void DeflateStream::restart(const DeflateIndex::AccessPoint *point) {
+    if (point != nullptr) {
+        m_stream->seek(m_inputStart + point->input, SeekOrigin::Begin);
+        inflater->resume(*point);
+        m_inputFed = point->input;
+        m_position = point->output;
+    } else {
+        m_stream->seek(m_inputStart, SeekOrigin::Begin);
+        inflater->reset();
+        m_inputFed = 0;
+        m_position = 0;
+    }
+}
+
+void DeflateStream::skip(uint64_t count) {
+    byte discard[8192];
+    while (count > 0) {
+        long n = read(discard, 0, std::min(count, static_cast<uint64_t>(sizeof(discard))));
+        if (n <= 0)
+            break;
+        count -= n;
+    }
 }
 void DeflateStream::close() {
     if (m_closed)
@@ -72,6 +150,10 @@ void DeflateStream::close() {
         delete deflater;
         deflater = nullptr;
     }
+    if (parallelDeflater != nullptr) {
+        delete parallelDeflater;
+        parallelDeflater = nullptr;
+    }
     if (!m_leaveOpen && m_stream != nullptr) {
         m_stream->close();
     }
@@ -79,19 +161,6 @@ void DeflateStream::close() {
     m_stream = nullptr;
 }
 
-void DeflateStream::close(napi_env env) {
-    close();
-    napi_value retrieved_obj;
-    napi_status status = napi_get_reference_value(env, stream_weak_ref, &retrieved_obj);
-
-    //释放对象
-    if (status == napi_ok && !m_leaveOpen) {
-        void *result = nullptr;
-        napi_remove_wrap(env, retrieved_obj, &result);
-    }
-    napi_delete_reference(env, stream_weak_ref);
-    stream_weak_ref = nullptr;
-}
 
 void DeflateStream::flush() {
     if (m_closed)
@@ -111,25 +180,73 @@ long DeflateStream::read(void *buffer, long offset, size_t count) {
     size_t bytesRead = 0;
     if (buffer == nullptr)
         return bytesRead;
+    if (m_index != nullptr)
+        return readIndexed(offset_pointer(buffer, offset), count);
     while (true) {
         bytesRead = inflater->inflate(offset_pointer(buffer, offset), count);
         if (bytesRead != 0 || inflaterIsFinished()) {
             break;
         }
-        if (inflater->needInput()) {
-            size_t n = m_stream->read(m_buffer, 0, m_bufferSize);
-            if (n <= 0) {
-                if (!inflater->isFinished()) {
-                    throw std::ios::failure("DeflateStream: found truncated data while decoding.");
-                }
-                break;
-            } else {
-                inflater->setInput(m_buffer, n);
+        // 不带索引时同样经fillInput累计已读入的压缩数据，setIndex据此判断是否已经开始读取
+        if (inflater->needInput() && !fillInput())
+            break;
+    }
+    return bytesRead;
+}
+bool DeflateStream::fillInput() {
+    long n = m_stream->read(m_buffer, 0, m_bufferSize);
+    if (n <= 0) {
+        if (!inflater->isFinished())
+            throw std::ios::failure("DeflateStream: found truncated data while decoding.");
+        return false;
+    }
+    inflater->setInput(m_buffer, n);
+    m_inputFed += n;
+    return true;
+}
+
+long DeflateStream::readIndexed(void *buffer, size_t count) {
+    // 索引已完整时不需要在块边界停下
+    bool building = !m_index->isComplete();
+    int flushCode = building ? Z_BLOCK : Z_NO_FLUSH;
+    byte *output = static_cast<byte *>(buffer);
+    size_t bytesRead = 0;
+    bool retried = false;
+    while (bytesRead < count) {
+        long n = inflater->inflate(output + bytesRead, count - bytesRead, flushCode);
+        bytesRead += n;
+        if (building && inflater->atBlockBoundary() && m_index->needPoint(m_position + bytesRead)) {
+            DeflateIndex::AccessPoint point;
+            point.output = m_position + bytesRead;
+            point.input = m_inputFed - inflater->getAvailIn();
+            inflater->getAccessPoint(&point);
+            m_index->addPoint(std::move(point));
+        }
+        bool finished = inflaterIsFinished();
+        if (!finished && n == 0 && inflater->needInput()) {
+            // Z_BLOCK停在块边界后，下一次调用才越过块头，最后一块结束时无需更多输入即可到达流尾，先重试一次
+            if (building && !retried) {
+                retried = true;
+                continue;
             }
+            // gzip流结束时可能恰好用完输入，要读到底层流末尾才能确认
+            finished = !fillInput();
         }
+        retried = false;
+        if (finished) {
+            if (building) {
+                m_index->setComplete(m_position + bytesRead);
+                m_canGetLength = true;
+            }
+            break;
+        }
+        if (!building && n != 0)
+            break;
     }
+    m_position += bytesRead;
     return bytesRead;
 }
+
 long DeflateStream::write(void *buffer, long offset, size_t count) {
     if (m_mode != DeflateMode::DeflateMode_Compress)
         throw std::ios_base::failure("DeflateStream: decompress mode does not support read operation.");
@@ -137,6 +254,11 @@ long DeflateStream::write(void *buffer, long offset, size_t count) {
         throw std::ios::failure("DeflateStream: stream is closed.");
     if (buffer == nullptr)
         return 0;
+    if (parallelDeflater != nullptr) {
+        parallelDeflater->write(static_cast<byte *>(offset_pointer(buffer, offset)), count);
+        m_wroteBytes = true;
+        return count;
+    }
     if (deflater == nullptr)
         throw std::ios::failure("DeflateStream: deflater is null ");
 
@@ -157,7 +279,10 @@ void DeflateStream::writeDeflaterOutput() {
 }
 
 void DeflateStream::flushBuffers() {
-    if (m_wroteBytes) {
+    if (parallelDeflater != nullptr) {
+        if (m_wroteBytes)
+            parallelDeflater->flush();
+    } else if (m_wroteBytes) {
         writeDeflaterOutput();
         bool success;
         do {
@@ -179,7 +304,10 @@ void DeflateStream::purgeBuffers() {
 
     bool finished;
 
-    if (m_wroteBytes) {
+    if (parallelDeflater != nullptr) {
+        if (m_wroteBytes)
+            parallelDeflater->finish();
+    } else if (m_wroteBytes) {
         writeDeflaterOutput();
         do {
             size_t compressedBytes = 0;
@@ -195,65 +323,3 @@ void DeflateStream::purgeBuffers() {
         } while (!finished);
     }
 }
-
-napi_value DeflateStream::JSConstructor(napi_env env, napi_callback_info info) {
-    GET_JS_INFO_WITHOUT_STREAM(3)
-    std::shared_ptr<IStream> stream = GetStream(env, argv[0]);
-    if (!stream)
-        napi_throw_error(env, "DeflateStream", "argument stream is null");
-
-
-    int mode = getInt(env, argv[1]);
-    bool leaveOpen = false;
-    int windowBits = -15;
-    int compressionLevel = Z_DEFAULT_COMPRESSION;
-    long bufferSize = DEFAULT_BUFFER_SIZE;
-    long uncompressSize = -1;
-
-    napi_value value = nullptr;
-    napi_valuetype type;
-    GET_OBJ(argv[2], "leaveOpen", napi_get_value_bool, leaveOpen)
-    GET_OBJ(argv[2], "windowBits", napi_get_value_int32, windowBits)
-    GET_OBJ(argv[2], "uncompressSize", napi_get_value_int64, uncompressSize)
-    GET_OBJ(argv[2], "bufferSize", napi_get_value_int64, bufferSize)
-    GET_OBJ(argv[2], "compressionLevel", napi_get_value_int32, compressionLevel)
-
-    std::shared_ptr<IStream> ds;
-
-    if (windowBits < Min_WINDOW_BITS || windowBits > Max_WINDOW_BITS)
-        napi_throw_error(env, "DeflateStream", "windowBits must be greater than -15 and less than 31.");
-    if (mode == DeflateMode_Decompress && uncompressSize < -1)
-        napi_throw_range_error(env, "DeflateStream", "uncompressSize must greater than -1 in decompress mode");
-
-    if (bufferSize < 1)
-        napi_throw_range_error(env, ClassName.c_str(), "bufferSize must greater than 1");
-
-    try {
-        ds = std::make_shared<DeflateStream>(stream, DeflateMode(mode), windowBits, compressionLevel, leaveOpen,
-                                             bufferSize, uncompressSize);
-
-    } catch (const std::ios::failure &e) {
-        napi_throw_error(env, ClassName.c_str(), e.what());
-        return nullptr;
-    }
-
-    NAPI_CALL(env, napi_create_reference(env, argv[0], 0, &((DeflateStream *)ds.get())->stream_weak_ref));
-
-    return JSBind(env, _this, ds);
-}
-
-// void DeflateStream::JSDispose(napi_env env, void *data, void *hint) {
-////    DeflateStream *stream = static_cast<DeflateStream *>(data);
-////    delete stream;
-////    stream = nullptr;
-//    SharedPtrWrapper *wrapper = static_cast<SharedPtrWrapper *>(data);
-//    delete wrapper;
-//}
-
-void DeflateStream::Export(napi_env env, napi_value exports) {
-
-    napi_value napi_cons = nullptr;
-    napi_define_class(env, ClassName.c_str(), NAPI_AUTO_LENGTH, JSConstructor, nullptr, 0, nullptr, &napi_cons);
-    Extends(env, napi_cons);
-    napi_set_named_property(env, exports, ClassName.c_str(), napi_cons);
-}
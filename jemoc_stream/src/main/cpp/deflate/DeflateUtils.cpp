@@ -0,0 +1,119 @@
+//
+// Created on 2025/3/12.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#include "deflate/DeflateUtils.h"
+#include "deflate/Deflater.h"
+#include "deflate/Inflater.h"
+#include "deflate/ZStreamPool.h"
+#include <climits>
+#include <cstring>
+#include <ios>
+#include <string>
+
+static std::string errorMessage(const char *message, const zng_stream &stream) {
+    std::string error = "DeflateUtils: ";
+    error += message;
+    if (stream.msg != nullptr) {
+        error += ", ";
+        error += stream.msg;
+    }
+    return error;
+}
+
+// 离开作用域时把流归还到ZStreamPool，异常时同样归还
+struct PooledDeflater {
+    zng_stream *stream;
+    const DeflateUtils::Options &options;
+
+    ~PooledDeflater() {
+        ZStreamPool::releaseDeflater(stream, options.windowBits, options.level, options.strategy);
+    }
+};
+
+struct PooledInflater {
+    zng_stream *stream;
+
+    ~PooledInflater() { ZStreamPool::releaseInflater(stream); }
+};
+
+size_t DeflateUtils::compress(const byte *data, size_t length, std::vector<byte> &output, const Options &options) {
+    if (options.windowBits < Min_WINDOW_BITS || options.windowBits > Max_WINDOW_BITS)
+        throw std::ios_base::failure("DeflateUtils: windowBits must be greater than -15 and less than 31.");
+    PooledDeflater pooled{ZStreamPool::acquireDeflater(options.windowBits, options.level, options.strategy), options};
+    zng_stream *stream = pooled.stream;
+    if (stream == nullptr)
+        throw std::ios_base::failure("DeflateUtils: deflateInit2 failed");
+    size_t bound = zng_deflateBound(stream, length);
+    if (bound > UINT32_MAX)
+        throw std::ios_base::failure("DeflateUtils: input is too large, use DeflateStream instead.");
+    if (output.size() < bound)
+        output.resize(bound);
+
+    stream->next_in = data;
+    stream->avail_in = length;
+    stream->next_out = output.data();
+    stream->avail_out = bound;
+    // 输出空间不小于deflateBound，一次调用即可结束
+    int errCode = zng_deflate(stream, Z_FINISH);
+    size_t compressed = stream->total_out;
+    if (errCode != Z_STREAM_END)
+        throw std::ios_base::failure(errorMessage("deflate failed", *stream));
+    return compressed;
+}
+
+static bool isGzipMember(const byte *data, size_t length) {
+    return length >= 2 && data[0] == GZIP_Header_ID1 && data[1] == GZIP_Header_ID2;
+}
+
+size_t DeflateUtils::decompress(const byte *data, size_t length, std::vector<byte> &output, const Options &options) {
+    if (options.windowBits < Min_WINDOW_BITS || options.windowBits > Max_WINDOW_BITS)
+        throw std::ios_base::failure("DeflateUtils: windowBits must be greater than -15 and less than 31.");
+    if (length > UINT32_MAX)
+        throw std::ios_base::failure("DeflateUtils: input is too large, use DeflateStream instead.");
+    bool gzip = options.windowBits > 15;
+
+    size_t capacity = length * 4;
+    if (options.uncompressSize >= 0) {
+        capacity = options.uncompressSize;
+    } else if (gzip && length >= 18 && isGzipMember(data, length)) {
+        // gzip尾部的ISIZE是最后一个成员解压后的大小，单成员时即为总大小；deflate最大压缩比约1032:1，避免损坏数据导致超大分配
+        uint32_t size;
+        memcpy(&size, data + length - 4, sizeof(size));
+        capacity = std::min<size_t>(size, length * 1032);
+    }
+    if (output.size() < capacity)
+        output.resize(capacity);
+
+    PooledInflater pooled{ZStreamPool::acquireInflater(options.windowBits)};
+    zng_stream *stream = pooled.stream;
+    if (stream == nullptr)
+        throw std::ios_base::failure("DeflateUtils: inflateInit2 failed");
+    stream->next_in = data;
+    stream->avail_in = length;
+    size_t total = 0;
+    while (true) {
+        if (total == output.size())
+            output.resize(std::max<size_t>(total * 2, 1024));
+        stream->next_out = output.data() + total;
+        stream->avail_out = std::min<size_t>(output.size() - total, UINT32_MAX);
+        int errCode = zng_inflate(stream, Z_NO_FLUSH);
+        total = stream->next_out - output.data();
+        if (errCode == Z_STREAM_END) {
+            // 拼接的gzip成员继续解压，其余的尾部数据与Inflater一样忽略
+            if (gzip && isGzipMember(stream->next_in, stream->avail_in)) {
+                zng_inflateReset(stream);
+                continue;
+            }
+            break;
+        }
+        if (errCode == Z_OK || (errCode == Z_BUF_ERROR && stream->avail_out == 0))
+            continue;
+        std::string error = errCode == Z_BUF_ERROR ? "DeflateUtils: found truncated data while decoding."
+                                                   : errorMessage("inflate failed", *stream);
+        throw std::ios_base::failure(error);
+    }
+    return total;
+}
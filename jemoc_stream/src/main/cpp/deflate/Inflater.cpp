@@ -5,6 +5,7 @@
 // please include "napi/native_api.h".
 
 #include "deflate/Inflater.h"
+#include "deflate/ZStreamPool.h"
 #include "common.h"
 #include <cstddef>
 #include <ios>
@@ -14,19 +15,14 @@ Inflater::Inflater(int windowBits, long uncompressedSize)
     : m_windowBits(windowBits), m_uncompressedSize(uncompressedSize) {
     m_finished = false;
     m_currentInflatedCount = 0;
-    zStream = new zng_stream{.zalloc = Z_NULL, .zfree = Z_NULL, .opaque = Z_NULL};
-    if (Z_OK != zng_inflateInit2(zStream, m_windowBits)) {
-        delete zStream;
+    zStream = ZStreamPool::acquireInflater(m_windowBits);
+    if (zStream == nullptr)
         throw std::ios_base::failure("Inflater: failed to initialize zstream.");
-    }
 }
 
 Inflater::~Inflater() {
-    if (zStream != nullptr) {
-        zng_inflateEnd(zStream);
-        delete zStream;
-        zStream = nullptr;
-    }
+    ZStreamPool::releaseInflater(zStream);
+    zStream = nullptr;
 }
 
 bool Inflater::isFinished() const { return m_finished; }
@@ -38,15 +34,49 @@ void Inflater::setInput(void *buffer, size_t count) {
     zStream->avail_in = count;
 }
 
+size_t Inflater::getAvailIn() const { return zStream->avail_in; }
+
+bool Inflater::atBlockBoundary() const { return (zStream->data_type & 128) && !(zStream->data_type & 64); }
+
+void Inflater::getAccessPoint(DeflateIndex::AccessPoint *point) const {
+    point->bits = zStream->data_type & 7;
+    // 块边界不在字节边界上时，剩余的比特位于刚读过的字节中
+    point->value = point->bits != 0 ? zStream->next_in[-1] : 0;
+    point->window.resize(DeflateIndex::WindowSize);
+    uint32_t length = 0;
+    zng_inflateGetDictionary(zStream, point->window.data(), &length);
+    point->window.resize(length);
+}
+
+void Inflater::resume(const DeflateIndex::AccessPoint &point) {
+    // 窗口最大为32KB，按最大窗口恢复对任何windowBits都适用
+    if (zng_inflateReset2(zStream, -15) != Z_OK)
+        throw std::ios_base::failure("Inflater: failed to reset zstream.");
+    if (point.bits != 0)
+        zng_inflatePrime(zStream, point.bits, point.value >> (8 - point.bits));
+    if (!point.window.empty())
+        zng_inflateSetDictionary(zStream, point.window.data(), point.window.size());
+    zStream->next_in = nullptr;
+    zStream->avail_in = 0;
+    m_finished = false;
+}
 
-long Inflater::inflate(void *buffer, size_t count) {
+void Inflater::reset() {
+    if (zng_inflateReset2(zStream, m_windowBits) != Z_OK)
+        throw std::ios_base::failure("Inflater: failed to reset zstream.");
+    zStream->next_in = nullptr;
+    zStream->avail_in = 0;
+    m_finished = false;
+}
+
+long Inflater::inflate(void *buffer, size_t count, int flushCode) {
     long bytesRead = 0;
     if (m_uncompressedSize == -1) {
-        bytesRead = readOutput(buffer, count);
+        bytesRead = readOutput(buffer, count, flushCode);
     } else {
         if (m_uncompressedSize > m_currentInflatedCount) {
             size_t len = std::min(count, (size_t)(m_uncompressedSize - m_currentInflatedCount));
-            bytesRead = readOutput(buffer, len);
+            bytesRead = readOutput(buffer, len, flushCode);
         } else {
             m_finished = true;
             zStream->avail_in = 0;
@@ -55,9 +85,9 @@ long Inflater::inflate(void *buffer, size_t count) {
     return bytesRead;
 }
 
-long Inflater::readOutput(void *buffer, size_t count) {
+long Inflater::readOutput(void *buffer, size_t count, int flushCode) {
     int state = 0;
-    size_t readout = readInflateOutput(buffer, count, Z_NO_FLUSH, &state);
+    size_t readout = readInflateOutput(buffer, count, flushCode, &state);
     if (state == Z_STREAM_END) {
         if (needInput() && isGzipStream()) {
             m_finished = resetStreamForLeftoverInput();
@@ -87,12 +117,10 @@ int Inflater::inflate_(int flushCode) {
     case Z_MEM_ERROR:
         error = "inflate: not enough memory to complete the operation, ";
         error += zStream->msg;
-        zng_inflateEnd(zStream);
         throw std::ios_base::failure(error);
     case Z_DATA_ERROR:
         error = "inflate: the input data was corrupted ";
         error += zStream->msg;
-        zng_inflateEnd(zStream);
         throw std::ios_base::failure(error);
     case Z_STREAM_ERROR:
         error = "inflate: the stream structure was inconsistent,";
@@ -108,120 +136,16 @@ int Inflater::inflate_(int flushCode) {
 bool Inflater::resetStreamForLeftoverInput() {
     const uint8_t *strm = zStream->next_in;
     long len = zStream->avail_in;
-    if (strm == nullptr)
+    // 没有剩余输入时next_in指向已消费数据之后，不能读取
+    if (strm == nullptr || len == 0)
         return true;
     if (strm[0] != GZIP_Header_ID1 || (len > 1 && strm[1] != GZIP_Header_ID2))
         return true;
 
-    zng_inflateEnd(zStream);
-    delete zStream;
-    zStream = new zng_stream{.zalloc = Z_NULL, .zfree = Z_NULL, .opaque = Z_NULL};
-    zng_inflateInit2(zStream, m_windowBits);
+    // inflateReset保留windowBits和已分配的窗口，下一个成员直接继续解压
+    zng_inflateReset(zStream);
     zStream->next_in = strm;
     zStream->avail_in = len;
     m_finished = false;
     return false;
 }
-
-napi_value Inflater::JSConstructor(napi_env env, napi_callback_info info) {
-    GET_INFLATER_INFO(2)
-    int windowBits = -15;
-    long uncompressedSize = -1;
-    napi_valuetype type;
-    NAPI_CALL(env, napi_typeof(env, argv[0], &type))
-    if (type == napi_number) {
-        NAPI_CALL(env, napi_get_value_int32(env, argv[0], &windowBits))
-    }
-    NAPI_CALL(env, napi_typeof(env, argv[1], &type))
-    if (type == napi_number) {
-        NAPI_CALL(env, napi_get_value_int64(env, argv[1], &uncompressedSize))
-    }
-    try {
-        Inflater *inflater = new Inflater(windowBits, uncompressedSize);
-        NAPI_CALL(env, napi_wrap(env, _this, inflater, JSDispose, nullptr, nullptr))
-        return _this;
-    } catch (const std::exception &e) {
-        return nullptr;
-    }
-}
-
-void Inflater::JSDispose(napi_env env, void *data, void *hint) {
-    Inflater *inflater = static_cast<Inflater *>(data);
-    delete inflater;
-    inflater = nullptr;
-}
-
-napi_value Inflater::JSGetIsFinished(napi_env env, napi_callback_info info) {
-    GET_INFLATER_INFO_WITH_INFLATER(0)
-    napi_value result = nullptr;
-    napi_get_boolean(env, inflater->isFinished(), &result);
-    return result;
-}
-napi_value Inflater::JSInflate(napi_env env, napi_callback_info info) {
-    GET_INFLATER_INFO_WITH_INFLATER(3)
-    void *buffer = nullptr;
-    size_t length = 0;
-    getBuffer(env, argv[0], &buffer, &length);
-    long offset = getOffset(env, argv[1], length);
-    size_t count = getCount(env, argv[2], length, offset);
-    long readBytes = inflater->inflate(offset_pointer(buffer, offset), count);
-    napi_value result = nullptr;
-    NAPI_CALL(env, napi_create_int64(env, readBytes, &result))
-    return result;
-}
-napi_value Inflater::JSGetIsGzipStream(napi_env env, napi_callback_info info) {
-    GET_INFLATER_INFO_WITH_INFLATER(0)
-    napi_value result = nullptr;
-    napi_get_boolean(env, inflater->isGzipStream(), &result);
-    return result;
-}
-
-napi_value Inflater::JSSetInput(napi_env env, napi_callback_info info) {
-    GET_INFLATER_INFO_WITH_INFLATER(3)
-    void *buffer = nullptr;
-    size_t length = 0;
-    getBuffer(env, argv[0], &buffer, &length);
-    long offset = getOffset(env, argv[1], length);
-    size_t count = getCount(env, argv[2], length, offset);
-    inflater->setInput(offset_pointer(buffer, offset), count);
-    return nullptr;
-}
-napi_value Inflater::JSNeedInput(napi_env env, napi_callback_info info) {
-    GET_INFLATER_INFO_WITH_INFLATER(0)
-    napi_value result = nullptr;
-    napi_get_boolean(env, inflater->needInput(), &result);
-    return result;
-}
-
-napi_value Inflater::JSDispose(napi_env env, napi_callback_info info) {
-    GET_INFLATER_INFO(0)
-    void *result = nullptr;
-    NAPI_CALL(env, napi_remove_wrap(env, _this, &result))
-    return nullptr;
-}
-
-napi_value Inflater::JSIsDisposed(napi_env env, napi_callback_info info) {
-    GET_INFLATER_INFO(0)
-    void *inflater = nullptr;
-    NAPI_CALL(env, napi_unwrap(env, _this, &inflater))
-    bool value = inflater == nullptr;
-    napi_value result = nullptr;
-    napi_get_boolean(env, value, &result);
-    return result;
-}
-
-void Inflater::Export(napi_env env, napi_value exports) {
-    napi_property_descriptor desc[] = {
-        DEFINE_NAPI_FUNCTION("isFinished", nullptr, JSGetIsFinished, nullptr, nullptr),
-        DEFINE_NAPI_FUNCTION("inflate", JSInflate, nullptr, nullptr, nullptr),
-        DEFINE_NAPI_FUNCTION("isGzipInput", JSGetIsGzipStream, nullptr, nullptr, nullptr),
-        DEFINE_NAPI_FUNCTION("setInput", JSSetInput, nullptr, nullptr, nullptr),
-        DEFINE_NAPI_FUNCTION("dispose", JSDispose, nullptr, nullptr, nullptr),
-        DEFINE_NAPI_FUNCTION("isDisposed", nullptr, JSIsDisposed, nullptr, nullptr),
-        DEFINE_NAPI_FUNCTION("needInput", nullptr, JSNeedInput, nullptr, nullptr),
-    };
-    napi_value cons = nullptr;
-    napi_define_class(env, "Inflater", NAPI_AUTO_LENGTH, JSConstructor, nullptr, sizeof(desc) / sizeof(desc[0]), desc,
-                      &cons);
-    napi_set_named_property(env, exports, "Inflater", cons);
-}
\ No newline at end of file
@@ -0,0 +1,237 @@
+//
+// Created on 2025/3/10.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#include "deflate/ParallelDeflater.h"
+#include "deflate/Deflater.h"
+#include "zlib-ng.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+ParallelDeflater::ParallelDeflater(IStream *output, int windowBits, int level, int strategy, int threads,
+                                   size_t blockSize)
+    : m_output(output), m_level(level), m_strategy(strategy), m_threads(std::max(threads, 1)),
+      m_blockSize(blockSize > 0 ? blockSize : DefaultBlockSize) {
+    if (windowBits < Min_WINDOW_BITS || windowBits > Max_WINDOW_BITS)
+        throw std::ios_base::failure("deflater: windowbits must be greater than -15 and less than 31. ");
+    if (threads > MaxThreads)
+        throw std::ios_base::failure("deflater: threads must not be greater than " + std::to_string(MaxThreads));
+    if (blockSize > MaxBlockSize)
+        throw std::ios_base::failure("deflater: blockSize must not be greater than " + std::to_string(MaxBlockSize));
+    m_format = windowBits < 0 ? Raw : windowBits > 15 ? Gzip : Zlib;
+    // zlib同样会把8调整为9
+    m_rawWindowBits = -std::max(std::abs(windowBits) & 15, 9);
+    m_check = m_format == Zlib ? 1 : 0;
+    m_block.reserve(m_blockSize);
+}
+
+ParallelDeflater::~ParallelDeflater() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_workCondition.notify_all();
+    for (auto &worker : m_workers)
+        worker.join();
+}
+
+void ParallelDeflater::write(const byte *buffer, size_t count) {
+    if (m_finished)
+        throw std::ios_base::failure("deflater: write after finish");
+    while (count > 0) {
+        size_t n = std::min(count, m_blockSize - m_block.size());
+        m_block.insert(m_block.end(), buffer, buffer + n);
+        buffer += n;
+        count -= n;
+        if (m_block.size() == m_blockSize)
+            submit(false);
+    }
+    drain(false);
+}
+
+void ParallelDeflater::flush() {
+    if (m_finished)
+        return;
+    if (!m_block.empty())
+        submit(false);
+    drain(true);
+}
+
+void ParallelDeflater::finish() {
+    if (m_finished)
+        return;
+    submit(true);
+    drain(true);
+    m_finished = true;
+
+    byte trailer[8];
+    size_t length = 0;
+    if (m_format == Zlib) {
+        trailer[0] = m_check >> 24;
+        trailer[1] = m_check >> 16;
+        trailer[2] = m_check >> 8;
+        trailer[3] = m_check;
+        length = 4;
+    } else if (m_format == Gzip) {
+        for (int i = 0; i < 4; i++) {
+            trailer[i] = m_check >> (8 * i);
+            trailer[4 + i] = static_cast<uint32_t>(m_totalIn) >> (8 * i);
+        }
+        length = 8;
+    }
+    if (length > 0)
+        m_output->write(trailer, 0, length);
+}
+
+void ParallelDeflater::submit(bool last) {
+    auto job = std::make_shared<Job>();
+    job->last = last;
+    if (!m_freeBuffers.empty()) {
+        job->input = std::move(m_freeBuffers.back());
+        m_freeBuffers.pop_back();
+    }
+    job->input.swap(m_block);
+    m_block.clear();
+    m_block.reserve(m_blockSize);
+    job->dictionary = m_window;
+
+    // 更新字典窗口，块可能小于32KB（flush之后），需要与之前的窗口拼接
+    const std::vector<byte> &input = job->input;
+    if (input.size() >= DictionarySize) {
+        m_window.assign(input.end() - DictionarySize, input.end());
+    } else {
+        m_window.insert(m_window.end(), input.begin(), input.end());
+        if (m_window.size() > DictionarySize)
+            m_window.erase(m_window.begin(), m_window.end() - DictionarySize);
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_jobs.push_back(job);
+    m_pending.push_back(job);
+    if (m_idleWorkers == 0 && static_cast<int>(m_workers.size()) < m_threads)
+        m_workers.emplace_back(&ParallelDeflater::work, this);
+    else
+        m_workCondition.notify_one();
+    // 限制在途的块数，避免生产快于压缩时无限占用内存
+    while (static_cast<int>(m_jobs.size()) > m_threads * 2) {
+        m_doneCondition.wait(lock, [this]() { return m_jobs.front()->done; });
+        std::shared_ptr<Job> front = m_jobs.front();
+        m_jobs.pop_front();
+        lock.unlock();
+        writeJob(*front);
+        lock.lock();
+    }
+}
+
+void ParallelDeflater::drain(bool waitAll) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_jobs.empty()) {
+        if (!m_jobs.front()->done) {
+            if (!waitAll)
+                return;
+            m_doneCondition.wait(lock, [this]() { return m_jobs.front()->done; });
+        }
+        std::shared_ptr<Job> front = m_jobs.front();
+        m_jobs.pop_front();
+        lock.unlock();
+        writeJob(*front);
+        lock.lock();
+    }
+}
+
+void ParallelDeflater::writeJob(Job &job) {
+    if (job.error)
+        std::rethrow_exception(job.error);
+    if (!m_headerWritten)
+        writeHeader();
+    if (!job.output.empty())
+        m_output->write(job.output.data(), 0, job.output.size());
+    if (m_format == Gzip)
+        m_check = zng_crc32_combine(m_check, job.check, job.input.size());
+    else if (m_format == Zlib)
+        m_check = zng_adler32_combine(m_check, job.check, job.input.size());
+    m_totalIn += job.input.size();
+    job.input.clear();
+    m_freeBuffers.push_back(std::move(job.input));
+}
+
+void ParallelDeflater::writeHeader() {
+    m_headerWritten = true;
+    if (m_format == Zlib) {
+        // 与deflate()写出的zlib头一致
+        int level = m_level == Z_DEFAULT_COMPRESSION ? 6 : m_level;
+        int levelFlags = (m_strategy >= Z_HUFFMAN_ONLY || level < 2) ? 0 : level < 6 ? 1 : level == 6 ? 2 : 3;
+        unsigned header = (Z_DEFLATED + ((-m_rawWindowBits - 8) << 4)) << 8 | (levelFlags << 6);
+        header += 31 - header % 31;
+        byte bytes[2] = {static_cast<byte>(header >> 8), static_cast<byte>(header)};
+        m_output->write(bytes, 0, 2);
+    } else if (m_format == Gzip) {
+        // 不带文件名和时间的最小gzip头，OS为unix
+        byte xfl = m_level == 9 ? 2 : (m_level == 1 ? 4 : 0);
+        byte bytes[10] = {0x1f, 0x8b, Z_DEFLATED, 0, 0, 0, 0, 0, xfl, 3};
+        m_output->write(bytes, 0, 10);
+    }
+}
+
+void ParallelDeflater::work() {
+    zng_stream stream{};
+    int memLevel = m_level == Z_NO_COMPRESSION ? 7 : 8;
+    int initCode = zng_deflateInit2(&stream, m_level, Z_DEFLATED, m_rawWindowBits, memLevel, m_strategy);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_idleWorkers++;
+        m_workCondition.wait(lock, [this]() { return m_stopping || !m_pending.empty(); });
+        m_idleWorkers--;
+        if (m_pending.empty())
+            break;
+        std::shared_ptr<Job> job = m_pending.front();
+        m_pending.pop_front();
+        lock.unlock();
+
+        try {
+            if (initCode != Z_OK)
+                throw std::ios_base::failure("deflater: deflateInit2 failed");
+            zng_deflateReset(&stream);
+            if (!job->dictionary.empty())
+                zng_deflateSetDictionary(&stream, job->dictionary.data(), job->dictionary.size());
+            // 预留sync flush的空存储块
+            job->output.resize(zng_deflateBound(&stream, job->input.size()) + 16);
+            stream.next_in = job->input.data();
+            stream.avail_in = job->input.size();
+            stream.next_out = job->output.data();
+            stream.avail_out = job->output.size();
+            int flushCode = job->last ? Z_FINISH : Z_SYNC_FLUSH;
+            int errCode = Z_OK;
+            while (true) {
+                errCode = zng_deflate(&stream, flushCode);
+                if (errCode == Z_STREAM_ERROR)
+                    throw std::ios_base::failure("deflater: deflate failed, inconsistent stream ");
+                if (stream.avail_out != 0 || errCode == Z_STREAM_END)
+                    break;
+                size_t used = job->output.size();
+                job->output.resize(used * 2);
+                stream.next_out = job->output.data() + used;
+                stream.avail_out = job->output.size() - used;
+            }
+            job->output.resize(job->output.size() - stream.avail_out);
+            if (m_format == Gzip)
+                job->check = zng_crc32(0, job->input.data(), job->input.size());
+            else if (m_format == Zlib)
+                job->check = zng_adler32(1, job->input.data(), job->input.size());
+        } catch (...) {
+            job->error = std::current_exception();
+        }
+
+        lock.lock();
+        job->done = true;
+        m_doneCondition.notify_all();
+    }
+    lock.unlock();
+    if (initCode == Z_OK)
+        zng_deflateEnd(&stream);
+}
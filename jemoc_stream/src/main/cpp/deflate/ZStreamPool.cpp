@@ -0,0 +1,134 @@
+//
+// Created on 2025/3/13.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#include "deflate/ZStreamPool.h"
+#include <vector>
+
+static int getMemLevel(int level) { return level == Z_NO_COMPRESSION ? 7 : 8; }
+
+namespace {
+struct IdleDeflater {
+    zng_stream *stream;
+    int windowBits;
+    int level;
+    int strategy;
+};
+
+struct ThreadStreams {
+    std::vector<IdleDeflater> deflaters;
+    std::vector<zng_stream *> inflaters;
+
+    ~ThreadStreams();
+};
+
+// 线程退出时池先于其他thread_local对象析构，此后归还的流直接释放
+thread_local bool streamsDestroyed = false;
+thread_local ThreadStreams streams;
+
+ThreadStreams::~ThreadStreams() {
+    streamsDestroyed = true;
+    for (auto &idle : deflaters) {
+        zng_deflateEnd(idle.stream);
+        delete idle.stream;
+    }
+    for (auto *stream : inflaters) {
+        zng_inflateEnd(stream);
+        delete stream;
+    }
+}
+} // namespace
+
+zng_stream *ZStreamPool::acquireDeflater(int windowBits, int level, int strategy) {
+    if (!streamsDestroyed) {
+        auto &idle = streams.deflaters;
+        // 优先取参数完全相同的，其次取windowBits和memLevel相同的再调整等级和策略
+        for (auto it = idle.rbegin(); it != idle.rend(); ++it) {
+            if (it->windowBits == windowBits && it->level == level && it->strategy == strategy) {
+                zng_stream *stream = it->stream;
+                idle.erase(std::next(it).base());
+                return stream;
+            }
+        }
+        for (auto it = idle.rbegin(); it != idle.rend(); ++it) {
+            if (it->windowBits == windowBits && getMemLevel(it->level) == getMemLevel(level)) {
+                zng_stream *stream = it->stream;
+                idle.erase(std::next(it).base());
+                if (zng_deflateParams(stream, level, strategy) == Z_OK)
+                    return stream;
+                zng_deflateEnd(stream);
+                delete stream;
+                break;
+            }
+        }
+    }
+    auto *stream = new zng_stream();
+    if (zng_deflateInit2(stream, level, Z_DEFLATED, windowBits, getMemLevel(level), strategy) != Z_OK) {
+        delete stream;
+        return nullptr;
+    }
+    return stream;
+}
+
+void ZStreamPool::releaseDeflater(zng_stream *stream, int windowBits, int level, int strategy) {
+    if (stream == nullptr)
+        return;
+    if (streamsDestroyed || zng_deflateReset(stream) != Z_OK) {
+        zng_deflateEnd(stream);
+        delete stream;
+        return;
+    }
+    // reset不清理输入输出，避免下一个使用者看到上一次残留的avail_in
+    stream->next_in = nullptr;
+    stream->avail_in = 0;
+    stream->next_out = nullptr;
+    stream->avail_out = 0;
+    auto &idle = streams.deflaters;
+    if (idle.size() >= MaxIdleDeflaters) {
+        zng_deflateEnd(idle.front().stream);
+        delete idle.front().stream;
+        idle.erase(idle.begin());
+    }
+    idle.push_back({stream, windowBits, level, strategy});
+}
+
+zng_stream *ZStreamPool::acquireInflater(int windowBits) {
+    if (!streamsDestroyed && !streams.inflaters.empty()) {
+        zng_stream *stream = streams.inflaters.back();
+        streams.inflaters.pop_back();
+        // windowBits不同时inflateReset2会释放已分配的窗口，之后按需重新分配
+        if (zng_inflateReset2(stream, windowBits) == Z_OK)
+            return stream;
+        zng_inflateEnd(stream);
+        delete stream;
+    }
+    auto *stream = new zng_stream();
+    if (zng_inflateInit2(stream, windowBits) != Z_OK) {
+        delete stream;
+        return nullptr;
+    }
+    return stream;
+}
+
+void ZStreamPool::releaseInflater(zng_stream *stream) {
+    if (stream == nullptr)
+        return;
+    if (streamsDestroyed || zng_inflateReset(stream) != Z_OK) {
+        zng_inflateEnd(stream);
+        delete stream;
+        return;
+    }
+    stream->next_in = nullptr;
+    stream->avail_in = 0;
+    stream->next_out = nullptr;
+    stream->avail_out = 0;
+    auto &idle = streams.inflaters;
+    if (idle.size() >= MaxIdleInflaters) {
+        zng_inflateEnd(idle.front());
+        delete idle.front();
+        idle.erase(idle.begin());
+    }
+    idle.push_back(stream);
+}
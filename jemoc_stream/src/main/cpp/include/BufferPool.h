@@ -6,13 +6,14 @@
 #pragma once
 
 #include <memory>
+#include <algorithm>
 #include <vector>
 #include <mutex>
 #include <list>
 #include <unordered_map>
 #include <atomic>
 #include <thread>
-#include <napi/native_api.h>
+#include "NapiTypes.h"
 #include "common.h"
 
 
@@ -8,153 +8,33 @@
 #define JEMOC_STREAM_TEST_ISTREAM_H
 
 
+#include "NapiTypes.h"
 #include "common.h"
+#include "stream/StreamStats.h"
+#include <atomic>
 #include <cstddef>
+#include <functional>
 #include <ios>
-#include <napi/native_api.h>
+#include <memory>
+#include <mutex>
+#include <sys/uio.h>
 
 
 class IStream;
-
-struct AsyncWorkData {
-    void *buffer;
-    long offset;
-    long count;
-    long result;
-    long bufferSize;
-    IStream *stream;
-    IStream *targetStream;
-    napi_deferred deferred;
-    napi_async_work work;
-};
-
-static void getToArrayBufferOptions(napi_env env, napi_value value, long *offset, long *length) {
-    napi_valuetype type;
-    NAPI_CALL(env, napi_typeof(env, value, &type))
-    if (type != napi_object)
-        return;
-
-    napi_value jsVal;
-    NAPI_CALL(env, napi_get_named_property(env, value, "offset", &jsVal))
-    NAPI_CALL(env, napi_typeof(env, jsVal, &type))
-    if (napi_number == type) {
-        long len = 0;
-        NAPI_CALL(env, napi_get_value_int64(env, jsVal, &len))
-        *offset = std::max(0l, std::min(*length, len));
-        *length = *length - *offset;
-    }
-
-    NAPI_CALL(env, napi_get_named_property(env, value, "length", &jsVal))
-    NAPI_CALL(env, napi_typeof(env, jsVal, &type))
-    if (napi_number == type) {
-        long len = 0;
-        NAPI_CALL(env, napi_get_value_int64(env, jsVal, &len))
-        *length = std::max(0l, std::min(*length, len));
-    }
-}
-
-#define GET_JS_INFO_WITHOUT_CHECK(count)                                                                               \
-    GET_JS_INFO_WITHOUT_STREAM(count)                                                                                  \
-    std::shared_ptr<IStream> stream = IStream::GetStream(env, _this);
-
-
-#define GET_JS_INFO_WITHOUT_STREAM(count)                                                                              \
-    napi_value _this = nullptr;                                                                                        \
-    size_t argc = count;                                                                                               \
-    napi_value argv[count];                                                                                            \
-    void *className;                                                                                                   \
-    napi_get_cb_info(env, info, &argc, argv, &_this, &className);                                                      \
-    const char *tagName = static_cast<char *>(className);
-
-#define GET_JS_INFO(count)                                                                                             \
-    GET_JS_INFO_WITHOUT_STREAM(count)                                                                                  \
-    std::shared_ptr<IStream> stream = IStream::GetStream(env, _this);                                                  \
-    if (stream == nullptr) {                                                                                           \
-        napi_throw_error(env, ClassName.c_str(), "stream is null");                                                    \
-    }                                                                                                                  \
-    if (stream->isClose()) {                                                                                           \
-        napi_throw_error(env, ClassName.c_str(), "stream is closed");                                                  \
-    }
-
-#define RETURN_NAPI_VALUE(func, value)                                                                                 \
-    napi_value result = nullptr;                                                                                       \
-    func(env, value, &result);                                                                                         \
-    return result;
-
-#define RETURN_BOOL(value) RETURN_NAPI_VALUE(napi_get_boolean, value);
-
-#define DEFINE_ISTREAM_GET_BOOL_FUNCTION(func, func1)                                                                  \
-    napi_value IStream::func(napi_env env, napi_callback_info info) {                                                  \
-        GET_JS_INFO(0)                                                                                                 \
-        RETURN_NAPI_VALUE(napi_get_boolean, stream->func1());                                                          \
-    }
-
-#define DEFINE_ISTREAM_GET_STATE(jsfunc, funname)                                                                      \
-    napi_value IStream::jsfunc(napi_env env, napi_callback_info info) {                                                \
-        GET_JS_INFO_WITHOUT_CHECK(0)                                                                                   \
-        bool value = false;                                                                                            \
-        if (!(stream == nullptr || stream->isClose())) {                                                               \
-            value = stream->funname();                                                                                 \
-        }                                                                                                              \
-        napi_value result = nullptr;                                                                                   \
-        NAPI_CALL(env, napi_get_boolean(env, value, &result))                                                          \
-        return result;                                                                                                 \
-    }
-
-
-#define DEFINE_ISTREAM_GET_LONG_FUNCTION(func, func1)                                                                  \
-    napi_value IStream::func(napi_env env, napi_callback_info info) {                                                  \
-        GET_JS_INFO_WITHOUT_CHECK(0)                                                                                   \
-        if (stream == nullptr || stream->isClose()) {                                                                  \
-            napi_throw_error(env, tagName, "stream is closed");                                                        \
-        }                                                                                                              \
-        try {                                                                                                          \
-            long resultVal = stream->func1();                                                                          \
-            napi_value result = nullptr;                                                                               \
-            napi_create_int64(env, resultVal, &result);                                                                \
-            return result;                                                                                             \
-        } catch (const std::ios_base::failure &e) {                                                                    \
-            napi_throw_error(env, tagName, e.what());                                                                  \
-        }                                                                                                              \
-        return nullptr;                                                                                                \
-    }
-
-#define DEFINE_ISTREAM_SET_FUNC(func, func1)                                                                           \
-    napi_value IStream::func(napi_env env, napi_callback_info info) {                                                  \
-        GET_JS_INFO(1)                                                                                                 \
-        long val = 0;                                                                                                  \
-        napi_get_value_int64(env, argv[0], &val);                                                                      \
-        stream->func1(val);                                                                                            \
-        return nullptr;                                                                                                \
-    }
-
-#define DEFINE_NAPI_ISTREAM_PROPERTY(className)                                                                        \
-    DEFINE_NAPI_FUNCTION("canRead", nullptr, IStream::JSGetCanRead, nullptr, className),                               \
-        DEFINE_NAPI_FUNCTION("canWrite", nullptr, IStream::JSGetCanWrite, nullptr, className),                         \
-        DEFINE_NAPI_FUNCTION("canSeek", nullptr, IStream::JSGetCanSeek, nullptr, className),                           \
-        DEFINE_NAPI_FUNCTION("position", nullptr, IStream::JSGetPosition, nullptr, className),                         \
-        DEFINE_NAPI_FUNCTION("length", nullptr, IStream::JSGetLength, IStream::JSSetLength, className),                \
-        DEFINE_NAPI_FUNCTION("copyTo", IStream::JSCopyTo, nullptr, nullptr, className),                                \
-        DEFINE_NAPI_FUNCTION("seek", IStream::JSSeek, nullptr, nullptr, className),                                    \
-        DEFINE_NAPI_FUNCTION("read", IStream::JSRead, nullptr, nullptr, className),                                    \
-        DEFINE_NAPI_FUNCTION("write", IStream::JSWrite, nullptr, nullptr, className),                                  \
-        DEFINE_NAPI_FUNCTION("flush", IStream::JSFlush, nullptr, nullptr, className),                                  \
-        DEFINE_NAPI_FUNCTION("close", IStream::JSClose, nullptr, nullptr, className),                                  \
-        DEFINE_NAPI_FUNCTION("readAsync", IStream::JSReadAsync, nullptr, nullptr, className),                          \
-        DEFINE_NAPI_FUNCTION("writeAsync", IStream::JSWriteAsync, nullptr, nullptr, className),                        \
-        DEFINE_NAPI_FUNCTION("copyToAsync", IStream::JSCopyToAsync, nullptr, nullptr, className),                      \
-        DEFINE_NAPI_FUNCTION("flushAsync", IStream::JSFlushAsync, nullptr, nullptr, className),                        \
-        DEFINE_NAPI_FUNCTION("closeAsync", IStream::JSCloseAsync, nullptr, nullptr, className),                        \
-        DEFINE_NAPI_FUNCTION("isClosed", nullptr, IStream::JSGetIsClosed, nullptr, className)
-
-
-#define CHECK_STREAM                                                                                                   \
-    if (stream->isClose()) {                                                                                           \
-        napi_throw_error(env, tagName, "stream is closed");                                                            \
-    }
+class AsyncIoQueue;
 
 enum SeekOrigin { Begin, Current, End };
 
+// 流水线拷贝统计，时间单位为毫秒
+struct PipelineCopyStats {
+    long bytes = 0;
+    double elapsedTime = 0;
+    // 读线程等待空闲缓冲区的时间，写入是瓶颈时增大
+    double readStallTime = 0;
+    // 写线程等待数据的时间，读取(解压)是瓶颈时增大
+    double writeStallTime = 0;
+};
+
 class IStream {
 public:
     struct SharedPtrWrapper {
@@ -173,6 +53,10 @@ public:
     static napi_value JSSeek(napi_env env, napi_callback_info info);
     static napi_value JSRead(napi_env env, napi_callback_info info);
     static napi_value JSWrite(napi_env env, napi_callback_info info);
+    static napi_value JSReadv(napi_env env, napi_callback_info info);
+    static napi_value JSWritev(napi_env env, napi_callback_info info);
+    static napi_value JSReadAt(napi_env env, napi_callback_info info);
+    static napi_value JSWriteAt(napi_env env, napi_callback_info info);
     static napi_value JSFlush(napi_env env, napi_callback_info info);
     static napi_value JSCopyTo(napi_env env, napi_callback_info info);
     static napi_value JSClose(napi_env env, napi_callback_info info);
@@ -182,6 +66,12 @@ public:
     static napi_value JSFlushAsync(napi_env env, napi_callback_info info);
     static napi_value JSCloseAsync(napi_env env, napi_callback_info info);
     static napi_value JSGetIsClosed(napi_env env, napi_callback_info info);
+    static napi_value JSGetStats(napi_env env, napi_callback_info info);
+    static napi_value JSResetStats(napi_env env, napi_callback_info info);
+    static napi_value JSGetStatsEnabled(napi_env env, napi_callback_info info);
+    static napi_value JSSetStatsEnabled(napi_env env, napi_callback_info info);
+    static napi_value JSSetGlobalStatsEnabled(napi_env env, napi_callback_info info);
+    static napi_value JSSlice(napi_env env, napi_callback_info info);
     static napi_value JSCreateInterface(napi_env env, std::shared_ptr<IStream> stream);
     static napi_value JSBind(napi_env env, napi_value value, std::shared_ptr<IStream> stream);
 
@@ -189,6 +79,11 @@ public:
     static void Export(napi_env env, napi_value exports);
     static void Extends(napi_env env, napi_value constructor);
     static SharedPtrWrapper *MakePtr(IStream *stream);
+    /**
+     * 返回stream中[start, start + length)区间的只读子流，length超出流长度时截到末尾。
+     * 子流通过readAt读取，不移动stream的指针，同一个流上的多个子流可以并发读取；子流关闭时不关闭stream
+     */
+    static std::shared_ptr<IStream> Slice(std::shared_ptr<IStream> stream, long start, long length);
     static std::shared_ptr<IStream> GetStream(napi_env env, napi_value value);
     static std::string ClassName;
     static napi_value cons;
@@ -196,7 +91,10 @@ public:
 public:
     IStream()
         : m_canRead(false), m_canWrite(false), m_canSeek(false), m_position(0), m_length(0), m_canGetLength(false),
-          m_canGetPosition(false), m_closed(false) {}
+          m_canGetPosition(false), m_closed(false) {
+        if (s_globalStatsEnabled.load(std::memory_order_relaxed))
+            setStatsEnabled(true);
+    }
     virtual ~IStream() = default;
     virtual bool getCanRead() const { return m_canRead; }
     virtual bool getCanWrite() const { return m_canWrite; }
@@ -205,13 +103,51 @@ public:
     virtual long getLength() const { return m_length; }
     virtual void setLength(long length) { throw std::ios::failure("set length not supported"); }
     virtual void copyTo(IStream *stream, long bufferSize);
+    // 读写分别在两个线程上进行，通过depth个缓冲区组成的环形队列衔接
+    PipelineCopyStats copyToPipelined(IStream *stream, long bufferSize, int depth);
     virtual long seek(long offset, SeekOrigin origin);
     virtual void flush() {}
     virtual void close();
     virtual long read(void *buffer, long offset, size_t count) { return 0; };
     virtual long write(void *buffer, long offset, size_t count) { return 0; };
+    // 分散读/集中写，默认逐段调用read/write，支持的流可重写为一次系统调用或内存拷贝
+    virtual long readv(const struct iovec *iov, int iovcnt);
+    virtual long writev(const struct iovec *iov, int iovcnt);
+    // 定位读写，不移动流指针。默认实现在锁内seek后读写再恢复指针，支持的流可重写为pread/pwrite
+    virtual long readAt(long position, void *buffer, long offset, size_t count);
+    virtual long writeAt(long position, void *buffer, long offset, size_t count);
     virtual bool isClose() const { return m_closed; }
-    virtual void close(napi_env env) { close(); }
+    // 数据在内存中连续存放的流返回position处长度为length的只读指针，调用方可直接解析而不拷贝；
+    // 不支持或区间不连续时返回nullptr，需退回read。指针在流关闭或修改长度前有效
+    virtual const byte *getSpan(long position, long length) { return nullptr; }
+
+    // 开启后记录read/write/flush/seek的调用次数、字节数和耗时。全局开关只影响之后创建的流
+    void setStatsEnabled(bool enabled);
+    bool getStatsEnabled() const { return m_stats.load(std::memory_order_relaxed) != nullptr; }
+    // 从未开启过统计时返回nullptr，关闭统计后保留已记录的数据
+    StreamStats *getStats() const { return m_statsStorage.get(); }
+    static void SetGlobalStatsEnabled(bool enabled) { s_globalStatsEnabled.store(enabled); }
+
+    // 统计开启时计时、记录缺页次数并记录一次调用，未开启时只多一次分支
+    template <typename F> long tracked(StreamStats::Op op, F &&func) {
+        StreamStats *stats = m_stats.load(std::memory_order_relaxed);
+        if (__builtin_expect(stats == nullptr, 1))
+            return func();
+        auto start = StreamStats::Clock::now();
+        PageFaults faults = PageFaults::current();
+        long result = func();
+        stats->record(op, result, StreamStats::toMs(StreamStats::Clock::now() - start),
+                      PageFaults::current() - faults);
+        return result;
+    }
+
+private:
+    static napi_value copyToPipelinedAsync(napi_env env, std::shared_ptr<IStream> stream,
+                                           std::shared_ptr<IStream> target, long bufferSize, int depth);
+    // 提交到流的异步读写队列，resolveResult为false时promise以undefined完成；
+    // buffer不为空时在任务完成前保持引用，防止工作线程读写期间被回收
+    static napi_value queueIo(napi_env env, std::shared_ptr<IStream> stream, bool resolveResult,
+                              std::function<long()> func, napi_value buffer = nullptr);
 
 
 protected:
@@ -225,6 +161,13 @@ protected:
     long m_length;
     bool m_closed;
     std::mutex mutex_;
+    std::atomic<StreamStats *> m_stats{nullptr};
+
+private:
+    std::unique_ptr<StreamStats> m_statsStorage;
+    // readAsync/writeAsync/flushAsync共用的队列，首次调用时由js绑定层创建
+    std::shared_ptr<AsyncIoQueue> m_ioQueue;
+    static std::atomic<bool> s_globalStatsEnabled;
 };
 
 #endif // JEMOC_STREAM_TEST_ISTREAM_H
@@ -0,0 +1,23 @@
+//
+// Created on 2025/3/5.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#ifndef JEMOC_STREAM_TEST_NAPITYPES_H
+#define JEMOC_STREAM_TEST_NAPITYPES_H
+
+/**
+ * napi句柄的前置声明，与napi/native_api.h中的定义一致。
+ * 核心头文件只通过它声明JS*绑定函数，不依赖napi头文件和libace_napi，主机侧可以直接编译链接，
+ * 绑定函数的实现位于binding目录，只编译进鸿蒙动态库
+ */
+typedef struct napi_env__ *napi_env;
+typedef struct napi_value__ *napi_value;
+typedef struct napi_ref__ *napi_ref;
+typedef struct napi_callback_info__ *napi_callback_info;
+typedef struct napi_deferred__ *napi_deferred;
+typedef struct napi_async_work__ *napi_async_work;
+typedef struct napi_threadsafe_function__ *napi_threadsafe_function;
+
+#endif // JEMOC_STREAM_TEST_NAPITYPES_H
@@ -0,0 +1,42 @@
+//
+// Created on 2025/3/8.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#ifndef JEMOC_STREAM_TEST_PAGEALLOCATOR_H
+#define JEMOC_STREAM_TEST_PAGEALLOCATOR_H
+
+#include "common.h"
+#include <cstddef>
+
+namespace jemoc_stream {
+
+/**
+ * 大块内存的分配策略。小于MmapThreshold的分配走new[]，由malloc复用已释放的内存；
+ * 不小于它的直接mmap匿名页，按2MB对齐大小并建议内核使用透明大页，减少TLB miss和缺页次数。
+ * mmap出来的内存扩容时使用mremap，由内核搬移页表，不拷贝数据。
+ * 是否走mmap只由大小决定，所以deallocate/reallocate必须传入分配时的大小
+ */
+class PageAllocator {
+public:
+    static constexpr size_t PageSize = 4096;
+    static constexpr size_t HugePageSize = 2 * 1024 * 1024;
+    // 低于一个大页时mmap的系统调用和首次缺页比malloc复用更慢
+    static constexpr size_t MmapThreshold = HugePageSize;
+    static constexpr size_t HugePageThreshold = HugePageSize;
+
+    static size_t alignPage(size_t size) { return (size + PageSize - 1) & ~(PageSize - 1); }
+    // 按分配策略对齐容量：mmap区间按页对齐，可用大页时按2MB对齐
+    static size_t alignCapacity(size_t size);
+    static bool isMapped(size_t size) { return size >= MmapThreshold; }
+
+    static byte *allocate(size_t size);
+    // used为需要保留的数据长度，两端都是mmap时原地mremap，否则分配新内存并拷贝used字节
+    static byte *reallocate(byte *buffer, size_t oldSize, size_t newSize, size_t used);
+    static void deallocate(byte *buffer, size_t size);
+};
+
+} // namespace jemoc_stream
+
+#endif // JEMOC_STREAM_TEST_PAGEALLOCATOR_H
@@ -0,0 +1,53 @@
+//
+// Created on 2025/2/18.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#ifndef JEMOC_STREAM_TEST_BROTLIBINDING_H
+#define JEMOC_STREAM_TEST_BROTLIBINDING_H
+
+#include "binding/StreamBinding.h"
+#include "stream/BrotliStream.h"
+
+static void getBrotliConfig(napi_env env, napi_value value, BrotliConfig &config) {
+    napi_valuetype type;
+    napi_value jsVal;
+    NAPI_CALL(env, napi_get_named_property(env, value, "quality", &jsVal))
+    NAPI_CALL(env, napi_typeof(env, jsVal, &type))
+    if (type == napi_number) {
+        config.quality = std::max(BROTLI_MIN_QUALITY, std::min(BROTLI_MAX_QUALITY, getInt(env, jsVal)));
+    }
+    NAPI_CALL(env, napi_get_named_property(env, value, "lgWin", &jsVal))
+    NAPI_CALL(env, napi_typeof(env, jsVal, &type))
+    if (type == napi_number) {
+        config.lgWin = std::max(BROTLI_MIN_WINDOW_BITS, std::min(BROTLI_MAX_WINDOW_BITS, getInt(env, jsVal)));
+    }
+    NAPI_CALL(env, napi_get_named_property(env, value, "mode", &jsVal))
+    NAPI_CALL(env, napi_typeof(env, jsVal, &type))
+    if (type == napi_number) {
+        config.mode = std::max(0, std::min(2, getInt(env, jsVal)));
+    }
+}
+
+class BrotliJs {
+    struct AsyncData {
+        napi_async_work work;
+        napi_deferred deferred;
+        std::pair<std::shared_ptr<uint8_t>, size_t> buffer;
+        napi_value result;
+        BrotliConfig config;
+    };
+
+public:
+    static napi_value JSDecompress(napi_env env, napi_callback_info info);
+    static napi_value JSCompress(napi_env env, napi_callback_info info);
+    static void Export(napi_env env, napi_value exports);
+    static napi_value JSDecompressCore(napi_env env, void *buffer, size_t length);
+    static napi_value JSCompressCore(napi_env env, void *buffer, size_t length, const BrotliConfig &config);
+    static std::pair<std::shared_ptr<uint8_t>, size_t> GetBuffer(napi_env env, napi_value value);
+    static napi_value JSDecompressAsync(napi_env env, napi_callback_info info);
+    static napi_value JSCompressAsync(napi_env env, napi_callback_info info);
+};
+
+#endif // JEMOC_STREAM_TEST_BROTLIBINDING_H
@@ -0,0 +1,164 @@
+//
+// Created on 2025/1/8.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#ifndef JEMOC_STREAM_TEST_STREAMBINDING_H
+#define JEMOC_STREAM_TEST_STREAMBINDING_H
+
+#include "IStream.h"
+#include "binding/NapiHelper.h"
+#include <napi/native_api.h>
+
+/**
+ * IStream及各个流的js绑定公用的宏和参数解析，只在binding目录中使用
+ */
+
+struct AsyncWorkData {
+    void *buffer;
+    long offset;
+    long count;
+    long result;
+    long bufferSize;
+    IStream *stream;
+    IStream *targetStream;
+    napi_deferred deferred;
+    napi_async_work work;
+};
+
+static void getToArrayBufferOptions(napi_env env, napi_value value, long *offset, long *length) {
+    napi_valuetype type;
+    NAPI_CALL(env, napi_typeof(env, value, &type))
+    if (type != napi_object)
+        return;
+
+    napi_value jsVal;
+    NAPI_CALL(env, napi_get_named_property(env, value, "offset", &jsVal))
+    NAPI_CALL(env, napi_typeof(env, jsVal, &type))
+    if (napi_number == type) {
+        long len = 0;
+        NAPI_CALL(env, napi_get_value_int64(env, jsVal, &len))
+        *offset = std::max(0l, std::min(*length, len));
+        *length = *length - *offset;
+    }
+
+    NAPI_CALL(env, napi_get_named_property(env, value, "length", &jsVal))
+    NAPI_CALL(env, napi_typeof(env, jsVal, &type))
+    if (napi_number == type) {
+        long len = 0;
+        NAPI_CALL(env, napi_get_value_int64(env, jsVal, &len))
+        *length = std::max(0l, std::min(*length, len));
+    }
+}
+
+#define GET_JS_INFO_WITHOUT_CHECK(count)                                                                               \
+    GET_JS_INFO_WITHOUT_STREAM(count)                                                                                  \
+    std::shared_ptr<IStream> stream = IStream::GetStream(env, _this);
+
+
+#define GET_JS_INFO_WITHOUT_STREAM(count)                                                                              \
+    napi_value _this = nullptr;                                                                                        \
+    size_t argc = count;                                                                                               \
+    napi_value argv[count];                                                                                            \
+    void *className;                                                                                                   \
+    napi_get_cb_info(env, info, &argc, argv, &_this, &className);                                                      \
+    const char *tagName = static_cast<char *>(className);
+
+#define GET_JS_INFO(count)                                                                                             \
+    GET_JS_INFO_WITHOUT_STREAM(count)                                                                                  \
+    std::shared_ptr<IStream> stream = IStream::GetStream(env, _this);                                                  \
+    if (stream == nullptr) {                                                                                           \
+        napi_throw_error(env, ClassName.c_str(), "stream is null");                                                    \
+    }                                                                                                                  \
+    if (stream->isClose()) {                                                                                           \
+        napi_throw_error(env, ClassName.c_str(), "stream is closed");                                                  \
+    }
+
+#define RETURN_NAPI_VALUE(func, value)                                                                                 \
+    napi_value result = nullptr;                                                                                       \
+    func(env, value, &result);                                                                                         \
+    return result;
+
+#define RETURN_BOOL(value) RETURN_NAPI_VALUE(napi_get_boolean, value);
+
+#define DEFINE_ISTREAM_GET_BOOL_FUNCTION(func, func1)                                                                  \
+    napi_value IStream::func(napi_env env, napi_callback_info info) {                                                  \
+        GET_JS_INFO(0)                                                                                                 \
+        RETURN_NAPI_VALUE(napi_get_boolean, stream->func1());                                                          \
+    }
+
+#define DEFINE_ISTREAM_GET_STATE(jsfunc, funname)                                                                      \
+    napi_value IStream::jsfunc(napi_env env, napi_callback_info info) {                                                \
+        GET_JS_INFO_WITHOUT_CHECK(0)                                                                                   \
+        bool value = false;                                                                                            \
+        if (!(stream == nullptr || stream->isClose())) {                                                               \
+            value = stream->funname();                                                                                 \
+        }                                                                                                              \
+        napi_value result = nullptr;                                                                                   \
+        NAPI_CALL(env, napi_get_boolean(env, value, &result))                                                          \
+        return result;                                                                                                 \
+    }
+
+
+#define DEFINE_ISTREAM_GET_LONG_FUNCTION(func, func1)                                                                  \
+    napi_value IStream::func(napi_env env, napi_callback_info info) {                                                  \
+        GET_JS_INFO_WITHOUT_CHECK(0)                                                                                   \
+        if (stream == nullptr || stream->isClose()) {                                                                  \
+            napi_throw_error(env, tagName, "stream is closed");                                                        \
+        }                                                                                                              \
+        try {                                                                                                          \
+            long resultVal = stream->func1();                                                                          \
+            napi_value result = nullptr;                                                                               \
+            napi_create_int64(env, resultVal, &result);                                                                \
+            return result;                                                                                             \
+        } catch (const std::ios_base::failure &e) {                                                                    \
+            napi_throw_error(env, tagName, e.what());                                                                  \
+        }                                                                                                              \
+        return nullptr;                                                                                                \
+    }
+
+#define DEFINE_ISTREAM_SET_FUNC(func, func1)                                                                           \
+    napi_value IStream::func(napi_env env, napi_callback_info info) {                                                  \
+        GET_JS_INFO(1)                                                                                                 \
+        long val = 0;                                                                                                  \
+        napi_get_value_int64(env, argv[0], &val);                                                                      \
+        stream->func1(val);                                                                                            \
+        return nullptr;                                                                                                \
+    }
+
+#define DEFINE_NAPI_ISTREAM_PROPERTY(className)                                                                        \
+    DEFINE_NAPI_FUNCTION("canRead", nullptr, IStream::JSGetCanRead, nullptr, className),                               \
+        DEFINE_NAPI_FUNCTION("canWrite", nullptr, IStream::JSGetCanWrite, nullptr, className),                         \
+        DEFINE_NAPI_FUNCTION("canSeek", nullptr, IStream::JSGetCanSeek, nullptr, className),                           \
+        DEFINE_NAPI_FUNCTION("position", nullptr, IStream::JSGetPosition, nullptr, className),                         \
+        DEFINE_NAPI_FUNCTION("length", nullptr, IStream::JSGetLength, IStream::JSSetLength, className),                \
+        DEFINE_NAPI_FUNCTION("copyTo", IStream::JSCopyTo, nullptr, nullptr, className),                                \
+        DEFINE_NAPI_FUNCTION("seek", IStream::JSSeek, nullptr, nullptr, className),                                    \
+        DEFINE_NAPI_FUNCTION("read", IStream::JSRead, nullptr, nullptr, className),                                    \
+        DEFINE_NAPI_FUNCTION("write", IStream::JSWrite, nullptr, nullptr, className),                                  \
+        DEFINE_NAPI_FUNCTION("readv", IStream::JSReadv, nullptr, nullptr, className),                                  \
+        DEFINE_NAPI_FUNCTION("writev", IStream::JSWritev, nullptr, nullptr, className),                                \
+        DEFINE_NAPI_FUNCTION("readAt", IStream::JSReadAt, nullptr, nullptr, className),                                \
+        DEFINE_NAPI_FUNCTION("writeAt", IStream::JSWriteAt, nullptr, nullptr, className),                              \
+        DEFINE_NAPI_FUNCTION("flush", IStream::JSFlush, nullptr, nullptr, className),                                  \
+        DEFINE_NAPI_FUNCTION("close", IStream::JSClose, nullptr, nullptr, className),                                  \
+        DEFINE_NAPI_FUNCTION("readAsync", IStream::JSReadAsync, nullptr, nullptr, className),                          \
+        DEFINE_NAPI_FUNCTION("writeAsync", IStream::JSWriteAsync, nullptr, nullptr, className),                        \
+        DEFINE_NAPI_FUNCTION("copyToAsync", IStream::JSCopyToAsync, nullptr, nullptr, className),                      \
+        DEFINE_NAPI_FUNCTION("flushAsync", IStream::JSFlushAsync, nullptr, nullptr, className),                        \
+        DEFINE_NAPI_FUNCTION("closeAsync", IStream::JSCloseAsync, nullptr, nullptr, className),                        \
+        DEFINE_NAPI_FUNCTION("isClosed", nullptr, IStream::JSGetIsClosed, nullptr, className),                        \
+        DEFINE_NAPI_FUNCTION("stats", nullptr, IStream::JSGetStats, nullptr, className),                               \
+        DEFINE_NAPI_FUNCTION("statsEnabled", nullptr, IStream::JSGetStatsEnabled, IStream::JSSetStatsEnabled,          \
+                             className),                                                                               \
+        DEFINE_NAPI_FUNCTION("resetStats", IStream::JSResetStats, nullptr, nullptr, className),                        \
+        DEFINE_NAPI_FUNCTION("slice", IStream::JSSlice, nullptr, nullptr, className)
+
+
+#define CHECK_STREAM                                                                                                   \
+    if (stream->isClose()) {                                                                                           \
+        napi_throw_error(env, tagName, "stream is closed");                                                            \
+    }
+
+#endif // JEMOC_STREAM_TEST_STREAMBINDING_H
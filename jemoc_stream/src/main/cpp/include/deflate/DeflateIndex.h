@@ -0,0 +1,80 @@
+//
+// Created on 2025/3/11.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#ifndef JEMOC_STREAM_TEST_DEFLATEINDEX_H
+#define JEMOC_STREAM_TEST_DEFLATEINDEX_H
+
+#include "IStream.h"
+#include "NapiTypes.h"
+#include "common.h"
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * deflate流的随机访问索引，与zlib示例zran的做法相同：解压时每隔span字节输出，在deflate块边界记录一个访问点，
+ * 保存压缩数据偏移、未读完的比特和此前32KB的解压窗口。seek时从不超过目标的最近访问点以raw inflate恢复，
+ * 只需解压不到span字节即可到达目标位置。
+ * 索引可通过writeTo写入旁路文件或内存流，再由ReadFrom加载复用；多gzip成员的流只索引第一个成员
+ */
+class DeflateIndex {
+public:
+    static constexpr uint64_t DefaultSpan = 1024 * 1024;
+    static constexpr size_t WindowSize = 32 * 1024;
+
+    struct AccessPoint {
+        // 访问点在解压数据中的偏移
+        uint64_t output = 0;
+        // 访问点在压缩数据中的偏移，bits不为0时前一个字节还有bits位属于下一块
+        uint64_t input = 0;
+        int bits = 0;
+        byte value = 0;
+        std::vector<byte> window;
+    };
+
+    explicit DeflateIndex(uint64_t span = DefaultSpan);
+
+    uint64_t getSpan() const { return m_span; }
+    size_t getCount() const;
+    bool isComplete() const;
+    // 索引完整时为解压后的总长度，否则为-1
+    long getLength() const;
+
+    // 解压偏移output处是否需要新增访问点
+    bool needPoint(uint64_t output) const;
+    void addPoint(AccessPoint point);
+    void setComplete(uint64_t length);
+    // 查找解压偏移不超过offset的最后一个访问点，访问点只增不删，返回的指针一直有效
+    const AccessPoint *find(uint64_t offset) const;
+
+    // 序列化格式：头部、访问点列表，窗口以zlib压缩保存
+    void writeTo(IStream *stream) const;
+    static std::shared_ptr<DeflateIndex> ReadFrom(IStream *stream);
+
+    static std::string ClassName;
+    static napi_ref cons;
+    static std::shared_ptr<DeflateIndex> GetIndex(napi_env env, napi_value value);
+    static napi_value JSConstructor(napi_env env, napi_callback_info info);
+    static void JSDispose(napi_env env, void *data, void *hint);
+    static napi_value JSGetSpan(napi_env env, napi_callback_info info);
+    static napi_value JSGetCount(napi_env env, napi_callback_info info);
+    static napi_value JSGetComplete(napi_env env, napi_callback_info info);
+    static napi_value JSGetLength(napi_env env, napi_callback_info info);
+    static napi_value JSWriteTo(napi_env env, napi_callback_info info);
+    static napi_value JSReadFrom(napi_env env, napi_callback_info info);
+    static void Export(napi_env env, napi_value exports);
+
+private:
+    uint64_t m_span;
+    bool m_complete = false;
+    uint64_t m_length = 0;
+    // 多个DeflateStream可共用一个索引，可能在不同线程上读取
+    mutable std::mutex m_mutex;
+    std::deque<AccessPoint> m_points;
+};
+
+#endif // JEMOC_STREAM_TEST_DEFLATEINDEX_H
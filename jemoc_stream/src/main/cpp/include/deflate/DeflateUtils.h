@@ -0,0 +1,42 @@
+//
+// Created on 2025/3/12.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#ifndef JEMOC_STREAM_TEST_DEFLATEUTILS_H
+#define JEMOC_STREAM_TEST_DEFLATEUTILS_H
+
+#include "NapiTypes.h"
+#include "common.h"
+#include "zlib-ng.h"
+#include <vector>
+
+/**
+ * 一次性的内存到内存压缩/解压，windowBits与Deflater相同：负数为raw deflate，9~15为zlib，25~31为gzip。
+ * zng_stream从ZStreamPool取用，调用之间只deflateReset/inflateReset2，不重新分配内部状态；
+ * 压缩按deflateBound一次分配足够的输出，单次deflate(Z_FINISH)完成
+ */
+class DeflateUtils {
+public:
+    struct Options {
+        int level = Z_DEFAULT_COMPRESSION;
+        int windowBits = -15;
+        int strategy = Z_DEFAULT_STRATEGY;
+        // 解压后大小，已知时一次分配输出
+        long uncompressSize = -1;
+    };
+
+    // 输出写入output，output只会扩大不会缩小，可在多次调用间复用，返回输出字节数
+    static size_t compress(const byte *data, size_t length, std::vector<byte> &output, const Options &options);
+    // 多个gzip成员拼接的输入会全部解压
+    static size_t decompress(const byte *data, size_t length, std::vector<byte> &output, const Options &options);
+
+    static napi_value JSCompress(napi_env env, napi_callback_info info);
+    static napi_value JSDecompress(napi_env env, napi_callback_info info);
+    static napi_value JSCompressAsync(napi_env env, napi_callback_info info);
+    static napi_value JSDecompressAsync(napi_env env, napi_callback_info info);
+    static void Export(napi_env env, napi_value exports);
+};
+
+#endif // JEMOC_STREAM_TEST_DEFLATEUTILS_H
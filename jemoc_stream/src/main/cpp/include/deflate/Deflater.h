@@ -6,28 +6,14 @@
 
 #ifndef JEMOC_STREAM_TEST_DEFLATER_H
 #define JEMOC_STREAM_TEST_DEFLATER_H
+#include "NapiTypes.h"
 #include "zlib-ng.h"
 #include <cstddef>
 #include <mutex>
-#include <napi/native_api.h>
 
 #define Min_WINDOW_BITS -15
 #define Max_WINDOW_BITS 31
 
-#define GET_DEFLATER_INFO(number)                                                                                      \
-    size_t argc = number;                                                                                              \
-    napi_value argv[number];                                                                                           \
-    napi_value _this = nullptr;                                                                                        \
-    napi_get_cb_info(env, info, &argc, argv, &_this, nullptr);
-
-#define GET_DEFLATER_INFO_WITH_DEFLATER(number)                                                                        \
-    GET_DEFLATER_INFO(number)                                                                                          \
-    void *p = nullptr;                                                                                                 \
-    napi_unwrap(env, _this, &p);                                                                                       \
-    if (p == nullptr)                                                                                                  \
-        napi_throw_error(env, "Deflater", "deflater is disposed");                                                     \
-    Deflater *deflater = static_cast<Deflater *>(p);
-
 class Deflater {
 public:
     Deflater(int windowBits, int level, int strategy);
@@ -6,36 +6,34 @@
 
 #ifndef JEMOC_STREAM_TEST_INFLATER_H
 #define JEMOC_STREAM_TEST_INFLATER_H
-#include <napi/native_api.h>
+#include "NapiTypes.h"
+#include "deflate/DeflateIndex.h"
 #include "zlib-ng.h"
 
 #define GZIP_Header_ID1 31
 #define GZIP_Header_ID2 139
 
-#define GET_INFLATER_INFO(number)                                                                                      \
-    size_t argc = number;                                                                                              \
-    napi_value argv[number];                                                                                           \
-    napi_value _this = nullptr;                                                                                        \
-    napi_get_cb_info(env, info, &argc, argv, &_this, nullptr);
-
-#define GET_INFLATER_INFO_WITH_INFLATER(number)                                                                        \
-    GET_INFLATER_INFO(number)                                                                                          \
-    void *p = nullptr;                                                                                                 \
-    napi_unwrap(env, _this, &p);                                                                                       \
-    if (p == nullptr)                                                                                           \
-        napi_throw_error(env, "Inflater", "inflater is disposed");                                                     \
-    Inflater *inflater = static_cast<Inflater *>(p);
-
 class Inflater {
 public:
     Inflater(int windowBits, long uncompressedSize = -1);
     ~Inflater();
 
     bool isFinished() const;
-    long inflate(void *buffer, size_t count);
+    // flushCode为Z_BLOCK时在每个deflate块结束处返回，用于建立DeflateIndex
+    long inflate(void *buffer, size_t count, int flushCode = Z_NO_FLUSH);
     bool needInput() const;
     bool isGzipStream() const;
     void setInput(void *buffer, size_t count);
+    size_t getAvailIn() const;
+
+    // 停在非最后一个deflate块的结尾，可在此记录访问点
+    bool atBlockBoundary() const;
+    // 填充访问点的比特位和解压窗口，偏移由调用方填写
+    void getAccessPoint(DeflateIndex::AccessPoint *point) const;
+    // 从访问点以raw inflate继续解压，之后从point.input处提供输入
+    void resume(const DeflateIndex::AccessPoint &point);
+    // 回到流的开头重新解压
+    void reset();
 
 public:
     static napi_value JSConstructor(napi_env env, napi_callback_info info);
@@ -50,7 +48,7 @@ public:
     static void Export(napi_env env, napi_value exports);
 
 private:
-    long readOutput(void *buffer, size_t count);
+    long readOutput(void *buffer, size_t count, int flushCode);
     long readInflateOutput(void *buffer, size_t count, int flushCode, int *state);
     int inflate_(int flushCode);
     bool resetStreamForLeftoverInput();
@@ -0,0 +1,96 @@
+//
+// Created on 2025/3/10.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#ifndef JEMOC_STREAM_TEST_PARALLELDEFLATER_H
+#define JEMOC_STREAM_TEST_PARALLELDEFLATER_H
+
+#include "IStream.h"
+#include "common.h"
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * 多线程压缩，与pigz相同的做法：输入按blockSize切成独立的块，每块以前32KB输入作为字典，在工作线程上各自压缩成
+ * raw deflate，非最后一块以Z_SYNC_FLUSH结尾保证字节对齐，按顺序拼接后仍是一个合法的deflate流。
+ * windowBits与Deflater含义相同，zlib/gzip格式的头和尾由本类写出，校验值通过adler32_combine/crc32_combine合并。
+ * 压缩结果只在调用线程上按顺序写入output，同时在途的块不超过threads * 2
+ */
+class ParallelDeflater {
+public:
+    static constexpr size_t DefaultBlockSize = 128 * 1024;
+    static constexpr size_t DictionarySize = 32 * 1024;
+    // 超出上限时构造抛出异常，避免过大的值在创建线程或分配块缓冲区时才失败
+    static constexpr int MaxThreads = 64;
+    static constexpr size_t MaxBlockSize = 64 * 1024 * 1024;
+
+    ParallelDeflater(IStream *output, int windowBits, int level, int strategy, int threads,
+                     size_t blockSize = DefaultBlockSize);
+    ~ParallelDeflater();
+    ParallelDeflater(const ParallelDeflater &) = delete;
+    ParallelDeflater &operator=(const ParallelDeflater &) = delete;
+
+    void write(const byte *buffer, size_t count);
+    // 提交未满的块并等待全部写出，输出以Z_SYNC_FLUSH结束，与Deflater::flush一致
+    void flush();
+    // 提交最后一块并写出流尾，之后不能再写入
+    void finish();
+
+    int getThreads() const { return m_threads; }
+    size_t getBlockSize() const { return m_blockSize; }
+
+private:
+    enum Format { Raw, Zlib, Gzip };
+    struct Job {
+        std::vector<byte> input;
+        std::vector<byte> dictionary;
+        std::vector<byte> output;
+        bool last = false;
+        bool done = false;
+        uint32_t check = 0;
+        std::exception_ptr error;
+    };
+
+    void submit(bool last);
+    // 写出已完成的块，wait为true时等待队首的块完成
+    void drain(bool waitAll);
+    void writeJob(Job &job);
+    void writeHeader();
+    void work();
+
+    IStream *m_output;
+    Format m_format;
+    int m_rawWindowBits;
+    int m_level;
+    int m_strategy;
+    int m_threads;
+    size_t m_blockSize;
+
+    std::vector<byte> m_block;
+    // 最近DictionarySize字节的输入，作为下一块的字典
+    std::vector<byte> m_window;
+    std::vector<std::vector<byte>> m_freeBuffers;
+    bool m_headerWritten = false;
+    bool m_finished = false;
+    uint32_t m_check;
+    uint64_t m_totalIn = 0;
+
+    std::mutex m_mutex;
+    std::condition_variable m_workCondition;
+    std::condition_variable m_doneCondition;
+    // 按提交顺序排列，写出后移除
+    std::deque<std::shared_ptr<Job>> m_jobs;
+    std::deque<std::shared_ptr<Job>> m_pending;
+    std::vector<std::thread> m_workers;
+    int m_idleWorkers = 0;
+    bool m_stopping = false;
+};
+
+#endif // JEMOC_STREAM_TEST_PARALLELDEFLATER_H
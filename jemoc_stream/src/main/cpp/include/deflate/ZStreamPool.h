@@ -0,0 +1,32 @@
+//
+// Created on 2025/3/13.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#ifndef JEMOC_STREAM_TEST_ZSTREAMPOOL_H
+#define JEMOC_STREAM_TEST_ZSTREAMPOOL_H
+
+#include "zlib-ng.h"
+#include <cstddef>
+
+/**
+ * 线程内的zng_stream复用池。deflateInit2要分配约256KB的窗口和哈希表，Zip中大量小条目时初始化占了大部分时间；
+ * 归还时deflateReset/inflateReset后留在当前线程，下次按windowBits、等级和策略取用，只有等级或策略不同时再deflateParams。
+ * 在哪个线程归还就留在哪个线程的池中，线程退出时释放
+ */
+class ZStreamPool {
+public:
+    // 每个线程最多保留的空闲压缩流、解压流数量，超出时释放最早归还的
+    static constexpr size_t MaxIdleDeflaters = 4;
+    static constexpr size_t MaxIdleInflaters = 4;
+
+    // 初始化失败时返回nullptr
+    static zng_stream *acquireDeflater(int windowBits, int level, int strategy);
+    // 参数需与acquireDeflater时相同
+    static void releaseDeflater(zng_stream *stream, int windowBits, int level, int strategy);
+    static zng_stream *acquireInflater(int windowBits);
+    static void releaseInflater(zng_stream *stream);
+};
+
+#endif // JEMOC_STREAM_TEST_ZSTREAMPOOL_H
@@ -8,6 +8,9 @@
 #define JEMOC_STREAM_TEST_ENCODINGCONVERTER_H
 #include "iostream"
 #include <iconv.h>
+#include <memory>
+#include <string>
+#include <vector>
 
 class EncodingConverter {
 public:
@@ -344,8 +344,8 @@ private:
 
     void ReadCDATA() {
         // Verify CDATA start
-        const char* expected = "CDATA[";
-        for (int i = 0; i < 6; ++i) {
+        const char* expected = "[CDATA[";
+        for (int i = 0; i < 7; ++i) {
             if (reader->Read() != expected[i]) {
                 throw std::runtime_error("Invalid CDATA section");
             }
@@ -0,0 +1,107 @@
+//
+// Created on 2025/3/9.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#ifndef JEMOC_STREAM_TEST_ASYNCFILEIO_H
+#define JEMOC_STREAM_TEST_ASYNCFILEIO_H
+
+#include "common.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <sys/uio.h>
+#include <thread>
+#include <vector>
+
+/**
+ * 单个文件的异步定位读写引擎，同一时间最多depth个请求在执行。
+ * 内核支持时通过io_uring提交，请求在内核中排队，由一个收割线程等待完成事件；
+ * io_uring不可用(内核过旧或被seccomp禁止)时退回depth个线程并发pread/pwrite。
+ * 完成的请求放入完成列表，完成列表由空变为非空时调用一次notify，与AsyncIoQueue一致
+ */
+class AsyncFileIo {
+public:
+    class Request {
+    public:
+        virtual ~Request() = default;
+        bool write = false;
+        byte *buffer = nullptr;
+        size_t length = 0;
+        // 文件内偏移
+        long offset = 0;
+        // 已完成的字节数，失败时error为errno
+        long result = 0;
+        int error = 0;
+        // registerBuffers注册的缓冲区下标，-1表示普通内存
+        int bufferIndex = -1;
+    };
+
+    AsyncFileIo(int fd, int depth, bool useUring = true);
+    ~AsyncFileIo();
+    AsyncFileIo(const AsyncFileIo &) = delete;
+    AsyncFileIo &operator=(const AsyncFileIo &) = delete;
+
+    // notify在收割线程或工作线程上调用，不能阻塞
+    void setNotify(std::function<void()> notify) { m_notify = std::move(notify); }
+    // 引擎销毁时仍在完成列表中、没有被takeCompleted取走的请求交给此回调，由调用方结束对应的异步操作；未设置时直接释放
+    void setUncollectedHandler(std::function<void(std::vector<std::unique_ptr<Request>>)> handler) {
+        m_uncollectedHandler = std::move(handler);
+    }
+    void submit(std::unique_ptr<Request> request);
+    std::vector<std::unique_ptr<Request>> takeCompleted();
+    // 等待已提交的请求全部完成
+    void drain();
+
+    /**
+     * 把一组缓冲区注册为io_uring固定缓冲区，之后落在其中的请求使用READ_FIXED/WRITE_FIXED，内核不必每次锁定页面。
+     * 再次调用会替换之前的注册，未使用io_uring或注册失败时返回false
+     */
+    bool registerBuffers(const std::vector<struct iovec> &buffers);
+    // 返回完整包含[buffer, buffer + length)的已注册缓冲区下标，没有时返回-1
+    int findRegisteredBuffer(const byte *buffer, size_t length) const;
+
+    bool isUringEnabled() const { return m_ring != nullptr; }
+    const char *getEngine() const { return m_ring != nullptr ? "io_uring" : "thread"; }
+    int getDepth() const { return m_depth; }
+
+private:
+    struct Ring;
+    // 提交时内核资源不足、又没有其他请求在内核中可以等待时的最多重试次数
+    static constexpr int MaxSubmitRetries = 4;
+
+    // 持锁调用，提交失败时请求以errno完成，返回完成列表是否由空变为非空
+    bool submitToRing(Request *request);
+    void reap();
+    void work();
+    // 持锁调用，返回完成列表是否由空变为非空
+    bool complete(Request *request);
+
+    int m_fd;
+    int m_depth;
+    std::unique_ptr<Ring> m_ring;
+    std::vector<struct iovec> m_registered;
+    std::function<void()> m_notify;
+    std::function<void(std::vector<std::unique_ptr<Request>>)> m_uncollectedHandler;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::condition_variable m_idleCondition;
+    std::deque<std::unique_ptr<Request>> m_pending;
+    std::vector<std::unique_ptr<Request>> m_completed;
+    int m_inflight = 0;
+    // io_uring_enter返回EAGAIN/EBUSY后置位，收割到新的完成事件之前提交的请求先排队
+    bool m_ringBusy = false;
+    // io_uring模式下的收割线程，有请求在内核中时运行
+    std::thread m_reaper;
+    bool m_reaping = false;
+    // 线程模式下按需创建，随引擎一起销毁
+    std::vector<std::thread> m_workers;
+    int m_idleWorkers = 0;
+    bool m_stopping = false;
+};
+
+#endif // JEMOC_STREAM_TEST_ASYNCFILEIO_H
@@ -0,0 +1,46 @@
+//
+// Created on 2025/3/9.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#ifndef JEMOC_STREAM_TEST_ASYNCFILESTREAM_H
+#define JEMOC_STREAM_TEST_ASYNCFILESTREAM_H
+
+#include "stream/AsyncFileIo.h"
+#include "stream/FileStream.h"
+
+/**
+ * 异步读写不经过流的AsyncIoQueue，而是交给AsyncFileIo，一个流可以同时有depth个读写在执行。
+ * 提交时就在当前位置预留区间并移动流位置，所以连续的readAsync/writeAsync不必等待前一个完成；
+ * 同步读写、flush、close与普通FileStream一致，flush和close会先等待已提交的异步读写完成
+ */
+class AsyncFileStream : public FileStream {
+public:
+    static constexpr int DefaultDepth = 8;
+
+    AsyncFileStream(const std::string &path, FILE_MODE mode, long bufferSize, int depth, bool useUring = true);
+    AsyncFileStream(const int &fd, FILE_MODE mode, long bufferSize, int depth, bool useUring = true);
+
+    // 在当前位置提交一次读取，流位置立即前移。已到末尾时不提交并返回false
+    bool submitRead(std::unique_ptr<AsyncFileIo::Request> request);
+    void submitWrite(std::unique_ptr<AsyncFileIo::Request> request);
+    AsyncFileIo *getIo() const { return m_io.get(); }
+    void flush() override;
+    void close() override;
+
+public:
+    static std::string ClassName;
+    static void Export(napi_env env, napi_value exports);
+    static napi_value JSConstructor(napi_env env, napi_callback_info info);
+    static napi_value JSReadAsync(napi_env env, napi_callback_info info);
+    static napi_value JSWriteAsync(napi_env env, napi_callback_info info);
+    static napi_value JSRegisterBuffers(napi_env env, napi_callback_info info);
+    static napi_value JSGetDepth(napi_env env, napi_callback_info info);
+    static napi_value JSGetEngine(napi_env env, napi_callback_info info);
+
+private:
+    std::unique_ptr<AsyncFileIo> m_io;
+};
+
+#endif // JEMOC_STREAM_TEST_ASYNCFILESTREAM_H
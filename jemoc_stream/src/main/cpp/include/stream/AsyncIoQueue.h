@@ -0,0 +1,57 @@
+//
+// Created on 2025/3/6.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#ifndef JEMOC_STREAM_TEST_ASYNCIOQUEUE_H
+#define JEMOC_STREAM_TEST_ASYNCIOQUEUE_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * 单个流的异步读写队列。任务按提交顺序在一个专用工作线程上依次执行，执行完成的任务放入完成列表，
+ * 完成列表由空变为非空时调用一次notify，调用方在js线程上通过takeCompleted一次取走全部结果。
+ * 工作线程在首次提交时启动，空闲超过IdleTimeout后退出，下次提交时重新启动
+ */
+class AsyncIoQueue {
+public:
+    class Task {
+    public:
+        virtual ~Task() = default;
+        // 在工作线程上执行
+        virtual void execute() = 0;
+    };
+
+    static constexpr int IdleTimeout = 1000;
+
+    AsyncIoQueue() = default;
+    ~AsyncIoQueue();
+    AsyncIoQueue(const AsyncIoQueue &) = delete;
+    AsyncIoQueue &operator=(const AsyncIoQueue &) = delete;
+
+    // notify在工作线程上调用，不能阻塞
+    void setNotify(std::function<void()> notify) { m_notify = std::move(notify); }
+    void submit(std::unique_ptr<Task> task);
+    std::vector<std::unique_ptr<Task>> takeCompleted();
+
+private:
+    void run();
+
+    std::function<void()> m_notify;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<std::unique_ptr<Task>> m_pending;
+    std::vector<std::unique_ptr<Task>> m_completed;
+    std::thread m_worker;
+    bool m_running = false;
+    bool m_stopping = false;
+};
+
+#endif // JEMOC_STREAM_TEST_ASYNCIOQUEUE_H
@@ -11,7 +11,7 @@
 #include "common.h"
 #include "deflate/Deflater.h"
 #include "deflate/Inflater.h"
-#include <napi/native_api.h>
+#include "deflate/ParallelDeflater.h"
 
 #define DEFAULT_BUFFER_SIZE 8192
 
@@ -20,8 +20,12 @@ enum DeflateMode { DeflateMode_Compress, DeflateMode_Decompress };
 
 class DeflateStream : public IStream {
 public:
+    /**
+     * 压缩模式下threads大于1时由ParallelDeflater在多个线程上按blockSize分块压缩，blockSize为0时使用默认块大小
+     */
     DeflateStream(std::shared_ptr<IStream> stream, DeflateMode mode, int windowBits, int compressionLevel,
-                  bool leaveOpen, size_t bufferSize = 8192, long uncompressSize = -1);
+                  bool leaveOpen, size_t bufferSize = 8192, long uncompressSize = -1, int threads = 1,
+                  size_t blockSize = 0);
     ~DeflateStream();
 
     void close() override;
@@ -31,7 +35,14 @@ public:
     long getPosition() const override;
     long getLength() const override;
     long seek(long offset, SeekOrigin origin) override;
-    void close(napi_env env) override;
+    // 关闭流并释放构造时持有的底层流js对象，由js绑定层调用
+    void close(napi_env env);
+    /**
+     * 解压模式下绑定访问点索引，需在第一次读取前调用。索引未完整时边读边记录访问点；
+     * 底层流可seek时支持seek和getPosition，从最近的访问点恢复解压，索引完整后支持getLength
+     */
+    void setIndex(std::shared_ptr<DeflateIndex> index);
+    std::shared_ptr<DeflateIndex> getIndex() const { return m_index; }
 
     static std::string ClassName;
     static napi_ref cons;
@@ -47,6 +58,10 @@ private:
     void writeDeflaterOutput();
     void flushBuffers();
     void purgeBuffers();
+    long readIndexed(void *buffer, size_t count);
+    bool fillInput();
+    void restart(const DeflateIndex::AccessPoint *point);
+    void skip(uint64_t count);
 
 private:
     bool m_wroteBytes = false;
@@ -58,8 +73,13 @@ private:
     DeflateMode m_mode;
     std::shared_ptr<IStream> m_stream;
     Deflater *deflater = nullptr;
+    ParallelDeflater *parallelDeflater = nullptr;
     Inflater *inflater = nullptr;
     void *m_buffer = nullptr;
+    std::shared_ptr<DeflateIndex> m_index;
+    // 压缩数据在底层流中的起始位置，以及已交给inflater的压缩数据字节数
+    long m_inputStart = 0;
+    uint64_t m_inputFed = 0;
 };
 
 #endif // JEMOC_STREAM_TEST_DEFLATESTREAM_H
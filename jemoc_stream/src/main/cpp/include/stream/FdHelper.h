@@ -0,0 +1,240 @@
+//
+// Created on 2025/3/2.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#ifndef JEMOC_STREAM_TEST_FDHELPER_H
+#define JEMOC_STREAM_TEST_FDHELPER_H
+
+#include <algorithm>
+#include <fcntl.h>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <ios>
+#include <string>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <vector>
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
+namespace FdHelper {
+
+/**
+ * 截取iov，使其总长度不超过maxBytes
+ * @param iov
+ * @param iovcnt
+ * @param maxBytes
+ * @return 截取后的iov
+ */
+inline std::vector<struct iovec> clampIov(const struct iovec *iov, int iovcnt, size_t maxBytes) {
+    std::vector<struct iovec> result;
+    result.reserve(iovcnt);
+    for (int i = 0; i < iovcnt && maxBytes > 0; i++) {
+        size_t len = std::min(iov[i].iov_len, maxBytes);
+        if (len == 0)
+            continue;
+        result.push_back({iov[i].iov_base, len});
+        maxBytes -= len;
+    }
+    return result;
+}
+
+/**
+ * 以position为起点把数据读入iov，不移动fd的文件指针。读到文件末尾时返回的长度可能小于iov总长度
+ * @param fd
+ * @param iov
+ * @param iovcnt
+ * @param position
+ * @return 实际读取大小
+ */
+inline long preadvAll(int fd, const struct iovec *iov, int iovcnt, off_t position) {
+    long total = 0;
+    while (iovcnt > 0) {
+        int count = std::min(iovcnt, IOV_MAX);
+        size_t expected = 0;
+        for (int i = 0; i < count; i++) {
+            expected += iov[i].iov_len;
+        }
+        ssize_t bytesRead = ::preadv(fd, iov, count, position + total);
+        if (bytesRead < 0) {
+            if (errno == EINTR)
+                continue;
+            throw std::ios_base::failure(std::string("preadv failed: ") + std::strerror(errno));
+        }
+        total += bytesRead;
+        if (static_cast<size_t>(bytesRead) < expected)
+            break;
+        iov += count;
+        iovcnt -= count;
+    }
+    return total;
+}
+
+/**
+ * 以position为起点把iov完整写入fd，不移动fd的文件指针，内核部分写入时继续写剩余数据
+ * @param fd
+ * @param iov
+ * @param iovcnt
+ * @param position
+ * @return 实际写入大小
+ */
+inline long pwritevAll(int fd, const struct iovec *iov, int iovcnt, off_t position) {
+    std::vector<struct iovec> pending(iov, iov + iovcnt);
+    size_t index = 0;
+    long total = 0;
+    while (index < pending.size()) {
+        int count = static_cast<int>(std::min(pending.size() - index, static_cast<size_t>(IOV_MAX)));
+        ssize_t written = ::pwritev(fd, pending.data() + index, count, position + total);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            throw std::ios_base::failure(std::string("pwritev failed: ") + std::strerror(errno));
+        }
+        if (written == 0)
+            break;
+        total += written;
+        while (written > 0 && index < pending.size()) {
+            if (static_cast<size_t>(written) >= pending[index].iov_len) {
+                written -= pending[index].iov_len;
+                index++;
+            } else {
+                pending[index].iov_base = static_cast<char *>(pending[index].iov_base) + written;
+                pending[index].iov_len -= written;
+                written = 0;
+            }
+        }
+        while (index < pending.size() && pending[index].iov_len == 0) {
+            index++;
+        }
+    }
+    return total;
+}
+
+/**
+ * 从position处读取count字节到buffer，不移动fd的文件指针，读到文件末尾时提前返回
+ * @param fd
+ * @param buffer
+ * @param count
+ * @param position
+ * @return 实际读取大小
+ */
+inline long preadAll(int fd, void *buffer, size_t count, off_t position) {
+    char *pointer = static_cast<char *>(buffer);
+    long total = 0;
+    while (static_cast<size_t>(total) < count) {
+        ssize_t bytesRead = ::pread(fd, pointer + total, count - total, position + total);
+        if (bytesRead < 0) {
+            if (errno == EINTR)
+                continue;
+            throw std::ios_base::failure(std::string("pread failed: ") + std::strerror(errno));
+        }
+        if (bytesRead == 0)
+            break;
+        total += bytesRead;
+    }
+    return total;
+}
+
+/**
+ * 把buffer中count字节完整写入fd的position处，不移动fd的文件指针
+ * @param fd
+ * @param buffer
+ * @param count
+ * @param position
+ * @return 实际写入大小
+ */
+inline long pwriteAll(int fd, const void *buffer, size_t count, off_t position) {
+    const char *pointer = static_cast<const char *>(buffer);
+    long total = 0;
+    while (static_cast<size_t>(total) < count) {
+        ssize_t written = ::pwrite(fd, pointer + total, count - total, position + total);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            throw std::ios_base::failure(std::string("pwrite failed: ") + std::strerror(errno));
+        }
+        if (written == 0)
+            break;
+        total += written;
+    }
+    return total;
+}
+
+/**
+ * 在内核中把inFd从inOffset开始的count字节拷贝到outFd的outOffset处，数据不经过用户态。
+ * 普通文件之间优先使用copy_file_range，不支持时(跨文件系统、内核版本过低)退回sendfile，
+ * 任一端为管道时使用splice。内核路径不可用或出错时提前返回，剩余部分由调用方走缓冲拷贝
+ * @param inFd
+ * @param inOffset
+ * @param outFd
+ * @param outOffset 输出端为管道时忽略
+ * @param count
+ * @return 实际拷贝大小
+ */
+inline long copyRange(int inFd, off_t inOffset, int outFd, off_t outOffset, size_t count) {
+    struct stat inStat, outStat;
+    if (fstat(inFd, &inStat) == -1 || fstat(outFd, &outStat) == -1)
+        return 0;
+    bool inPipe = S_ISFIFO(inStat.st_mode);
+    bool outPipe = S_ISFIFO(outStat.st_mode);
+    if (inPipe && outPipe)
+        return 0;
+
+    enum { COPY_FILE_RANGE, SEND_FILE, SPLICE } mode = (inPipe || outPipe) ? SPLICE : COPY_FILE_RANGE;
+#ifndef __NR_copy_file_range
+    if (mode == COPY_FILE_RANGE)
+        mode = SEND_FILE;
+#endif
+    const size_t maxChunk = 1UL << 30;
+    long total = 0;
+    while (static_cast<size_t>(total) < count) {
+        size_t chunk = std::min(count - total, maxChunk);
+        ssize_t copied = -1;
+        if (mode == SPLICE) {
+            copied = splice(inFd, inPipe ? nullptr : &inOffset, outFd, outPipe ? nullptr : &outOffset, chunk,
+                            SPLICE_F_MOVE);
+        } else if (mode == COPY_FILE_RANGE) {
+#ifdef __NR_copy_file_range
+            loff_t inOff = inOffset, outOff = outOffset;
+            copied = syscall(__NR_copy_file_range, inFd, &inOff, outFd, &outOff, chunk, 0);
+            if (copied < 0 && (errno == ENOSYS || errno == EXDEV || errno == EINVAL || errno == EOPNOTSUPP ||
+                               errno == EBADF)) {
+                mode = SEND_FILE;
+                continue;
+            }
+            if (copied > 0) {
+                inOffset += copied;
+                outOffset += copied;
+            }
+#endif
+        } else {
+            // sendfile写入outFd当前的文件偏移
+            if (lseek(outFd, outOffset, SEEK_SET) == -1)
+                break;
+            copied = sendfile(outFd, inFd, &inOffset, chunk);
+            if (copied > 0)
+                outOffset += copied;
+        }
+        if (copied < 0) {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        if (copied == 0)
+            break;
+        total += copied;
+    }
+    return total;
+}
+
+} // namespace FdHelper
+
+#endif // JEMOC_STREAM_TEST_FDHELPER_H
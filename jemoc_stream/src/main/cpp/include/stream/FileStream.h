@@ -7,7 +7,8 @@
 #ifndef JEMOC_STREAM_TEST_FILESTREAM_H
 #define JEMOC_STREAM_TEST_FILESTREAM_H
 #include "IStream.h"
-#include <fstream>
+#include "stream/IFdStream.h"
+#include <memory>
 
 
 enum FILE_MODE {
@@ -15,35 +16,118 @@ enum FILE_MODE {
     FILE_MODE_WRITE = 0x01,
     FILE_MODE_APPEND = 0x02,
     FILE_MODE_TRUNC = 0x04,
-    FILE_MODE_CREATE = 0x08
+    FILE_MODE_CREATE = 0x08,
+    // 只读映射模式，不能与写入相关的标志同时使用
+    FILE_MODE_MMAP = 0x10,
+    // 写入后分窗口回写并丢弃页缓存，大文件写入不挤占其他数据的缓存
+    FILE_MODE_NOCACHE = 0x20
 };
 
 
-class FileStream : public IStream {
+/**
+ * 基于文件描述符的文件流。读写都通过pread/pwrite按流位置定位，不依赖fd的文件指针，
+ * 用户态缓冲区大小由bufferSize决定，缓冲区同一时间只保存读数据或待写数据中的一种。
+ * bufferSize为0时不使用缓冲区，每次读写直接进入内核。
+ * FILE_MODE_MMAP模式下把文件(或fd的offset~offset+length区间)只读映射到内存，读取直接从映射中拷贝，
+ * getSpan返回映射内的指针供调用方零拷贝解析；映射失败(如空文件、不支持mmap的fd)时退回缓冲读取。
+ * FILE_MODE_NOCACHE模式下连续写满一个窗口就用sync_file_range让内核开始回写，并等待上一个窗口落盘后
+ * 通过POSIX_FADV_DONTNEED丢弃其页缓存，脏页始终不超过两个窗口；setLength和close前把剩余窗口全部落盘
+ */
+class FileStream : public IStream, public IFdStream {
 public:
     FileStream(const std::string &path, FILE_MODE mode, long bufferSize);
     FileStream(const int &fd, FILE_MODE mode, long bufferSize);
-    FileStream(const int &fd, long offset, long length);
+    FileStream(const int &fd, long offset, long length, bool mapped = false);
     ~FileStream();
     long write(void *buffer, long offset, size_t count) override;
+    long readv(const struct iovec *iov, int iovcnt) override;
+    long writev(const struct iovec *iov, int iovcnt) override;
+    long readAt(long position, void *buffer, long offset, size_t count) override;
+    long writeAt(long position, void *buffer, long offset, size_t count) override;
     long read(void *buffer, long offset, size_t count) override;
     void flush() override;
     void close() override;
     void setLength(long length) override;
+    /**
+     * 为文件前length字节预留磁盘空间，不改变文件长度，已知最终大小时减少碎片和写入过程中的元数据更新。
+     * 文件系统不支持时返回false，空间不足时抛出异常。关闭时释放超出实际长度的预留空间
+     */
+    bool preallocate(long length);
+    int getNativeFd() const override;
+    long getNativeOffset() const override { return m_offset; }
+    void syncNativeFd() override;
+    void copyTo(IStream *stream, long bufferSize) override;
+    const byte *getSpan(long position, long length) override;
+    bool isMapped() const { return m_mapView != nullptr; }
 
 public:
     static std::string ClassName;
     static napi_ref cons;
     static void Export(napi_env env, napi_value exports);
     static napi_value JSConstructor(napi_env env, napi_callback_info info);
+    static napi_value JSPreallocate(napi_env env, napi_callback_info info);
 //    static void JSDispose(napi_env env, void *data, void *hint);
 
+private:
+    void init(FILE_MODE mode);
+    static void checkMapMode(FILE_MODE mode);
+    // 把缓冲区中待写数据写入文件
+    void flushWriteBuffer();
+    // 丢弃缓冲区中已读入的数据
+    void discardReadBuffer() { m_readLength = 0; }
+    // 按访问模式调整posix_fadvise，顺序读时加大内核预读，随机读时关闭预读
+    void adviseAccess(long position);
+    // 只读映射整个可读区间，失败时返回false并保持缓冲读取
+    bool mapFile();
+    void unmapFile();
+    void checkWritable() const;
+    // 记录刚写入文件的区间(文件内偏移)，NOCACHE模式下累计满一个窗口时开始回写
+    void writeBehind(long position, long length);
+    // 让内核开始回写当前窗口，并等待上一个窗口落盘后丢弃它的页缓存
+    void startWriteback();
+    void dropWriteback();
+    // 把所有已写入区间落盘并丢弃缓存
+    void finishWriteback();
+
+    // 连续这么多次不连续的读取后按随机访问处理
+    static const int RandomThreshold = 2;
+    // getSpan取出的区间超过这个大小时提前通知内核读入
+    static constexpr long WillNeedThreshold = 64 * 1024;
+    // NOCACHE模式的回写窗口，以及写缓冲区的最小大小，保证每次写入文件的块足够大
+    static constexpr long WriteBehindWindow = 8 * 1024 * 1024;
+    static constexpr long NoCacheBufferSize = 1024 * 1024;
+
 private:
     FILE_MODE m_mode;
     long m_bufferSize;
-    FILE *file = nullptr;
+    int m_fd = -1;
     long m_offset = 0;
     bool m_is_raw_file = false;
+
+    std::unique_ptr<byte[]> m_buffer;
+    // 缓冲区首字节对应的流位置
+    long m_bufferPosition = 0;
+    long m_readLength = 0;
+    long m_writeLength = 0;
+
+    long m_lastReadEnd = 0;
+    int m_randomCount = 0;
+    bool m_sequential = true;
+
+    // 映射起始地址按页对齐，m_mapView指向流位置0
+    void *m_mapBase = nullptr;
+    size_t m_mapSize = 0;
+    const byte *m_mapView = nullptr;
+
+    // preallocate预留到的文件内偏移
+    long m_preallocated = 0;
+
+    bool m_noCache = false;
+    // 尚未开始回写的区间和正在回写的区间，均为文件内偏移，start等于end表示为空
+    long m_dirtyStart = 0;
+    long m_dirtyEnd = 0;
+    long m_writebackStart = 0;
+    long m_writebackEnd = 0;
 };
 
 
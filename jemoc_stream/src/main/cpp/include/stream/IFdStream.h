@@ -0,0 +1,26 @@
+//
+// Created on 2025/3/2.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#ifndef JEMOC_STREAM_TEST_IFDSTREAM_H
+#define JEMOC_STREAM_TEST_IFDSTREAM_H
+
+/**
+ * 由fd支撑的流实现该接口，copyTo在源和目标都是fd流时改用copy_file_range/sendfile/splice在内核中完成拷贝
+ */
+class IFdStream {
+public:
+    virtual ~IFdStream() = default;
+    // 底层文件描述符，不可用时返回-1
+    virtual int getNativeFd() const = 0;
+    // 流的位置0在fd中对应的偏移
+    virtual long getNativeOffset() const { return 0; }
+    // 内核直接读写fd前，把用户态缓冲区中的数据同步到fd
+    virtual void syncNativeFd() {}
+    // 内核直接写入fd并更新长度后调用，流可据此调整映射等用户态状态
+    virtual void nativeFdWritten() {}
+};
+
+#endif // JEMOC_STREAM_TEST_IFDSTREAM_H
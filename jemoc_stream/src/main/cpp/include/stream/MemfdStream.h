@@ -8,10 +8,17 @@
 #define JEMOC_STREAM_TEST_MEMFDSTREAM_H
 
 #include "IStream.h"
+#include "stream/IFdStream.h"
 #include <stdexcept>
 
-// 基于 memfd_create 的内存流实现，支持截断流长度，并允许构造时传入初始缓冲区数据
-class MemfdStream : public IStream {
+/**
+ * 基于 memfd_create 的内存流实现，支持截断流长度，并允许构造时传入初始缓冲区数据。
+ * 读取和长度以内的写入直接访问fd的共享映射，映射按倍数扩容；只有扩展长度的写入调用一次pwrite；
+ * 内核不支持memfd_create时退回shm_open，创建后立即shm_unlink，不在/dev/shm留下文件。
+ * 映射只在扩展长度的写入、setLength、seal和内核写入fd后扩容，读取从不重新映射，没有写入时多个线程可以并发readAt；
+ * getSpan返回的指针在下一次扩展长度的写入、setLength、seal或close之前有效
+ */
+class MemfdStream : public IStream, public IFdStream {
     struct SendFileData {
         MemfdStream *stream;
         int fd;
@@ -30,14 +37,29 @@ public:
 
     long read(void *buffer, long offset, size_t count) override;
     long write(void *buffer, long offset, size_t count) override;
+    long readv(const struct iovec *iov, int iovcnt) override;
+    long writev(const struct iovec *iov, int iovcnt) override;
+    long readAt(long position, void *buffer, long offset, size_t count) override;
+    long writeAt(long position, void *buffer, long offset, size_t count) override;
     long seek(long offset, SeekOrigin origin) override;
     void flush() override;
     void close() override;
     void setLength(long length) override;
+    void copyTo(IStream *stream, long bufferSize) override;
+    const byte *getSpan(long position, long length) override;
     bool sendFile(const int &fd, long offset, long length);
 
     // 获取 memfd 的文件描述符
     int getFd() const;
+    int getNativeFd() const override { return m_closed ? -1 : m_fd; }
+    void nativeFdWritten() override;
+
+    /**
+     * 添加F_SEAL_SHRINK/GROW/WRITE/SEAL封印，之后内容和长度都不能再修改，fd可以作为不可变的数据交给其他进程或worker映射读取。
+     * 封印后流变为只读，退回shm_open创建时不支持封印，抛出异常
+     */
+    void seal();
+    bool isSealed() const { return m_sealed; }
 
 public:
     static std::string ClassName;
@@ -49,12 +71,25 @@ public:
     static napi_value JSGetFd(napi_env env, napi_callback_info info);
     static napi_value JSSendFile(napi_env env, napi_callback_info info);
     static napi_value JSSendFileAsync(napi_env env, napi_callback_info info);
+    static napi_value JSSeal(napi_env env, napi_callback_info info);
+    static napi_value JSGetSealed(napi_env env, napi_callback_info info);
     static void initSendFile(napi_env env, napi_callback_info info, int &fd, long &offset, long &length,
                              bool &autoClose, MemfdStream **fdStream);
     napi_value readAllFromFd(napi_env env, long offset, long length);
 
 private:
+    void create();
+    // 保证映射覆盖[0, size)，不改变文件长度。扩容可能移动映射，只能由修改长度的一方调用
+    void reserve(long size);
+    void checkWritable(const char *operation) const;
+
     int m_fd;
+    bool m_canSeal = false;
+    bool m_sealed = false;
+    byte *m_map = nullptr;
+    long m_mapSize = 0;
+    // 映射的最小容量，之后按倍数扩容
+    static constexpr long MinMapSize = 64 * 1024;
 };
 
 
@@ -8,6 +8,8 @@
 #define JEMOC_STREAM_TEST_MEMORYSTREAM_H
 
 #include "IStream.h"
+#include "PageAllocator.h"
+#include <functional>
 #include <vector>
 
 
@@ -15,16 +17,40 @@ class MemoryStream : public IStream {
 public:
     MemoryStream();
     MemoryStream(size_t capacity);
+    // chunkSize大于0时使用分段存储，数据保存在一组固定大小的块中，扩容只追加新块，不搬移已有数据
+    MemoryStream(size_t capacity, long chunkSize);
+    /**
+     * 视图模式，直接在调用方提供的内存上读写，不分配也不拷贝。容量固定为length，writable为false时只读。
+     * 流析构时调用release，调用方借此释放对内存的持有
+     */
+    MemoryStream(byte *data, long length, bool writable, std::function<void()> release);
     ~MemoryStream();
     long read(void *buffer, long offset, size_t count) override;
     long write(void *buffer, long offset, size_t count) override;
+    long readv(const struct iovec *iov, int iovcnt) override;
+    long writev(const struct iovec *iov, int iovcnt) override;
+    long readAt(long position, void *buffer, long offset, size_t count) override;
+    long writeAt(long position, void *buffer, long offset, size_t count) override;
     void setCapacity(long capacity);
     long getCapacity() const;
     void close() override;
     void setLength(long length) override;
+    // 分段存储时只有区间落在同一个块内才返回指针
+    const byte *getSpan(long position, long length) override;
 //     const byte *getData() const { return m_cache->data(); }
+    // 连续存储时返回数据首地址，分段存储时返回nullptr，需通过read/readAt读取
     const byte *getData() const { return mm_cache; }
-    long align4k(long size) const { return (size + 4096) & ~4096; }
+    /**
+     * 交出内部缓冲区的所有权并关闭流，返回的缓冲区由调用方通过PageAllocator::deallocate(buffer, capacity)释放。
+     * 连续存储时直接交出，不拷贝；分段存储时只有一个块也直接交出，多个块需要合并拷贝一次
+     */
+    byte *detach(long *length, long *capacity);
+    bool isChunked() const { return m_chunkSize > 0; }
+    bool isView() const { return m_view; }
+    long getChunkSize() const { return m_chunkSize; }
+    // js侧开启分段存储但未指定chunkSize时的默认块大小
+    static constexpr long DefaultChunkSize = 1024 * 1024;
+    long align4k(long size) const { return (size + 4095) & ~4095L; }
 
 
 public:
@@ -36,14 +62,27 @@ public:
     static void Export(napi_env env, napi_value exports);
     static napi_value JSGetCapacity(napi_env env, napi_callback_info info);
     static napi_value JSSetCapacity(napi_env env, napi_callback_info info);
+    static napi_value JSDetachToArrayBuffer(napi_env env, napi_callback_info info);
+    static napi_value JSGetChunked(napi_env env, napi_callback_info info);
+    static napi_value JSGetChunkSize(napi_env env, napi_callback_info info);
 
 private:
     void ensureCapacity(long capacity);
+    // 按当前存储方式在position处拷出/拷入数据，调用前需保证容量足够
+    void copyOut(long position, byte *dest, size_t count) const;
+    void copyIn(long position, const byte *source, size_t count);
+    void zeroFill(long from, long to);
 
 private:
 //     std::vector<byte> *m_cache;
     long m_capacity = 0;
     byte *mm_cache = nullptr;
+    long m_chunkSize = 0;
+    // 每块由PageAllocator按m_chunkSize分配
+    std::vector<byte *> m_chunks;
+    // 视图模式下mm_cache不归本流所有
+    bool m_view = false;
+    std::function<void()> m_release;
 };
 
 
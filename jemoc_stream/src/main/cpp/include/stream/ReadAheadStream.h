@@ -0,0 +1,84 @@
+//
+// Created on 2025/3/7.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#ifndef JEMOC_STREAM_TEST_READAHEADSTREAM_H
+#define JEMOC_STREAM_TEST_READAHEADSTREAM_H
+
+#include "IStream.h"
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <thread>
+#include <vector>
+
+/**
+ * 预读流，在后台线程上按块顺序读取底层流(文件、解压流、归档条目等)，读取方直接从已读好的块中取数据。
+ * 读取方等待空块时预读深度翻倍，直到maxDepth；预读线程连续因队列已满而等待时逐步降回初始深度。
+ * 块在内部循环复用，copyTo和takeBlock直接交出块内存，不经过额外拷贝
+ */
+class ReadAheadStream : public IStream {
+public:
+    struct Block {
+        std::unique_ptr<byte[]> data;
+        // 块内有效数据长度和已被读取的位置
+        long length = 0;
+        long offset = 0;
+    };
+
+    ReadAheadStream(std::shared_ptr<IStream> stream, size_t blockSize, int depth, int maxDepth, bool leaveOpen);
+    ~ReadAheadStream();
+
+    long read(void *buffer, long offset, size_t count) override;
+    long seek(long offset, SeekOrigin origin) override;
+    void copyTo(IStream *stream, long bufferSize) override;
+    void close() override;
+
+    // 取出下一个未读完的块，流结束时返回nullptr。用完后通过recycle归还
+    std::unique_ptr<Block> takeBlock();
+    void recycle(std::unique_ptr<Block> block);
+    int getDepth() const { return m_depth.load(std::memory_order_relaxed); }
+    size_t getBlockSize() const { return m_blockSize; }
+
+public:
+    static std::string ClassName;
+    static napi_value JSConstructor(napi_env env, napi_callback_info info);
+    static napi_value JSReadBlock(napi_env env, napi_callback_info info);
+    static napi_value JSGetDepth(napi_env env, napi_callback_info info);
+    static void Export(napi_env env, napi_value exports);
+
+private:
+    std::unique_ptr<Block> nextBlock(bool wait);
+    void start();
+    void stop();
+    void run();
+
+    // 预读线程连续这么多次因队列已满而等待时，深度减一
+    static const int ShrinkThreshold = 16;
+
+private:
+    std::shared_ptr<IStream> m_stream;
+    size_t m_blockSize;
+    int m_minDepth;
+    int m_maxDepth;
+    std::atomic<int> m_depth;
+    bool m_leaveOpen;
+
+    std::mutex m_mutex;
+    std::condition_variable m_readyCondition;
+    std::condition_variable m_spaceCondition;
+    std::deque<std::unique_ptr<Block>> m_ready;
+    std::vector<std::unique_ptr<Block>> m_free;
+    // 读取方正在消费的块
+    std::unique_ptr<Block> m_current;
+    std::thread m_worker;
+    std::exception_ptr m_error;
+    bool m_running = false;
+    bool m_stopping = false;
+    bool m_eof = false;
+    int m_fullCount = 0;
+};
+
+#endif // JEMOC_STREAM_TEST_READAHEADSTREAM_H
@@ -0,0 +1,123 @@
+//
+// Created on 2025/3/3.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#ifndef JEMOC_STREAM_TEST_STREAMSTATS_H
+#define JEMOC_STREAM_TEST_STREAMSTATS_H
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <sys/resource.h>
+
+// 当前线程的缺页次数，minor为不需要读盘的缺页，major为需要读盘的缺页
+struct PageFaults {
+    long minor = 0;
+    long major = 0;
+
+    static PageFaults current() {
+        struct rusage usage {};
+#ifdef RUSAGE_THREAD
+        getrusage(RUSAGE_THREAD, &usage);
+#else
+        getrusage(RUSAGE_SELF, &usage);
+#endif
+        return {usage.ru_minflt, usage.ru_majflt};
+    }
+
+    PageFaults operator-(const PageFaults &other) const { return {minor - other.minor, major - other.major}; }
+};
+
+// 单类操作的统计，时间单位为毫秒
+struct StreamOpStats {
+    long count = 0;
+    long bytes = 0;
+    double totalTime = 0;
+    double maxTime = 0;
+    long minorFaults = 0;
+    long majorFaults = 0;
+
+    void record(long byteCount, double time, PageFaults faults) {
+        count++;
+        bytes += std::max(0l, byteCount);
+        totalTime += time;
+        maxTime = std::max(maxTime, time);
+        minorFaults += faults.minor;
+        majorFaults += faults.major;
+    }
+};
+
+// 异步任务的统计，queued为提交到开始执行的等待时间，execute为在工作线程上的执行时间
+struct StreamAsyncStats {
+    long count = 0;
+    double queuedTime = 0;
+    double maxQueuedTime = 0;
+    double executeTime = 0;
+    double maxExecuteTime = 0;
+};
+
+/**
+ * 流的吞吐和耗时统计，由IStream在统计开启时按调用记录
+ */
+class StreamStats {
+public:
+    using Clock = std::chrono::steady_clock;
+    enum Op { Read, Write, Flush, Seek };
+
+    struct Snapshot {
+        StreamOpStats read;
+        StreamOpStats write;
+        StreamOpStats flush;
+        StreamOpStats seek;
+        StreamAsyncStats async;
+    };
+
+    static double toMs(Clock::duration duration) {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+
+    void record(Op op, long bytes, double time, PageFaults faults = PageFaults()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        switch (op) {
+        case Read:
+            data_.read.record(bytes, time, faults);
+            break;
+        case Write:
+            data_.write.record(bytes, time, faults);
+            break;
+        case Flush:
+            data_.flush.record(0, time, faults);
+            break;
+        case Seek:
+            data_.seek.record(0, time, faults);
+            break;
+        }
+    }
+
+    void recordAsync(double queuedTime, double executeTime) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        data_.async.count++;
+        data_.async.queuedTime += queuedTime;
+        data_.async.maxQueuedTime = std::max(data_.async.maxQueuedTime, queuedTime);
+        data_.async.executeTime += executeTime;
+        data_.async.maxExecuteTime = std::max(data_.async.maxExecuteTime, executeTime);
+    }
+
+    Snapshot snapshot() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return data_;
+    }
+
+    void reset() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        data_ = Snapshot();
+    }
+
+private:
+    mutable std::mutex mutex_;
+    Snapshot data_;
+};
+
+#endif // JEMOC_STREAM_TEST_STREAMSTATS_H
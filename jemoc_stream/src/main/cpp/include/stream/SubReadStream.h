@@ -8,6 +8,11 @@
 #define JEMOC_STREAM_TEST_SUBREADSTREAM_H
 #include "IStream.h"
 
+/**
+ * 父流中[startPosition, startPosition + maxLength)区间的只读视图。
+ * 父流可seek时通过readAt定位读取，不移动父流指针，同一父流上的多个SubReadStream可以在不同线程上并发读取，
+ * 自身也支持seek；父流不可seek时只能从父流当前位置顺序读取
+ */
 class SubReadStream : public IStream {
 public:
     SubReadStream(std::shared_ptr<IStream> stream, long startPosition, size_t maxLength, bool leaveOpen);
@@ -15,10 +20,15 @@ public:
 
     void close() override;
     bool getCanRead() const override;
+    bool getCanSeek() const override;
     long read(void* buffer, long offset, size_t count) override ;
-    
+    long readAt(long position, void *buffer, long offset, size_t count) override;
+    long seek(long offset, SeekOrigin origin) override;
+    const byte *getSpan(long position, long length) override;
 
 private:
+    std::shared_ptr<IStream> lockStream() const;
+
     std::weak_ptr<IStream> m_stream;
     long m_startInStream;
     long m_endInStream;
@@ -7,6 +7,7 @@
 #ifndef JEMOC_STREAM_TEST_CHECKSUMANDSIZEWRITESTREAM_H
 #define JEMOC_STREAM_TEST_CHECKSUMANDSIZEWRITESTREAM_H
 #include "IStream.h"
+#include <functional>
 #include <sys/types.h>
 
 
@@ -40,7 +40,7 @@ public:
         m_stream.reset();
         m_stream = nullptr;
         if (!m_everWritten) {
-            m_entry->writeLocalFileHeader();
+            m_entry->writeLocalFileHeader(true);
         } else {
             if (m_entry->getArchive()->getArchiveStream()->getCanSeek()) {
                 m_entry->writeCrcAndSizesInLocalHeader();
@@ -8,6 +8,7 @@
 #define JEMOC_STREAM_TEST_WRAPPEDSTREAM_H
 #include "IStream.h"
 #include "zip/ZipArchiveEntry.h"
+#include <functional>
 
 class WrappedStream : public IStream {
 public:
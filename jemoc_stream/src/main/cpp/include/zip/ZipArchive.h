@@ -7,7 +7,6 @@
 #ifndef JEMOC_STREAM_TEST_ZIPARCHIVE_H
 #define JEMOC_STREAM_TEST_ZIPARCHIVE_H
 #include "IStream.h"
-#include <napi/native_api.h>
 #include <string>
 #include <unordered_map>
 #include <vector>
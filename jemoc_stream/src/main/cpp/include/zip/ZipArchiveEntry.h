@@ -7,10 +7,10 @@
 #ifndef JEMOC_STREAM_TEST_ZIPARCHIVEENTRY_H
 #define JEMOC_STREAM_TEST_ZIPARCHIVEENTRY_H
 
+#include "deflate/DeflateIndex.h"
 #include "stream/MemoryStream.h"
 #include "zip/ZipRecord.h"
 #include <cstdint>
-#include <napi/native_api.h>
 #include <string>
 #include <sys/types.h>
 
@@ -47,7 +47,10 @@ public:
     ZipArchiveEntry(ZipArchive *archive, const std::string &entryName, int compressionLevel);
     ~ZipArchiveEntry();
 
-    std::shared_ptr<IStream> open();
+    // 只读模式下index不为空时，deflate条目的解压流绑定该访问点索引，可随机seek
+    std::shared_ptr<IStream> open(std::shared_ptr<DeflateIndex> index = nullptr);
+    // 解压到path指定的文件，已知解压后大小时先为目标文件预留空间
+    void extractToFile(const std::string &path);
     bool getIsEncrypted() const;
     void setIsEncrypted(const bool &value);
     CompressionLevel getCompressionLevel() const;
@@ -62,10 +65,12 @@ public:
     void setCompressionMethod(CompressionMethod value);
     double getLastModifier() const;
     void setLastModifier(double value);
+    // 写入时threads大于1则多线程分块压缩，见ParallelDeflater
+    void setDeflateThreads(int threads, size_t blockSize);
 
 public:
     long getOffsetOfCompressedData();
-    bool writeLocalFileHeader();
+    bool writeLocalFileHeader(bool isEmptyFile = false);
     void writeCrcAndSizesInLocalHeader();
     void writeDataDescriptor();
     void writeAndFinishLocalEntry();
@@ -76,10 +81,11 @@ public:
     ZipArchive *getArchive();
 
 private:
-    std::shared_ptr<IStream> openInReadMode();
+    std::shared_ptr<IStream> openInReadMode(std::shared_ptr<DeflateIndex> index = nullptr);
     std::shared_ptr<IStream> openInCreateMode();
     std::shared_ptr<IStream> openInUpdateMode();
-    std::shared_ptr<IStream> getDataDecompressor(std::shared_ptr<IStream> stream);
+    std::shared_ptr<IStream> getDataDecompressor(std::shared_ptr<IStream> stream,
+                                                 std::shared_ptr<DeflateIndex> index = nullptr);
     std::shared_ptr<IStream> getDataCompressor(std::shared_ptr<IStream> stream, bool leaveOpen);
     std::shared_ptr<IStream> getUncompressedData();
     void closeStream();
@@ -95,7 +101,7 @@ public:
     static ZipArchiveEntry *getEntry(napi_env env, napi_value value);
     napi_value getJSEntry(napi_env env);
     void releaseJSEntry(napi_env env);
-    napi_value open(napi_env env);
+    napi_value open(napi_env env, std::shared_ptr<DeflateIndex> index);
     napi_ref jsEntry = nullptr;
     void Delete(napi_env env);
     
@@ -114,6 +120,7 @@ public:
 //     double getLastModifier() const ;
 //     void setLastModifier(double value);
     static napi_value JSOpen(napi_env env, napi_callback_info info);
+    static napi_value JSExtractToFile(napi_env env, napi_callback_info info);
     static napi_value JSSetIsEncrypted(napi_env env, napi_callback_info info);
     static napi_value JSGetIsEncrypted(napi_env env, napi_callback_info info);
     static napi_value JSGetCompressionLevel(napi_env env, napi_callback_info info);
@@ -169,6 +176,8 @@ private:
 
     bool m_everOpenedForWrite = false;
     bool m_currentlyOpenForWrite = false;
+    int m_deflateThreads = 1;
+    size_t m_deflateBlockSize = 0;
 
     IStream *m_outstandingWriteStream = nullptr;
     std::shared_ptr<MemoryStream> compressedBytes = nullptr;
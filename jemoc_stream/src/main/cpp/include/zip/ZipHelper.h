@@ -8,6 +8,7 @@
 #define JEMOC_STREAM_TEST_ZIPHELPERE_H
 
 #include "IStream.h"
+#include <cstring>
 #include <sys/types.h>
 namespace ZipHelper {
 /**
@@ -42,10 +43,27 @@ bool seekBackwardsAndRead(IStream *stream, void *buffer, size_t bufferSize, long
  * @return
  */
 bool seekBackwardsToSignature(IStream *stream, uint signature, long maxBytesToRead) {
+    // 流能直接给出内存区间时(如映射文件)在区间上查找，不再逐32字节回退读取
+    long position = stream->getPosition();
+    long lowest = std::max(0L, position - maxBytesToRead - static_cast<long>(sizeof(uint)));
+    if (position - lowest >= static_cast<long>(sizeof(uint))) {
+        if (const byte *span = stream->getSpan(lowest, position - lowest)) {
+            for (long i = position - lowest - sizeof(uint); i >= 0; i--) {
+                uint value;
+                memcpy(&value, span + i, sizeof(uint));
+                if (value == signature) {
+                    stream->seek(lowest + i, SeekOrigin::Begin);
+                    return true;
+                }
+            }
+            return false;
+        }
+    }
+
     bool outOfBytes = false;
     bool signatureFound = false;
     uint currentSignature = 0;
-    uint8_t *buffer = new uint8_t[32];
+    uint8_t buffer[32];
 
     long bufferPointer = 0;
     long bytesRead = 0;
@@ -9,6 +9,7 @@
 
 #include <sys/types.h>
 #include "IStream.h"
+#include <vector>
 
 #define ZIP_EOCD_SIGNATURE 0x06054b50
 #define ZIP_CentralDirectory_SIGNATURE 0x02014b50
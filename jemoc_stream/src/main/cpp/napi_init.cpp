@@ -1,13 +1,16 @@
 #include "BufferPool.h"
+#include "binding/BrotliBinding.h"
 #include "binding/StreamReaderBinding.h"
 #include "binding/TextReaderBinding.h"
 #include "binding/XmlReaderBinding.h"
+#include "deflate/DeflateUtils.h"
 #include "napi/native_api.h"
-#include "stream/BrotliStream.h"
+#include "stream/AsyncFileStream.h"
 #include "stream/DeflateStream.h"
 #include "stream/FileStream.h"
 #include "stream/MemfdStream.h"
 #include "stream/MemoryStream.h"
+#include "stream/ReadAheadStream.h"
 #include "zip/ZipArchive.h"
 #include "zip/ZipArchiveEntry.h"
 #include "zip/ZipCryptoStream.h"
@@ -27,7 +30,10 @@ static napi_value Init(napi_env env, napi_value exports) {
     MemfdStream::Export(env, exports);
     MemoryStream::Export(env, exports);
     FileStream::Export(env, exports);
+    AsyncFileStream::Export(env, exports);
     DeflateStream::Export(env, exports);
+    DeflateIndex::Export(env, exports);
+    ReadAheadStream::Export(env, exports);
     ZipCryptoStream::Export(env, exports);
     ZipArchive::Export(env, exports);
     ZipArchiveEntry::Export(env, exports);
@@ -35,6 +41,7 @@ static napi_value Init(napi_env env, napi_value exports) {
     Deflater::Export(env, exports);
     BrotliStream::Export(env, exports);
     BrotliJs::Export(env, exports);
+    DeflateUtils::Export(env, exports);
     jemoc_stream::BufferPool::Export(env, exports);
     jemoc_stream::LruBufferPool::Export(env, exports);
 
@@ -30,7 +30,8 @@ bool IconvConverter::Convert(const char* from, size_t fromSize,
         return false;
     }
 
-    convertedChars = (toSize * sizeof(char32_t) - outbytesleft) / sizeof(char32_t);
+    // 输出为UTF-8字节
+    convertedChars = toSize - outbytesleft;
     return true;
 }
 
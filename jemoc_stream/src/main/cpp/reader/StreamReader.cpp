@@ -6,6 +6,7 @@
 
 #include "reader/StreamReader.h"
 #include "stream/FileStream.h"
+#include <fstream>
 
 StreamReader::StreamReader(std::shared_ptr<IStream> stream, bool detectEncodingFromByteOrderMarks,
                            const std::string &encoding, bool leaveOpen)
@@ -109,7 +110,7 @@ bool StreamReader::FillBuffer() {
 
     size_t remainingSpace = bufferSize - bufferLen;
     if (remainingSpace > 0) {
-        size_t readBytes = stream->read(buffer.data() + bufferLen, bufferLen, remainingSpace);
+        size_t readBytes = stream->read(buffer.data(), bufferLen, remainingSpace);
         bufferLen += readBytes;
     }
 
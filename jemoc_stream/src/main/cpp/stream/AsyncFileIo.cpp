@@ -0,0 +1,346 @@
+//
+// Created on 2025/3/9.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#include "stream/AsyncFileIo.h"
+#include "stream/FdHelper.h"
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter) && defined(__NR_io_uring_register)
+#include <linux/io_uring.h>
+#define JEMOC_HAS_IO_URING 1
+#endif
+
+/**
+ * 直接通过系统调用使用io_uring，不依赖liburing。提交队列只在m_mutex内写入，完成队列只由收割线程读取
+ */
+struct AsyncFileIo::Ring {
+#ifdef JEMOC_HAS_IO_URING
+    int fd = -1;
+    void *sqRing = MAP_FAILED;
+    void *cqRing = MAP_FAILED;
+    size_t sqRingSize = 0;
+    size_t cqRingSize = 0;
+    io_uring_sqe *sqes = static_cast<io_uring_sqe *>(MAP_FAILED);
+    size_t sqesSize = 0;
+    unsigned *sqHead = nullptr;
+    unsigned *sqTail = nullptr;
+    unsigned *sqMask = nullptr;
+    unsigned *sqArray = nullptr;
+    unsigned *cqHead = nullptr;
+    unsigned *cqTail = nullptr;
+    unsigned *cqMask = nullptr;
+    io_uring_cqe *cqes = nullptr;
+
+    bool init(unsigned entries) {
+        io_uring_params params{};
+        fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (fd < 0)
+            return false;
+        sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        // 新内核上提交和完成队列共用一次映射
+        bool singleMap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (singleMap)
+            sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+        sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        if (sqRing == MAP_FAILED)
+            return false;
+        cqRing = singleMap ? sqRing
+                           : mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                                  IORING_OFF_CQ_RING);
+        if (cqRing == MAP_FAILED)
+            return false;
+        sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        sqes = static_cast<io_uring_sqe *>(
+            mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES));
+        if (sqes == MAP_FAILED)
+            return false;
+
+        byte *sq = static_cast<byte *>(sqRing);
+        byte *cq = static_cast<byte *>(cqRing);
+        sqHead = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+        sqTail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+        sqMask = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+        sqArray = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+        cqHead = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+        cqMask = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    int enter(unsigned toSubmit, unsigned minComplete, unsigned flags) {
+        return static_cast<int>(syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0));
+    }
+
+    ~Ring() {
+        if (sqes != MAP_FAILED)
+            munmap(sqes, sqesSize);
+        if (cqRing != MAP_FAILED && cqRing != sqRing)
+            munmap(cqRing, cqRingSize);
+        if (sqRing != MAP_FAILED)
+            munmap(sqRing, sqRingSize);
+        if (fd >= 0)
+            ::close(fd);
+    }
+#endif
+};
+
+AsyncFileIo::AsyncFileIo(int fd, int depth, bool useUring) : m_fd(fd), m_depth(std::max(depth, 1)) {
+#ifdef JEMOC_HAS_IO_URING
+    if (useUring) {
+        auto ring = std::make_unique<Ring>();
+        if (ring->init(m_depth))
+            m_ring = std::move(ring);
+    }
+#endif
+}
+
+AsyncFileIo::~AsyncFileIo() {
+    drain();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+    for (auto &worker : m_workers)
+        worker.join();
+    if (m_reaper.joinable())
+        m_reaper.join();
+    // drain之后所有请求都已完成，完成通知可能还没处理，剩下的请求不能随引擎一起丢弃
+    std::vector<std::unique_ptr<Request>> completed = takeCompleted();
+    if (!completed.empty() && m_uncollectedHandler)
+        m_uncollectedHandler(std::move(completed));
+}
+
+void AsyncFileIo::submit(std::unique_ptr<Request> request) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_ring != nullptr) {
+        bool notify = false;
+        if (m_inflight < m_depth && !m_ringBusy)
+            notify = submitToRing(request.release());
+        else
+            m_pending.push_back(std::move(request));
+        // 上一个收割线程在请求全部完成后已经退出，回收后重新启动；提交失败时内核中没有请求，不需要收割
+        if (!m_reaping && m_inflight > 0) {
+            if (m_reaper.joinable())
+                m_reaper.join();
+            m_reaping = true;
+            m_reaper = std::thread(&AsyncFileIo::reap, this);
+        }
+        lock.unlock();
+        if (notify && m_notify)
+            m_notify();
+        return;
+    }
+
+    m_pending.push_back(std::move(request));
+    if (m_idleWorkers == 0 && static_cast<int>(m_workers.size()) < m_depth)
+        m_workers.emplace_back(&AsyncFileIo::work, this);
+    else
+        m_condition.notify_one();
+}
+
+std::vector<std::unique_ptr<AsyncFileIo::Request>> AsyncFileIo::takeCompleted() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<std::unique_ptr<Request>> completed;
+    completed.swap(m_completed);
+    return completed;
+}
+
+void AsyncFileIo::drain() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idleCondition.wait(lock, [this]() { return m_inflight == 0 && m_pending.empty(); });
+}
+
+bool AsyncFileIo::complete(Request *request) {
+    bool wasEmpty = m_completed.empty();
+    m_completed.emplace_back(request);
+    if (m_inflight == 0 && m_pending.empty())
+        m_idleCondition.notify_all();
+    return wasEmpty;
+}
+
+bool AsyncFileIo::registerBuffers(const std::vector<struct iovec> &buffers) {
+#ifdef JEMOC_HAS_IO_URING
+    if (m_ring == nullptr || buffers.empty())
+        return false;
+    // 注册和注销要求没有请求正在使用固定缓冲区
+    drain();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_registered.empty()) {
+        syscall(__NR_io_uring_register, m_ring->fd, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+        m_registered.clear();
+    }
+    if (syscall(__NR_io_uring_register, m_ring->fd, IORING_REGISTER_BUFFERS, buffers.data(), buffers.size()) != 0)
+        return false;
+    m_registered = buffers;
+    return true;
+#else
+    return false;
+#endif
+}
+
+int AsyncFileIo::findRegisteredBuffer(const byte *buffer, size_t length) const {
+    for (size_t i = 0; i < m_registered.size(); i++) {
+        const byte *base = static_cast<const byte *>(m_registered[i].iov_base);
+        if (buffer >= base && buffer + length <= base + m_registered[i].iov_len)
+            return static_cast<int>(i);
+    }
+    return -1;
+}
+
+bool AsyncFileIo::submitToRing(Request *request) {
+#ifdef JEMOC_HAS_IO_URING
+    if (m_ringBusy) {
+        m_pending.emplace_back(request);
+        return false;
+    }
+    unsigned tail = *m_ring->sqTail;
+    unsigned index = tail & *m_ring->sqMask;
+    io_uring_sqe *sqe = &m_ring->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    bool fixed = request->bufferIndex >= 0;
+    if (request->write)
+        sqe->opcode = fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+    else
+        sqe->opcode = fixed ? IORING_OP_READ_FIXED : IORING_OP_READ;
+    // 短读写时从已完成的位置继续
+    sqe->fd = m_fd;
+    sqe->addr = reinterpret_cast<uint64_t>(request->buffer + request->result);
+    sqe->len = static_cast<unsigned>(request->length - request->result);
+    sqe->off = request->offset + request->result;
+    sqe->buf_index = fixed ? request->bufferIndex : 0;
+    sqe->user_data = reinterpret_cast<uint64_t>(request);
+    m_ring->sqArray[index] = index;
+    __atomic_store_n(m_ring->sqTail, tail + 1, __ATOMIC_RELEASE);
+    m_inflight++;
+    int ret = 0;
+    int attempts = 0;
+    while ((ret = m_ring->enter(1, 0, 0)) < 0) {
+        if (errno == EINTR)
+            continue;
+        // 内核资源暂时不足且没有其他请求可以等待时，退避后重试几次
+        if ((errno == EAGAIN || errno == EBUSY) && m_inflight == 1 && attempts < MaxSubmitRetries) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1 << attempts++));
+            continue;
+        }
+        break;
+    }
+    if (ret >= 0)
+        return false;
+    int error = errno;
+    // 内核已经取走的提交项会通过完成事件返回结果，只撤回还留在提交队列中的
+    if (__atomic_load_n(m_ring->sqHead, __ATOMIC_ACQUIRE) != tail)
+        return false;
+    __atomic_store_n(m_ring->sqTail, tail, __ATOMIC_RELEASE);
+    m_inflight--;
+    // 内核资源暂时不足，等已提交的请求完成后由收割线程重新提交，不原地重试
+    if ((error == EAGAIN || error == EBUSY) && m_inflight > 0) {
+        m_ringBusy = true;
+        m_pending.emplace_front(request);
+        return false;
+    }
+    request->error = error;
+    return complete(request);
+#else
+    return false;
+#endif
+}
+
+void AsyncFileIo::reap() {
+#ifdef JEMOC_HAS_IO_URING
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        lock.unlock();
+        int ret = m_ring->enter(0, 1, IORING_ENTER_GETEVENTS);
+        lock.lock();
+        if (ret < 0 && errno != EINTR && errno != EAGAIN)
+            OH_LOG_ERROR(LOG_APP, "io_uring wait failed: %s", strerror(errno));
+
+        bool notify = false;
+        unsigned head = *m_ring->cqHead;
+        unsigned tail = __atomic_load_n(m_ring->cqTail, __ATOMIC_ACQUIRE);
+        for (; head != tail; head++) {
+            io_uring_cqe *cqe = &m_ring->cqes[head & *m_ring->cqMask];
+            Request *request = reinterpret_cast<Request *>(cqe->user_data);
+            int res = cqe->res;
+            m_inflight--;
+            if (res == -EINTR || res == -EAGAIN) {
+                notify |= submitToRing(request);
+                continue;
+            }
+            if (res < 0) {
+                request->error = -res;
+            } else {
+                request->result += res;
+                if (res > 0 && static_cast<size_t>(request->result) < request->length) {
+                    notify |= submitToRing(request);
+                    continue;
+                }
+            }
+            notify |= complete(request);
+        }
+        __atomic_store_n(m_ring->cqHead, head, __ATOMIC_RELEASE);
+        // 收割后内核资源已释放，重新提交排队的请求；没有请求在内核中时再次失败的请求直接以errno完成
+        m_ringBusy = false;
+        while (m_inflight < m_depth && !m_ringBusy && !m_pending.empty()) {
+            Request *request = m_pending.front().release();
+            m_pending.pop_front();
+            notify |= submitToRing(request);
+        }
+
+        // 全部完成后退出，退出前不再持锁，submit可能正持锁等待回收本线程
+        if (m_inflight == 0) {
+            m_reaping = false;
+            lock.unlock();
+            if (notify && m_notify)
+                m_notify();
+            return;
+        }
+        if (notify && m_notify) {
+            lock.unlock();
+            m_notify();
+            lock.lock();
+        }
+    }
+#endif
+}
+
+void AsyncFileIo::work() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_idleWorkers++;
+        m_condition.wait(lock, [this]() { return m_stopping || !m_pending.empty(); });
+        m_idleWorkers--;
+        if (m_pending.empty())
+            return;
+        std::unique_ptr<Request> request = std::move(m_pending.front());
+        m_pending.pop_front();
+        m_inflight++;
+        lock.unlock();
+        try {
+            if (request->write)
+                request->result = FdHelper::pwriteAll(m_fd, request->buffer, request->length, request->offset);
+            else
+                request->result = FdHelper::preadAll(m_fd, request->buffer, request->length, request->offset);
+        } catch (const std::exception &e) {
+            request->error = errno != 0 ? errno : EIO;
+        }
+        lock.lock();
+        m_inflight--;
+        if (complete(request.release()) && m_notify) {
+            lock.unlock();
+            m_notify();
+            lock.lock();
+        }
+    }
+}
@@ -0,0 +1,59 @@
+//
+// Created on 2025/3/9.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#include "stream/AsyncFileStream.h"
+
+AsyncFileStream::AsyncFileStream(const std::string &path, FILE_MODE mode, long bufferSize, int depth, bool useUring)
+    : FileStream(path, mode, bufferSize), m_io(std::make_unique<AsyncFileIo>(getNativeFd(), depth, useUring)) {}
+
+AsyncFileStream::AsyncFileStream(const int &fd, FILE_MODE mode, long bufferSize, int depth, bool useUring)
+    : FileStream(fd, mode, bufferSize), m_io(std::make_unique<AsyncFileIo>(getNativeFd(), depth, useUring)) {}
+
+bool AsyncFileStream::submitRead(std::unique_ptr<AsyncFileIo::Request> request) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (m_closed)
+        throw std::ios_base::failure("The read operation failed because the file was closed ");
+    if (!m_canRead)
+        throw std::ios_base::failure("stream not readable");
+    long count = std::min(static_cast<long>(request->length), m_length - m_position);
+    if (count <= 0)
+        return false;
+    // 异步读写直接访问fd，先同步用户态缓冲区
+    syncNativeFd();
+    request->write = false;
+    request->length = count;
+    request->offset = getNativeOffset() + m_position;
+    m_position += count;
+    m_io->submit(std::move(request));
+    return true;
+}
+
+void AsyncFileStream::submitWrite(std::unique_ptr<AsyncFileIo::Request> request) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (m_closed)
+        throw std::ios_base::failure("The write operation failed because the file was closed ");
+    if (!m_canWrite)
+        throw std::ios_base::failure("stream not writeable");
+    syncNativeFd();
+    request->write = true;
+    request->offset = getNativeOffset() + m_position;
+    m_position += request->length;
+    m_length = std::max(m_length, m_position);
+    m_io->submit(std::move(request));
+}
+
+void AsyncFileStream::flush() {
+    m_io->drain();
+    FileStream::flush();
+}
+
+void AsyncFileStream::close() {
+    if (m_closed)
+        return;
+    // fd关闭前必须等内核中的读写全部完成
+    m_io->drain();
+    FileStream::close();
+}
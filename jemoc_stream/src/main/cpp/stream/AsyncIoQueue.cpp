@@ -0,0 +1,66 @@
+//
+// Created on 2025/3/6.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#include "stream/AsyncIoQueue.h"
+#include <chrono>
+
+AsyncIoQueue::~AsyncIoQueue() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+    if (m_worker.joinable())
+        m_worker.join();
+}
+
+void AsyncIoQueue::submit(std::unique_ptr<Task> task) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pending.push_back(std::move(task));
+    if (m_running) {
+        m_condition.notify_one();
+        return;
+    }
+    // 上一个工作线程已经空闲退出，回收后重新启动
+    if (m_worker.joinable())
+        m_worker.join();
+    m_running = true;
+    m_worker = std::thread(&AsyncIoQueue::run, this);
+}
+
+std::vector<std::unique_ptr<AsyncIoQueue::Task>> AsyncIoQueue::takeCompleted() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<std::unique_ptr<Task>> completed;
+    completed.swap(m_completed);
+    return completed;
+}
+
+void AsyncIoQueue::run() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        if (m_pending.empty()) {
+            bool ready = m_condition.wait_for(lock, std::chrono::milliseconds(IdleTimeout),
+                                              [this]() { return !m_pending.empty() || m_stopping; });
+            if (!ready || m_pending.empty()) {
+                m_running = false;
+                return;
+            }
+        }
+        std::unique_ptr<Task> task = std::move(m_pending.front());
+        m_pending.pop_front();
+        lock.unlock();
+        task->execute();
+        lock.lock();
+        // 前一批结果还没被取走时不再重复通知
+        bool wasEmpty = m_completed.empty();
+        m_completed.push_back(std::move(task));
+        if (wasEmpty && m_notify) {
+            lock.unlock();
+            m_notify();
+            lock.lock();
+        }
+    }
+}
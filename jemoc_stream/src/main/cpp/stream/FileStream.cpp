@@ -5,122 +5,233 @@
 // please include "napi/native_api.h".
 
 #include "stream/FileStream.h"
-#include <cstdio>
+#include "stream/FdHelper.h"
+#include <cerrno>
+#include <exception>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
-#define DEFAULT_BUFFER_SIZE 8192
 
+FileStream::FileStream(const std::string &path, FILE_MODE mode, long bufferSize)
+    : m_mode(mode), m_bufferSize(std::max(bufferSize, 0L)) {
+    checkMapMode(mode);
+    int flags = O_RDONLY | O_CLOEXEC;
+    if (mode & (FILE_MODE_WRITE | FILE_MODE_APPEND | FILE_MODE_TRUNC | FILE_MODE_CREATE))
+        flags = O_RDWR | O_CLOEXEC;
+    // 与之前fopen的"w"模式一致，创建和截断都会清空已有文件
+    if (mode & (FILE_MODE_TRUNC | FILE_MODE_CREATE))
+        flags |= O_CREAT | O_TRUNC;
+
+    int fd = open(path.c_str(), flags, 0666);
+    if (fd < 0)
+        throw std::ios::failure(std::string("open file ") + path + " failed");
+    m_fd = fd;
+    init(mode);
+}
 
-std::string FileStream::ClassName = "FileStream";
-napi_ref FileStream::cons = nullptr;
+FileStream::FileStream(const int &fd, FILE_MODE mode, long bufferSize)
+    : m_mode(mode), m_bufferSize(std::max(bufferSize, 0L)) {
+    checkMapMode(mode);
+    if (fd < 0 || fcntl(fd, F_GETFL) == -1)
+        throw std::ios::failure(std::string("open fd ") + std::to_string(fd) + " failed");
+    m_fd = fd;
+    if ((mode & FILE_MODE_TRUNC) || ((mode & FILE_MODE_CREATE)))
+        m_canSetLength = true;
+    init(mode);
+}
 
-FileStream::FileStream(const std::string &path, FILE_MODE mode, long bufferSize)
-    : m_mode(mode), m_bufferSize(bufferSize) {
+FileStream::FileStream(const int &fd, long offset, long length, bool mapped)
+    : m_mode(mapped ? FILE_MODE_MMAP : FILE_MODE_READ), m_bufferSize(8192), m_fd(fd), m_offset(offset) {
+    m_canWrite = false;
+    m_canRead = true;
+    m_canSeek = true;
+    m_canGetPosition = true;
+    m_canGetLength = true;
+    m_length = length;
+    m_is_raw_file = true;
+    if (mapped && mapFile())
+        return;
+    m_buffer.reset(new byte[m_bufferSize]);
+    posix_fadvise(m_fd, m_offset, m_length, POSIX_FADV_SEQUENTIAL);
+}
 
+void FileStream::init(FILE_MODE mode) {
     m_canGetLength = true;
     m_canGetPosition = true;
     m_canSeek = true;
     m_canRead = true;
-    std::string open_mode = "rb";
-    if (mode & FILE_MODE_WRITE) {
-        open_mode += "+";
-        m_canWrite = true;
-    }
-    if (mode & FILE_MODE_TRUNC) {
-        open_mode[0] = 'w';
-    } else if (mode & FILE_MODE_CREATE) {
-        // 使用更安全的fopen替代access检查
-        open_mode[0] = 'w';
-    }
+    m_canWrite = (mode & FILE_MODE_WRITE) != 0;
 
-    FILE *fp = fopen(path.c_str(), open_mode.c_str());
-    if (fp == nullptr)
-        throw std::ios::failure(std::string("open file ") + path + " failed");
-
-    fseek(fp, 0, SEEK_END);
-    m_length = ftell(fp);
+    struct stat st {};
+    if (fstat(m_fd, &st) == 0)
+        m_length = st.st_size;
 
     if (mode & FILE_MODE_APPEND) {
         m_canRead = false;
         m_canWrite = true;
         m_canSeek = false;
         m_position = m_length;
-    } else {
-        fseek(fp, 0, SEEK_SET);
     }
-
-    file = fp;
+    if ((mode & FILE_MODE_MMAP) && mapFile())
+        return;
+    m_noCache = (mode & FILE_MODE_NOCACHE) != 0;
+    if (m_noCache)
+        m_bufferSize = std::max(m_bufferSize, NoCacheBufferSize);
+    if (m_bufferSize > 0)
+        m_buffer.reset(new byte[m_bufferSize]);
+    // 默认按顺序读取处理，读取不连续时再切换
+    if (m_canRead)
+        posix_fadvise(m_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
 }
 
-FileStream::FileStream(const int &fd, FILE_MODE mode, long bufferSize) : m_mode(mode), m_bufferSize(bufferSize) {
 
-    m_canGetLength = true;
-    m_canGetPosition = true;
-    m_canSeek = true;
-    m_canRead = true;
-    char open_mode[3] = "rb";
-    if (mode & FILE_MODE_WRITE) {
-        open_mode[2] = '+';
-        m_canWrite = true;
-    }
-    if ((mode & FILE_MODE_TRUNC) || ((mode & FILE_MODE_CREATE))) {
-        open_mode[0] = 'w';
-        m_canSetLength = true;
+FileStream::~FileStream() {
+    if (!m_closed) {
+        try {
+            close();
+        } catch (const std::exception &e) {
+            OH_LOG_ERROR(LOG_APP, "FileStream close failed: %s", e.what());
+        }
     }
+}
 
-    FILE *fp = fdopen(fd, open_mode);
-    if (fp == nullptr)
-        throw std::ios::failure(std::string("open fd ") + std::to_string(fd) + " failed");
+void FileStream::checkMapMode(FILE_MODE mode) {
+    if ((mode & FILE_MODE_MMAP) && (mode & (FILE_MODE_WRITE | FILE_MODE_APPEND | FILE_MODE_TRUNC | FILE_MODE_CREATE)))
+        throw std::ios::failure("mmap mode is read-only");
+}
 
-    fseek(fp, 0, SEEK_END);
-    m_length = ftell(fp);
+bool FileStream::mapFile() {
+    if (m_length <= 0)
+        return false;
+    // mmap的偏移必须按页对齐，多映射的部分通过m_mapView跳过
+    long pageSize = sysconf(_SC_PAGESIZE);
+    long alignedOffset = m_offset & ~(pageSize - 1);
+    size_t mapSize = m_length + (m_offset - alignedOffset);
+    void *base = mmap(nullptr, mapSize, PROT_READ, MAP_SHARED, m_fd, alignedOffset);
+    if (base == MAP_FAILED)
+        return false;
+    madvise(base, mapSize, MADV_SEQUENTIAL);
+    m_mapBase = base;
+    m_mapSize = mapSize;
+    m_mapView = static_cast<const byte *>(base) + (m_offset - alignedOffset);
+    m_canWrite = false;
+    m_canSetLength = false;
+    m_buffer.reset();
+    return true;
+}
 
-    if (mode & FILE_MODE_APPEND) {
-        m_canRead = false;
-        m_canWrite = true;
-        m_canSeek = false;
-        m_position = m_length;
-    } else {
-        fseek(fp, 0, SEEK_SET);
-    }
+void FileStream::unmapFile() {
+    if (m_mapBase == nullptr)
+        return;
+    munmap(m_mapBase, m_mapSize);
+    m_mapBase = nullptr;
+    m_mapSize = 0;
+    m_mapView = nullptr;
+}
 
-    file = fp;
+void FileStream::checkWritable() const {
+    if (m_mapView != nullptr)
+        throw std::ios_base::failure("memory mapped file stream is read-only");
 }
 
-FileStream::FileStream(const int &fd, long offset, long length) : m_offset(offset) {
-    m_canWrite = false;
-    m_canRead = true;
-    m_canSeek = true;
-    m_canGetPosition = true;
-    m_canGetLength = true;
-    m_length = length;
-    file = fdopen(fd, "r");
-    m_is_raw_file = true;
+void FileStream::flushWriteBuffer() {
+    if (m_writeLength == 0)
+        return;
+    long length = m_writeLength;
+    m_writeLength = 0;
+    FdHelper::pwriteAll(m_fd, m_buffer.get(), length, m_offset + m_bufferPosition);
+    writeBehind(m_offset + m_bufferPosition, length);
 }
 
+void FileStream::writeBehind(long position, long length) {
+    if (!m_noCache || length <= 0)
+        return;
+    // 不连续的写入先把之前累计的区间交给内核
+    if (m_dirtyEnd > m_dirtyStart && position != m_dirtyEnd)
+        startWriteback();
+    if (m_dirtyEnd == m_dirtyStart)
+        m_dirtyStart = position;
+    m_dirtyEnd = position + length;
+    if (m_dirtyEnd - m_dirtyStart >= WriteBehindWindow)
+        startWriteback();
+}
 
-FileStream::~FileStream() {
-    if (!m_closed) {
-        close();
+void FileStream::startWriteback() {
+    if (m_dirtyEnd == m_dirtyStart)
+        return;
+    // 当前窗口异步回写的同时等待上一个窗口，两个窗口的IO重叠进行
+    sync_file_range(m_fd, m_dirtyStart, m_dirtyEnd - m_dirtyStart, SYNC_FILE_RANGE_WRITE);
+    dropWriteback();
+    m_writebackStart = m_dirtyStart;
+    m_writebackEnd = m_dirtyEnd;
+    m_dirtyStart = m_dirtyEnd = 0;
+}
+
+void FileStream::dropWriteback() {
+    if (m_writebackEnd == m_writebackStart)
+        return;
+    long length = m_writebackEnd - m_writebackStart;
+    sync_file_range(m_fd, m_writebackStart, length,
+                    SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+    posix_fadvise(m_fd, m_writebackStart, length, POSIX_FADV_DONTNEED);
+    m_writebackStart = m_writebackEnd = 0;
+}
+
+void FileStream::finishWriteback() {
+    if (!m_noCache)
+        return;
+    startWriteback();
+    dropWriteback();
+}
+
+void FileStream::adviseAccess(long position) {
+    if (position == m_lastReadEnd) {
+        m_randomCount = 0;
+        if (!m_sequential) {
+            m_sequential = true;
+            if (m_mapBase != nullptr)
+                madvise(m_mapBase, m_mapSize, MADV_SEQUENTIAL);
+            else
+                posix_fadvise(m_fd, m_offset, m_is_raw_file ? m_length : 0, POSIX_FADV_SEQUENTIAL);
+        }
+    } else if (++m_randomCount >= RandomThreshold && m_sequential) {
+        m_sequential = false;
+        if (m_mapBase != nullptr)
+            madvise(m_mapBase, m_mapSize, MADV_RANDOM);
+        else
+            posix_fadvise(m_fd, m_offset, m_is_raw_file ? m_length : 0, POSIX_FADV_RANDOM);
     }
 }
 
 long FileStream::write(void *buffer, long offset, size_t count) {
     if (m_closed)
         throw std::ios_base::failure("The write operation failed because the file was closed ");
+    checkWritable();
+    if (count == 0)
+        return 0;
 
-    if (fseek(file, m_position + m_offset, SEEK_SET) != 0)
-        throw std::ios_base::failure("Seek failed: " + std::string(strerror(errno)));
-
-    const char *pointer = static_cast<char *>(buffer) + offset;
-    size_t writeBytes = fwrite(pointer, 1, count, file);
+    const byte *pointer = static_cast<byte *>(buffer) + offset;
+    discardReadBuffer();
+    // 只有紧接着缓冲区末尾的写入才能继续追加到缓冲区
+    if (m_writeLength > 0 &&
+        (m_position != m_bufferPosition + m_writeLength || m_writeLength + static_cast<long>(count) > m_bufferSize))
+        flushWriteBuffer();
 
-    if (ferror(file))
-        throw std::ios::failure("write stream failed");
+    if (static_cast<long>(count) >= m_bufferSize) {
+        FdHelper::pwriteAll(m_fd, pointer, count, m_offset + m_position);
+        writeBehind(m_offset + m_position, count);
+    } else {
+        if (m_writeLength == 0)
+            m_bufferPosition = m_position;
+        memcpy(m_buffer.get() + m_writeLength, pointer, count);
+        m_writeLength += count;
+    }
 
-    m_position += writeBytes;
+    m_position += count;
     m_length = std::max(m_length, m_position);
-    return writeBytes;
+    return count;
 }
 
 long FileStream::read(void *buffer, long offset, size_t count) {
@@ -128,105 +239,201 @@ long FileStream::read(void *buffer, long offset, size_t count) {
         throw std::ios_base::failure("The write operation failed because the file was closed ");
     long readBytes = count;
     readBytes = std::min(readBytes, m_length - m_position);
-    if (readBytes == 0)
+    if (readBytes <= 0)
         return 0;
-    if (fseek(file, m_offset + m_position, SEEK_SET) != 0)
-        throw std::ios_base::failure("Seek failed: " + std::string(strerror(errno)));
-
-    char *pointer = static_cast<char *>(buffer) + offset;
-    size_t actualRead = fread(pointer, 1, readBytes, file);
+    if (m_mapView != nullptr) {
+        adviseAccess(m_position);
+        memcpy(static_cast<byte *>(buffer) + offset, m_mapView + m_position, readBytes);
+        m_position += readBytes;
+        m_lastReadEnd = m_position;
+        return readBytes;
+    }
+    flushWriteBuffer();
+
+    byte *pointer = static_cast<byte *>(buffer) + offset;
+    long total = 0;
+    if (m_readLength > 0 && m_position >= m_bufferPosition && m_position < m_bufferPosition + m_readLength) {
+        total = std::min(readBytes, m_bufferPosition + m_readLength - m_position);
+        memcpy(pointer, m_buffer.get() + (m_position - m_bufferPosition), total);
+        m_position += total;
+    }
 
-    if (ferror(file))
-        throw std::ios::failure("read stream failed");
+    long remaining = readBytes - total;
+    if (remaining == 0)
+        return total;
+    adviseAccess(m_position);
+    if (remaining >= m_bufferSize) {
+        // 大块读取直接读入目标，不经过缓冲区
+        long actualRead = FdHelper::preadAll(m_fd, pointer + total, remaining, m_offset + m_position);
+        m_position += actualRead;
+        total += actualRead;
+        m_lastReadEnd = m_position;
+    } else {
+        long fillBytes = std::min(m_bufferSize, m_length - m_position);
+        m_readLength = FdHelper::preadAll(m_fd, m_buffer.get(), fillBytes, m_offset + m_position);
+        m_bufferPosition = m_position;
+        long copyBytes = std::min(remaining, m_readLength);
+        memcpy(pointer + total, m_buffer.get(), copyBytes);
+        m_position += copyBytes;
+        total += copyBytes;
+        m_lastReadEnd = m_bufferPosition + m_readLength;
+    }
+    return total;
+}
 
+long FileStream::readv(const struct iovec *iov, int iovcnt) {
+    if (m_closed)
+        throw std::ios_base::failure("The readv operation failed because the file was closed ");
+    if (m_position >= m_length)
+        return 0;
+    if (m_mapView != nullptr)
+        return IStream::readv(iov, iovcnt);
+    // preadv绕过了用户态缓冲区，先把待写数据写入文件
+    flushWriteBuffer();
+    std::vector<struct iovec> clamped = FdHelper::clampIov(iov, iovcnt, m_length - m_position);
+    long readBytes = FdHelper::preadvAll(m_fd, clamped.data(), clamped.size(), m_offset + m_position);
     m_position += readBytes;
     return readBytes;
 }
 
-void FileStream::flush() {
-    if (fflush(file) == -1) {
-        throw std::ios::failure("flush stream failed");
-    }
+long FileStream::writev(const struct iovec *iov, int iovcnt) {
+    if (m_closed)
+        throw std::ios_base::failure("The writev operation failed because the file was closed ");
+    checkWritable();
+    // 写入前同步缓冲区，同时丢弃已预读的旧数据
+    flushWriteBuffer();
+    discardReadBuffer();
+    long writeBytes = FdHelper::pwritevAll(m_fd, iov, iovcnt, m_offset + m_position);
+    writeBehind(m_offset + m_position, writeBytes);
+    m_position += writeBytes;
+    m_length = std::max(m_length, m_position);
+    return writeBytes;
 }
 
-void FileStream::close() {
+long FileStream::readAt(long position, void *buffer, long offset, size_t count) {
     if (m_closed)
-        return;
-
-    IStream::close();
-
-    if (!m_is_raw_file && file) {
-        if (fclose(file) != 0) {
-            throw std::ios_base::failure("Close failed: " + std::string(strerror(errno)));
-        }
+        throw std::ios_base::failure("The readAt operation failed because the file was closed ");
+    if (position < 0)
+        throw std::ios_base::failure("position must be non-negative");
+    if (position >= m_length)
+        return 0;
+    size_t readBytes = std::min(count, static_cast<size_t>(m_length - position));
+    if (m_mapView != nullptr) {
+        memcpy(static_cast<char *>(buffer) + offset, m_mapView + position, readBytes);
+        return readBytes;
     }
-    file = nullptr;
-    m_closed = true;
+    // 只读流不经过用户态缓冲区，多个线程可以并发pread
+    if (m_canWrite)
+        flushWriteBuffer();
+    return FdHelper::preadAll(m_fd, static_cast<char *>(buffer) + offset, readBytes, m_offset + position);
 }
 
-void FileStream::Export(napi_env env, napi_value exports) {
-//    napi_property_descriptor desc[] = {
-//        DEFINE_NAPI_ISTREAM_PROPERTY((void *)ClassName.c_str()),
-//    };
-    napi_value napi_cons = nullptr;
-    napi_define_class(env, ClassName.c_str(), NAPI_AUTO_LENGTH, JSConstructor, nullptr, 0, nullptr, &napi_cons);
-    Extends(env, napi_cons);
+long FileStream::writeAt(long position, void *buffer, long offset, size_t count) {
+    if (m_closed)
+        throw std::ios_base::failure("The writeAt operation failed because the file was closed ");
+    checkWritable();
+    if (position < 0)
+        throw std::ios_base::failure("position must be non-negative");
+    flushWriteBuffer();
+    discardReadBuffer();
+    long writeBytes = FdHelper::pwriteAll(m_fd, static_cast<char *>(buffer) + offset, count, m_offset + position);
+    writeBehind(m_offset + position, writeBytes);
+    m_length = std::max(m_length, position + writeBytes);
+    return writeBytes;
+}
 
-    napi_set_named_property(env, exports, ClassName.c_str(), napi_cons);
+int FileStream::getNativeFd() const { return m_closed ? -1 : m_fd; }
+
+void FileStream::syncNativeFd() {
+    // 内核可能直接修改文件内容，已读入的缓冲数据一并丢弃
+    flushWriteBuffer();
+    discardReadBuffer();
 }
 
-napi_value FileStream::JSConstructor(napi_env env, napi_callback_info info) {
-    GET_JS_INFO_WITHOUT_STREAM(2);
+void FileStream::copyTo(IStream *stream, long bufferSize) {
+    // 写往fd流时仍由内核拷贝，其他目标直接从映射写出，不经过中间缓冲区
+    if (m_mapView == nullptr || m_closed || dynamic_cast<IFdStream *>(stream) != nullptr) {
+        IStream::copyTo(stream, bufferSize);
+        return;
+    }
+    bufferSize = std::max(bufferSize, 1L);
+    while (m_position < m_length) {
+        long count = std::min(bufferSize, m_length - m_position);
+        byte *data = const_cast<byte *>(m_mapView) + m_position;
+        stream->tracked(StreamStats::Write, [&]() { return stream->write(data, 0, count); });
+        m_position += count;
+    }
+}
 
-    napi_valuetype type;
+const byte *FileStream::getSpan(long position, long length) {
+    if (m_mapView == nullptr || m_closed)
+        return nullptr;
+    if (position < 0 || length < 0 || position + length > m_length)
+        throw std::ios_base::failure("span is out of range");
+    if (length >= WillNeedThreshold) {
+        // madvise要求起始地址按页对齐
+        long pageSize = sysconf(_SC_PAGESIZE);
+        uintptr_t start = reinterpret_cast<uintptr_t>(m_mapView + position) & ~static_cast<uintptr_t>(pageSize - 1);
+        size_t size = reinterpret_cast<uintptr_t>(m_mapView + position + length) - start;
+        madvise(reinterpret_cast<void *>(start), size, MADV_WILLNEED);
+    }
+    return m_mapView + position;
+}
 
-    NAPI_CALL(env, napi_typeof(env, argv[0], &type))
+void FileStream::flush() { flushWriteBuffer(); }
 
+void FileStream::close() {
+    if (m_closed)
+        return;
 
-    int mode = getInt(env, argv[1]);
-//    FileStream *stream = nullptr;
-    std::shared_ptr<IStream> stream;
+    std::exception_ptr error;
     try {
-        if (type == napi_string) {
-            std::string path = getString(env, argv[0]);
-            stream = std::make_shared<FileStream>(path, FILE_MODE(mode), DEFAULT_BUFFER_SIZE);
-        } else if (type == napi_number) {
-            int fd = getInt(env, argv[0]);
-            stream = std::make_shared<FileStream>(fd, FILE_MODE(mode), DEFAULT_BUFFER_SIZE);
-        } else {
-            napi_value js_fd = nullptr;
-            napi_value js_offset = nullptr;
-            napi_value js_length = nullptr;
-            NAPI_CALL(env, napi_get_named_property(env, argv[0], "fd", &js_fd))
-            NAPI_CALL(env, napi_get_named_property(env, argv[0], "offset", &js_offset))
-            NAPI_CALL(env, napi_get_named_property(env, argv[0], "length", &js_length))
-            int fd = 0;
-            long offset = 0;
-            long length = 0;
-            NAPI_CALL(env, napi_get_value_int32(env, js_fd, &fd))
-            NAPI_CALL(env, napi_get_value_int64(env, js_offset, &offset))
-            NAPI_CALL(env, napi_get_value_int64(env, js_length, &length))
-            stream = std::make_shared<FileStream>(fd, offset, length);
-        }
-    } catch (const std::ios_base::failure &e) {
-        napi_throw_error(env, "JSFileStream", e.what());
-        return nullptr;
+        flushWriteBuffer();
+        finishWriteback();
+        // 实际写入少于预留时，截断到当前长度以释放文件末尾之后的预留块
+        if (m_preallocated > m_length && ftruncate(m_fd, m_length) != 0)
+            throw std::ios_base::failure("release preallocated space failed: " + std::string(strerror(errno)));
+    } catch (...) {
+        error = std::current_exception();
     }
+    IStream::close();
 
-//    napi_wrap(env, _this, stream, JSDispose, nullptr, nullptr);
-//    return _this;
-    return JSBind(env, _this, stream);
+    unmapFile();
+    int fd = m_fd;
+    m_fd = -1;
+    m_buffer.reset();
+    if (!m_is_raw_file && fd >= 0 && ::close(fd) != 0 && !error)
+        throw std::ios_base::failure("Close failed: " + std::string(strerror(errno)));
+    if (error)
+        std::rethrow_exception(error);
 }
 
-// void FileStream::JSDispose(napi_env env, void *data, void *hint) {
-//     FileStream *stream = static_cast<FileStream *>(data);
-//     stream->close();
-//
-//     delete stream;
-// }
+
+bool FileStream::preallocate(long length) {
+    if (m_closed)
+        throw std::ios_base::failure("The preallocate operation failed because the file was closed ");
+    checkWritable();
+    if (!m_canWrite || m_is_raw_file)
+        throw std::ios_base::failure("stream not writeable");
+    if (length <= m_length || length <= m_preallocated)
+        return true;
+    // FALLOC_FL_KEEP_SIZE只分配块不改变文件长度，posix_fallocate在不支持的文件系统上会逐块写0，不使用
+    if (fallocate(m_fd, FALLOC_FL_KEEP_SIZE, 0, length) != 0) {
+        if (errno == EOPNOTSUPP || errno == ENOSYS)
+            return false;
+        throw std::ios_base::failure("preallocate failed: " + std::string(strerror(errno)));
+    }
+    m_preallocated = length;
+    return true;
+}
 
 void FileStream::setLength(long length) {
-    if (-1 == ftruncate(fileno(file), length)) {
+    checkWritable();
+    flushWriteBuffer();
+    discardReadBuffer();
+    // 截断前把已写入的窗口落盘，避免回写区间越过新的文件末尾
+    finishWriteback();
+    if (-1 == ftruncate(m_fd, length)) {
         throw std::ios::failure("set length failed");
     }
 
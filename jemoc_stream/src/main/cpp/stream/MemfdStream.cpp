@@ -6,6 +6,9 @@
 
 #include "stream/MemfdStream.h"
 #include "IStream.h"
+#include "stream/FdHelper.h"
+#include <algorithm>
+#include <atomic>
 #include <cerrno>
 #include <cstdio>
 #include <cstring>
@@ -14,45 +17,54 @@
 #include <sys/mman.h>
 #include <sys/sendfile.h>
 #include <sys/stat.h>
+#include <sys/syscall.h>
 #include <unistd.h>
 
-std::string MemfdStream::ClassName = "MemfdStream";
-napi_ref MemfdStream::cons = nullptr;
 
-MemfdStream::MemfdStream() : m_fd(-1) {
-    // 创建内存中的匿名文件，设置 MFD_CLOEXEC 参数
-    // 生成唯一共享内存名称
-    static int counter = 0;
-    char shm_name[256];
-    snprintf(shm_name, sizeof(shm_name), "/jemoc_memfd_%d_%ld_%d", getpid(), time(nullptr), counter++);
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC 0x0001U
+#endif
+#ifndef MFD_ALLOW_SEALING
+#define MFD_ALLOW_SEALING 0x0002U
+#endif
+#ifndef F_ADD_SEALS
+#define F_ADD_SEALS 1033
+#define F_SEAL_SEAL 0x0001
+#define F_SEAL_SHRINK 0x0002
+#define F_SEAL_GROW 0x0004
+#define F_SEAL_WRITE 0x0008
+#endif
 
-    // 使用shm_open创建共享内存对象
-    m_fd = shm_open(shm_name, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
-    if (m_fd < 0) {
-        throw std::runtime_error(std::string("shm_open failed: ") + std::strerror(errno));
-    }
-    m_canRead = true;
-    m_canWrite = true;
-    m_canSeek = true;
-    m_canGetLength = true;
-    m_canGetPosition = true;
-    m_canSetLength = true;
-    m_position = 0;
-    m_length = 0;
-    m_closed = false;
-}
+MemfdStream::MemfdStream() : m_fd(-1) { create(); }
 
 MemfdStream::MemfdStream(const void *initialBuffer, size_t bufferSize) : m_fd(-1) {
-    // 创建内存中的匿名文件
-    // 生成唯一共享内存名称
-    static int counter = 0;
-    char shm_name[256];
-    snprintf(shm_name, sizeof(shm_name), "/jemoc_memfd_%d_%ld_%d", getpid(), time(nullptr), counter++);
+    create();
+    // 如果提供了初始缓冲区，则写入数据
+    if (initialBuffer && bufferSize > 0) {
+        long bytesWritten = FdHelper::pwriteAll(m_fd, initialBuffer, bufferSize, 0);
+        // 更新流长度，并将当前位置设置到流末端
+        m_length = bytesWritten;
+        m_position = m_length;
+        reserve(m_length);
+    }
+}
 
-    // 使用shm_open创建共享内存对象
-    m_fd = shm_open(shm_name, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+void MemfdStream::create() {
+#ifdef __NR_memfd_create
+    // 直接使用系统调用，不依赖libc是否提供memfd_create
+    m_fd = static_cast<int>(syscall(__NR_memfd_create, "jemoc_memfd", MFD_CLOEXEC | MFD_ALLOW_SEALING));
+    m_canSeal = m_fd >= 0;
+#endif
     if (m_fd < 0) {
-        throw std::runtime_error(std::string("shm_open failed: ") + std::strerror(errno));
+        // 生成唯一共享内存名称，创建后立即unlink，只通过fd访问
+        static std::atomic<int> counter{0};
+        char shm_name[256];
+        snprintf(shm_name, sizeof(shm_name), "/jemoc_memfd_%d_%ld_%d", getpid(), time(nullptr), counter++);
+        m_fd = shm_open(shm_name, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+        if (m_fd < 0) {
+            throw std::runtime_error(std::string("shm_open failed: ") + std::strerror(errno));
+        }
+        shm_unlink(shm_name);
     }
     m_canRead = true;
     m_canWrite = true;
@@ -63,120 +75,245 @@ MemfdStream::MemfdStream(const void *initialBuffer, size_t bufferSize) : m_fd(-1
     m_position = 0;
     m_length = 0;
     m_closed = false;
+}
 
-    // 如果提供了初始缓冲区，则写入数据
-    if (initialBuffer && bufferSize > 0) {
-        ssize_t bytesWritten = ::write(m_fd, initialBuffer, bufferSize);
-        if (bytesWritten < 0) {
-            throw std::runtime_error(std::string("write initialBuffer failed: ") + std::strerror(errno));
-        }
-        // 更新流长度，并将当前位置设置到流末端
-        m_length = bytesWritten;
-        m_position = m_length;
+MemfdStream::~MemfdStream() { close(); }
+
+void MemfdStream::reserve(long size) {
+    if (size <= m_mapSize || m_closed)
+        return;
+    // 映射可以超过文件长度，只要不访问文件末尾之后的页
+    long pageSize = sysconf(_SC_PAGESIZE);
+    long mapSize = std::max({size, m_mapSize * 2, MinMapSize});
+    mapSize = (mapSize + pageSize - 1) & ~(pageSize - 1);
+    int prot = m_sealed ? PROT_READ : PROT_READ | PROT_WRITE;
+    void *map = m_map == nullptr ? mmap(nullptr, mapSize, prot, MAP_SHARED, m_fd, 0)
+                                 : mremap(m_map, m_mapSize, mapSize, MREMAP_MAYMOVE);
+    if (map == MAP_FAILED) {
+        throw std::runtime_error(std::string("mmap failed: ") + std::strerror(errno));
     }
+    m_map = static_cast<byte *>(map);
+    m_mapSize = mapSize;
 }
 
-MemfdStream::~MemfdStream() {
-    if (m_closed)
-        return;
-    IStream::close();
-    close();
+void MemfdStream::checkWritable(const char *operation) const {
+    if (m_closed) {
+        throw std::runtime_error(std::string(operation) + " on closed stream");
+    }
+    if (m_sealed) {
+        throw std::runtime_error(std::string(operation) + " on sealed stream");
+    }
 }
 
 long MemfdStream::read(void *buffer, long offset, size_t count) {
     if (m_closed) {
         throw std::runtime_error("read on closed stream");
     }
-    // 定位到当前流位置
-    if (lseek(m_fd, m_position, SEEK_SET) == -1) {
-        throw std::runtime_error(std::string("lseek failed: ") + std::strerror(errno));
-    }
-    char *buf = static_cast<char *>(buffer);
-    ssize_t bytesRead = ::read(m_fd, buf + offset, count);
-    if (bytesRead < 0) {
-        throw std::runtime_error(std::string("read failed: ") + std::strerror(errno));
-    }
+    long bytesRead = readAt(m_position, buffer, offset, count);
     m_position += bytesRead;
     return bytesRead;
 }
 
 long MemfdStream::write(void *buffer, long offset, size_t count) {
+    checkWritable("write");
+    long bytesWritten = writeAt(m_position, buffer, offset, count);
+    m_position += bytesWritten;
+    return bytesWritten;
+}
+
+long MemfdStream::readv(const struct iovec *iov, int iovcnt) {
     if (m_closed) {
-        throw std::runtime_error("write on closed stream");
+        throw std::runtime_error("readv on closed stream");
     }
-    // 定位到当前流位置
-    if (lseek(m_fd, m_position, SEEK_SET) == -1) {
-        throw std::runtime_error(std::string("lseek failed: ") + std::strerror(errno));
+    long bytesRead = 0;
+    for (int i = 0; i < iovcnt; i++) {
+        long n = readAt(m_position + bytesRead, iov[i].iov_base, 0, iov[i].iov_len);
+        bytesRead += n;
+        if (static_cast<size_t>(n) < iov[i].iov_len)
+            break;
     }
-    char *buf = static_cast<char *>(buffer);
-    ssize_t bytesWritten = ::write(m_fd, buf + offset, count);
-    if (bytesWritten < 0) {
-        throw std::runtime_error(std::string("write failed: ") + std::strerror(errno));
+    m_position += bytesRead;
+    return bytesRead;
+}
+
+long MemfdStream::writev(const struct iovec *iov, int iovcnt) {
+    checkWritable("writev");
+    size_t total = 0;
+    for (int i = 0; i < iovcnt; i++)
+        total += iov[i].iov_len;
+    long bytesWritten = 0;
+    if (m_position + static_cast<long>(total) > m_length) {
+        // 需要扩展长度时一次pwritev同时完成扩展和写入
+        bytesWritten = FdHelper::pwritevAll(m_fd, iov, iovcnt, m_position);
+        m_length = std::max(m_length, m_position + bytesWritten);
+        reserve(m_length);
+    } else {
+        reserve(m_length);
+        for (int i = 0; i < iovcnt; i++) {
+            memcpy(m_map + m_position + bytesWritten, iov[i].iov_base, iov[i].iov_len);
+            bytesWritten += iov[i].iov_len;
+        }
     }
     m_position += bytesWritten;
-    if (m_position > m_length) {
-        m_length = m_position; // 更新流长度
-    }
     return bytesWritten;
 }
 
+long MemfdStream::readAt(long position, void *buffer, long offset, size_t count) {
+    if (m_closed) {
+        throw std::runtime_error("readAt on closed stream");
+    }
+    if (position < 0) {
+        throw std::runtime_error("position must be non-negative");
+    }
+    if (position >= m_length || count == 0)
+        return 0;
+    long bytesRead = std::min(static_cast<long>(count), m_length - position);
+    // 读取不重新映射，多个线程可以并发readAt；扩容失败导致映射未覆盖时退回pread
+    if (position + bytesRead > m_mapSize) {
+        return FdHelper::preadAll(m_fd, static_cast<byte *>(buffer) + offset, bytesRead, position);
+    }
+    memcpy(static_cast<byte *>(buffer) + offset, m_map + position, bytesRead);
+    return bytesRead;
+}
+
+long MemfdStream::writeAt(long position, void *buffer, long offset, size_t count) {
+    checkWritable("writeAt");
+    if (position < 0) {
+        throw std::runtime_error("position must be non-negative");
+    }
+    byte *data = static_cast<byte *>(buffer) + offset;
+    // 已有长度内直接写映射；超出的部分交给pwrite，由内核扩展文件并分配页面，
+    // 比ftruncate后在映射上逐页缺页更快
+    long inPlace = std::max(0L, std::min(static_cast<long>(count), m_length - position));
+    if (inPlace > 0) {
+        reserve(m_length);
+        memcpy(m_map + position, data, inPlace);
+    }
+    if (static_cast<long>(count) > inPlace) {
+        long appended = FdHelper::pwriteAll(m_fd, data + inPlace, count - inPlace, position + inPlace);
+        m_length = std::max(m_length, position + inPlace + appended);
+        // 扩展长度的写入方负责扩容映射，读取方不再调整映射
+        reserve(m_length);
+        return inPlace + appended;
+    }
+    return inPlace;
+}
+
 long MemfdStream::seek(long offset, SeekOrigin origin) {
     if (m_closed) {
         throw std::runtime_error("seek on closed stream");
     }
-    int whence;
+    long base;
     switch (origin) {
     case Begin:
-        whence = SEEK_SET;
+        base = 0;
         break;
     case Current:
-        whence = SEEK_CUR;
+        base = m_position;
         break;
     case End:
-        whence = SEEK_END;
+        base = m_length;
         break;
     default:
         throw std::runtime_error("invalid seek origin");
     }
-    off_t pos = lseek(m_fd, offset, whence);
-    if (pos == -1) {
-        throw std::runtime_error(std::string("seek failed: ") + std::strerror(errno));
+    if (base + offset < 0) {
+        throw std::runtime_error("seek failed: position must be non-negative");
     }
-    m_position = pos;
-    return pos;
+    m_position = base + offset;
+    return m_position;
 }
 
 void MemfdStream::flush() {
     if (m_closed) {
         throw std::runtime_error("flush on closed stream");
     }
-    if (fsync(m_fd) == -1) {
-        throw std::runtime_error(std::string("flush failed: ") + std::strerror(errno));
-    }
+    // 共享映射与fd是同一份页缓存，写入后通过fd立即可见，不需要同步
 }
 
 void MemfdStream::close() {
     if (!m_closed) {
         IStream::close();
+        if (m_map != nullptr) {
+            munmap(m_map, m_mapSize);
+            m_map = nullptr;
+            m_mapSize = 0;
+        }
         ::close(m_fd);
     }
 }
 
 void MemfdStream::setLength(long length) {
-    if (m_closed) {
-        throw std::runtime_error("setLength on closed stream");
+    checkWritable("setLength");
+    if (length < 0) {
+        throw std::runtime_error("length must be non-negative");
     }
-    // 使用 ftruncate 截断流
+    // 使用 ftruncate 截断流，扩展的部分由内核补0
     if (ftruncate(m_fd, length) == -1) {
         throw std::runtime_error(std::string("setLength failed: ") + std::strerror(errno));
     }
     m_length = length;
+    reserve(m_length);
     // 如果当前位置超出新长度，则调整到末尾
     if (m_position > m_length) {
         m_position = m_length;
     }
 }
 
+void MemfdStream::copyTo(IStream *stream, long bufferSize) {
+    // 写往fd流时仍由内核拷贝，其他目标直接从映射写出，不经过中间缓冲区
+    if (m_closed || dynamic_cast<IFdStream *>(stream) != nullptr) {
+        IStream::copyTo(stream, bufferSize);
+        return;
+    }
+    if (m_length > m_mapSize) {
+        IStream::copyTo(stream, bufferSize);
+        return;
+    }
+    bufferSize = std::max(bufferSize, 1L);
+    while (m_position < m_length) {
+        long count = std::min(bufferSize, m_length - m_position);
+        stream->tracked(StreamStats::Write, [&]() { return stream->write(m_map + m_position, 0, count); });
+        m_position += count;
+    }
+}
+
+const byte *MemfdStream::getSpan(long position, long length) {
+    if (m_closed)
+        return nullptr;
+    if (position < 0 || length < 0 || position + length > m_length)
+        throw std::runtime_error("span is out of range");
+    if (position + length > m_mapSize)
+        return nullptr;
+    return m_map + position;
+}
+
+void MemfdStream::seal() {
+    if (m_closed) {
+        throw std::runtime_error("seal on closed stream");
+    }
+    if (m_sealed)
+        return;
+    if (!m_canSeal) {
+        throw std::runtime_error("sealing is not supported without memfd_create");
+    }
+    // 存在可写的共享映射时内核拒绝F_SEAL_WRITE，先解除映射，封印后以只读方式重新映射
+    if (m_map != nullptr) {
+        munmap(m_map, m_mapSize);
+        m_map = nullptr;
+        m_mapSize = 0;
+    }
+    int result = fcntl(m_fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL);
+    int error = errno;
+    m_sealed = result == 0;
+    reserve(m_length);
+    if (!m_sealed) {
+        throw std::runtime_error(std::string("seal failed: ") + std::strerror(error));
+    }
+    m_canWrite = false;
+    m_canSetLength = false;
+}
+
 bool MemfdStream::sendFile(const int &fd, long offset, long length) {
     // 通过 fstat 获取源文件大小
     struct stat st;
@@ -197,304 +334,6 @@ bool MemfdStream::sendFile(const int &fd, long offset, long length) {
     return true;
 }
 
-
-napi_value MemfdStream::JSConstructor(napi_env env, napi_callback_info info) {
-    GET_JS_INFO_WITHOUT_STREAM(1)
-
-    napi_valuetype type;
-    NAPI_CALL(env, napi_typeof(env, argv[0], &type))
-
-//    MemfdStream *stream = nullptr;
-    std::shared_ptr<IStream> stream;
-    try {
-        if (type == napi_undefined) {
-            stream = std::make_shared<MemfdStream>();
-        } else {
-            void *data = nullptr;
-            size_t length = 0;
-            getBuffer(env, argv[0], &data, &length);
-            stream = std::make_shared<MemfdStream>(data, length);
-        }
-    } catch (const std::exception &e) {
-        napi_throw_error(env, tagName, e.what());
-        return nullptr;
-    }
-//    NAPI_CALL(env, napi_wrap(env, _this, stream, JSDisposed, nullptr, nullptr))
-//    return _this;
-    return JSBind(env, _this, stream);
-}
-
-// void MemfdStream::JSDisposed(napi_env env, void *data, void *hint) {
-//     try {
-//         MemfdStream *stream = static_cast<MemfdStream *>(data);
-//         stream->close();
-//         delete stream;
-//     } catch (const std::exception &e) {
-//     }
-// }
-
-napi_value MemfdStream::JSToArrayBuffer(napi_env env, napi_callback_info info) {
-    GET_JS_INFO(1)
-    try {
-        long offset = 0;
-        long length = stream->getLength();
-        if (argc > 0) {
-            getToArrayBufferOptions(env, argv[0], &offset, &length);
-        }
-        napi_value result = static_cast<MemfdStream *>(stream.get())->readAllFromFd(env, offset, length);
-        return result;
-    } catch (const std::exception &e) {
-        NAPI_CALL(env, napi_throw_error(env, tagName, e.what()))
-        return nullptr;
-    }
-}
-
-napi_value MemfdStream::readAllFromFd(napi_env env, long offset, long length) {
-    // 获取文件大小
-    void *data = nullptr;
-    napi_value result = nullptr;
-    NAPI_CALL(env, napi_create_arraybuffer(env, length, &data, &result))
-
-    // 使用 pread 从偏移量 0 读取数据，prea不会改变文件指针位置
-    ssize_t bytesRead = pread(m_fd, data, length, offset);
-    if (bytesRead < 0) {
-        throw std::runtime_error(std::string("pread failed: ") + std::strerror(errno));
-    }
-    return result;
-}
-
-napi_value MemfdStream::JSGetFd(napi_env env, napi_callback_info info) {
-    GET_JS_INFO(0)
-    napi_value result = nullptr;
-    int fd = static_cast<MemfdStream *>(stream.get())->getFd();
-
-    NAPI_CALL(env, napi_create_int32(env, fd, &result));
-    return result;
-}
-
-napi_value MemfdStream::JSSendFile(napi_env env, napi_callback_info info) {
-//     GET_JS_INFO(3)
-//     napi_valuetype type;
-//     int fd = -1;
-//     napi_value result;
-//     bool autoClose = false;
-//     long offset = 0;
-//     long length = stream->getLength();
-//     int optionsIndex = 0;
-//
-//
-//     NAPI_CALL(env, napi_typeof(env, argv[0], &type))
-//     if (type == napi_number) {
-//         NAPI_CALL(env, napi_get_value_int32(env, argv[0], &fd))
-//         optionsIndex = 1;
-//     } else if (type == napi_string) {
-//         NAPI_CALL(env, napi_typeof(env, argv[1], &type))
-//         if (type != napi_number) {
-//             napi_throw_type_error(env, "MemfdStream", "mode must be number");
-//             return nullptr;
-//         }
-//         autoClose = true;
-//         int openMode = 0;
-//         NAPI_CALL(env, napi_get_value_int32(env, argv[1], &openMode))
-//
-//         size_t bufsize = 0;
-//         NAPI_CALL(env, napi_get_value_string_utf8(env, argv[0], nullptr, 0, &bufsize))
-//         std::unique_ptr<char[]> buffer(new char[bufsize + 1]{'\0'});
-//         NAPI_CALL(env, napi_get_value_string_utf8(env, argv[0], buffer.get(), bufsize + 1, &bufsize))
-//         fd = open(buffer.get(), openMode, 0644);
-//
-//         optionsIndex = 2;
-//     } else {
-//         napi_throw_type_error(env, ClassName.c_str(), "invalid parameter type");
-//         return nullptr;
-//     }
-//
-//     if (fd == -1) {
-//         OH_LOG_ERROR(LOG_APP, "%s", "fd error, fd = -1, errno:%d", errno);
-//         NAPI_CALL(env, napi_get_boolean(env, false, &result))
-//         return result;
-//     }
-//
-//
-//     NAPI_CALL(env, napi_typeof(env, argv[optionsIndex], &type))
-//     if (type == napi_object) {
-//         napi_value js_offset;
-//         napi_value js_length;
-//         napi_value js_auto_close;
-//         NAPI_CALL(env, napi_get_named_property(env, argv[1], "offset", &js_offset))
-//         NAPI_CALL(env, napi_get_named_property(env, argv[1], "length", &js_length))
-//         NAPI_CALL(env, napi_get_named_property(env, argv[1], "autoClose", &js_auto_close))
-//         NAPI_CALL(env, napi_typeof(env, js_offset, &type))
-//         if (type == napi_number) {
-//             NAPI_CALL(env, napi_get_value_int64(env, js_offset, &offset))
-//         }
-//
-//         NAPI_CALL(env, napi_typeof(env, js_length, &type))
-//         if (type == napi_number) {
-//             NAPI_CALL(env, napi_get_value_int64(env, js_length, &length))
-//         }
-//         if (optionsIndex == 1) {
-//             NAPI_CALL(env, napi_typeof(env, js_auto_close, &type))
-//             if (type == napi_boolean) {
-//                 NAPI_CALL(env, napi_get_value_bool(env, js_auto_close, &autoClose));
-//             }
-//         }
-//     }
-//
-//     try {
-//         static_cast<MemfdStream *>(stream)->sendFile(fd, offset, length);
-//         NAPI_CALL(env, napi_get_boolean(env, true, &result))
-//     } catch (const std::exception &e) {
-//         OH_LOG_ERROR(LOG_APP, "%s", e.what());
-//         NAPI_CALL(env, napi_get_boolean(env, false, &result))
-//     }
-//
-//     if (autoClose) {
-//         ::close(fd);
-//     }
-//
-//     return result;
-
-    int fd = -1;
-    bool autoClose = false;
-    long offset = 0;
-    long length = 0;
-    MemfdStream *stream = nullptr;
-
-    initSendFile(env, info, fd, offset, length, autoClose, &stream);
-
-    bool val = stream->sendFile(fd, offset, length);
-
-    if (autoClose) {
-        ::close(fd);
-    }
-
-    napi_value result = nullptr;
-
-    NAPI_CALL(env, napi_get_boolean(env, val, &result))
-    return result;
-}
-
-void MemfdStream::initSendFile(napi_env env, napi_callback_info info, int &fd, long &offset, long &length,
-                               bool &autoClose, MemfdStream **fdStream) {
-    GET_JS_INFO(3)
-    napi_valuetype type;
-    fd = -1;
-    napi_value result;
-    autoClose = false;
-    offset = 0;
-    length = stream->getLength();
-    int optionsIndex = 0;
-
-    *fdStream = static_cast<MemfdStream *>(stream.get());
-
-
-    NAPI_CALL(env, napi_typeof(env, argv[0], &type))
-    if (type == napi_number) {
-        NAPI_CALL(env, napi_get_value_int32(env, argv[0], &fd))
-        optionsIndex = 1;
-    } else if (type == napi_string) {
-        NAPI_CALL(env, napi_typeof(env, argv[1], &type))
-        if (type != napi_number) {
-            napi_throw_type_error(env, "MemfdStream", "mode must be number");
-        }
-        autoClose = true;
-        int openMode = 0;
-        NAPI_CALL(env, napi_get_value_int32(env, argv[1], &openMode))
-
-        size_t bufsize = 0;
-        NAPI_CALL(env, napi_get_value_string_utf8(env, argv[0], nullptr, 0, &bufsize))
-        std::unique_ptr<char[]> buffer(new char[bufsize + 1]{'\0'});
-        NAPI_CALL(env, napi_get_value_string_utf8(env, argv[0], buffer.get(), bufsize + 1, &bufsize))
-        fd = open(buffer.get(), openMode, 0644);
-
-        optionsIndex = 2;
-    } else {
-        napi_throw_type_error(env, ClassName.c_str(), "invalid parameter type");
-    }
-
-    NAPI_CALL(env, napi_typeof(env, argv[optionsIndex], &type))
-    if (type == napi_object) {
-        napi_value js_offset;
-        napi_value js_length;
-        napi_value js_auto_close;
-        NAPI_CALL(env, napi_get_named_property(env, argv[1], "offset", &js_offset))
-        NAPI_CALL(env, napi_get_named_property(env, argv[1], "length", &js_length))
-        NAPI_CALL(env, napi_get_named_property(env, argv[1], "autoClose", &js_auto_close))
-        NAPI_CALL(env, napi_typeof(env, js_offset, &type))
-        if (type == napi_number) {
-            NAPI_CALL(env, napi_get_value_int64(env, js_offset, &offset))
-        }
-
-        NAPI_CALL(env, napi_typeof(env, js_length, &type))
-        if (type == napi_number) {
-            NAPI_CALL(env, napi_get_value_int64(env, js_length, &length))
-        }
-        if (optionsIndex == 1) {
-            NAPI_CALL(env, napi_typeof(env, js_auto_close, &type))
-            if (type == napi_boolean) {
-                NAPI_CALL(env, napi_get_value_bool(env, js_auto_close, &autoClose));
-            }
-        }
-    }
-}
-
-napi_value MemfdStream::JSSendFileAsync(napi_env env, napi_callback_info info) {
-    int fd = -1;
-    bool autoClose = false;
-    long offset = 0;
-    long length = 0;
-    MemfdStream *stream = nullptr;
-
-    initSendFile(env, info, fd, offset, length, autoClose, &stream);
-
-    SendFileData *data = new SendFileData{
-        .stream = stream, .fd = fd, .offset = offset, .length = length, .result = false, .autoClose = autoClose};
-    napi_value resourceName = nullptr;
-    NAPI_CALL(env, napi_create_string_utf8(env, "sendFileAsync", NAPI_AUTO_LENGTH, &resourceName))
-    napi_value result = nullptr;
-    NAPI_CALL(env, napi_create_promise(env, &data->deferred, &result))
-    napi_create_async_work(
-        env, nullptr, resourceName,
-        [](napi_env env, void *data) {
-            SendFileData *asyncData = static_cast<SendFileData *>(data);
-            asyncData->result = asyncData->stream->sendFile(asyncData->fd, asyncData->offset, asyncData->length);
-        },
-        [](napi_env env, napi_status status, void *data) {
-            SendFileData *asyncData = static_cast<SendFileData *>(data);
-            napi_value result = nullptr;
-            if (asyncData->autoClose) {
-                ::close(asyncData->fd);
-            }
-            NAPI_CALL(env, napi_get_boolean(env, asyncData->result, &result))
-            if (status == napi_ok) {
-                NAPI_CALL(env, napi_resolve_deferred(env, asyncData->deferred, result))
-            } else {
-                NAPI_CALL(env, napi_reject_deferred(env, asyncData->deferred, nullptr))
-            }
-            NAPI_CALL(env, napi_delete_async_work(env, asyncData->work))
-        },
-        data, &data->work);
-
-    NAPI_CALL(env, napi_queue_async_work(env, data->work))
-    return result;
-}
-
-
-void MemfdStream::Export(napi_env env, napi_value exports) {
-    napi_property_descriptor desc[] = {
-//        DEFINE_NAPI_ISTREAM_PROPERTY((void *)ClassName.c_str()),
-        DEFINE_NAPI_FUNCTION("fd", nullptr, JSGetFd, nullptr, nullptr),
-        DEFINE_NAPI_FUNCTION("toArrayBuffer", JSToArrayBuffer, nullptr, nullptr, nullptr),
-        DEFINE_NAPI_FUNCTION("sendFile", JSSendFile, nullptr, nullptr, nullptr),
-        DEFINE_NAPI_FUNCTION("sendFileAsync", JSSendFileAsync, nullptr, nullptr, nullptr),
-    };
-    napi_value napi_cons = nullptr;
-    napi_define_class(env, ClassName.c_str(), NAPI_AUTO_LENGTH, JSConstructor, nullptr, sizeof(desc) / sizeof(desc[0]),
-                      desc, &napi_cons);
-    napi_create_reference(env, napi_cons, 1, &cons);
-    Extends(env, napi_cons);
-    napi_set_named_property(env, exports, ClassName.c_str(), napi_cons);
-}
-
 int MemfdStream::getFd() const { return m_fd; }
+
+void MemfdStream::nativeFdWritten() { reserve(m_length); }
@@ -6,8 +6,11 @@
 
 #include "stream/MemoryStream.h"
 #include "common.h"
+#include <algorithm>
+#include <cstring>
+
+using jemoc_stream::PageAllocator;
 
-std::string MemoryStream::ClassName = "MemoryStream";
 
 MemoryStream::MemoryStream() {
 //     m_cache = new std::vector<byte>();
@@ -32,42 +35,195 @@ MemoryStream::MemoryStream(size_t capacity) {
 }
 
 
-MemoryStream::~MemoryStream() { close(); }
+MemoryStream::MemoryStream(size_t capacity, long chunkSize) : m_chunkSize(std::max(chunkSize, 0L)) {
+    setCapacity(capacity);
+    m_canWrite = true;
+    m_canSeek = true;
+    m_canRead = true;
+    m_canGetPosition = true;
+    m_canGetLength = true;
+    m_canSetLength = true;
+}
+
+MemoryStream::MemoryStream(byte *data, long length, bool writable, std::function<void()> release)
+    : m_capacity(length), mm_cache(data), m_view(true), m_release(std::move(release)) {
+    m_length = length;
+    m_canWrite = writable;
+    m_canSeek = true;
+    m_canRead = true;
+    m_canGetPosition = true;
+    m_canGetLength = true;
+    m_canSetLength = writable;
+}
+
+MemoryStream::~MemoryStream() {
+    close();
+    if (m_release)
+        m_release();
+}
 
 void MemoryStream::setLength(long length) {
+    if (m_view && !m_canWrite)
+        throw std::ios_base::failure("stream not writeable");
     ensureCapacity(length);
+    // 扩展出来的部分补0，不暴露之前截断的旧数据
+    if (length > m_length)
+        zeroFill(m_length, length);
     m_length = length;
     m_position = std::min(m_position, length);
 }
 
+void MemoryStream::copyOut(long position, byte *dest, size_t count) const {
+    if (m_chunkSize == 0) {
+        memcpy(dest, mm_cache + position, count);
+        return;
+    }
+    while (count > 0) {
+        long index = position / m_chunkSize;
+        long chunkOffset = position % m_chunkSize;
+        size_t copyBytes = std::min(count, static_cast<size_t>(m_chunkSize - chunkOffset));
+        memcpy(dest, m_chunks[index] + chunkOffset, copyBytes);
+        dest += copyBytes;
+        position += copyBytes;
+        count -= copyBytes;
+    }
+}
+
+void MemoryStream::copyIn(long position, const byte *source, size_t count) {
+    if (m_chunkSize == 0) {
+        memcpy(mm_cache + position, source, count);
+        return;
+    }
+    while (count > 0) {
+        long index = position / m_chunkSize;
+        long chunkOffset = position % m_chunkSize;
+        size_t copyBytes = std::min(count, static_cast<size_t>(m_chunkSize - chunkOffset));
+        memcpy(m_chunks[index] + chunkOffset, source, copyBytes);
+        source += copyBytes;
+        position += copyBytes;
+        count -= copyBytes;
+    }
+}
+
+void MemoryStream::zeroFill(long from, long to) {
+    if (m_chunkSize == 0) {
+        memset(mm_cache + from, 0, to - from);
+        return;
+    }
+    while (from < to) {
+        long index = from / m_chunkSize;
+        long chunkOffset = from % m_chunkSize;
+        long fillBytes = std::min(to - from, m_chunkSize - chunkOffset);
+        memset(m_chunks[index] + chunkOffset, 0, fillBytes);
+        from += fillBytes;
+    }
+}
+
 long MemoryStream::read(void *buffer, long offset, size_t count) {
     if (count == 0)
         return 0;
     size_t readBytes = m_length - m_position;
     readBytes = std::min(readBytes, count);
 //     memcpy(offset_pointer(buffer, offset), m_cache->data() + m_position, readBytes);
-    memcpy(offset_pointer(buffer, offset), mm_cache + m_position, readBytes);
+    copyOut(m_position, static_cast<byte *>(offset_pointer(buffer, offset)), readBytes);
 
     m_position += readBytes;
     return readBytes;
 }
 
 long MemoryStream::write(void *buffer, long offset, size_t count) {
+    if (!m_canWrite)
+        throw std::ios_base::failure("stream not writeable");
     if (count == 0)
         return 0;
     ensureCapacity(m_position + count);
 //     void *dest = m_cache->data() + m_position;
-    void *dest = mm_cache + m_position;
-
     void *source = offset_pointer(buffer, offset);
-    memcpy(dest, source, count);
+    copyIn(m_position, static_cast<byte *>(source), count);
     m_position += count;
     m_length = std::max(m_position, m_length);
     return count;
 }
 
+long MemoryStream::readv(const struct iovec *iov, int iovcnt) {
+    long total = 0;
+    for (int i = 0; i < iovcnt && m_position < m_length; i++) {
+        size_t readBytes = std::min(iov[i].iov_len, static_cast<size_t>(m_length - m_position));
+        copyOut(m_position, static_cast<byte *>(iov[i].iov_base), readBytes);
+        m_position += readBytes;
+        total += readBytes;
+    }
+    return total;
+}
+
+long MemoryStream::writev(const struct iovec *iov, int iovcnt) {
+    if (!m_canWrite)
+        throw std::ios_base::failure("stream not writeable");
+    size_t count = 0;
+    for (int i = 0; i < iovcnt; i++) {
+        count += iov[i].iov_len;
+    }
+    if (count == 0)
+        return 0;
+    // 一次性扩容，避免逐段写入时多次realloc
+    ensureCapacity(m_position + count);
+    for (int i = 0; i < iovcnt; i++) {
+        copyIn(m_position, static_cast<byte *>(iov[i].iov_base), iov[i].iov_len);
+        m_position += iov[i].iov_len;
+    }
+    m_length = std::max(m_position, m_length);
+    return count;
+}
+
+long MemoryStream::readAt(long position, void *buffer, long offset, size_t count) {
+    if (position < 0)
+        throw std::ios_base::failure("position must be non-negative");
+    if (count == 0 || position >= m_length)
+        return 0;
+    size_t readBytes = std::min(count, static_cast<size_t>(m_length - position));
+    copyOut(position, static_cast<byte *>(offset_pointer(buffer, offset)), readBytes);
+    return readBytes;
+}
+
+const byte *MemoryStream::getSpan(long position, long length) {
+    if (m_closed)
+        return nullptr;
+    if (position < 0 || length < 0 || position + length > m_length)
+        throw std::ios_base::failure("span is out of range");
+    if (!isChunked())
+        return mm_cache + position;
+    long index = position / m_chunkSize;
+    long chunkOffset = position % m_chunkSize;
+    if (chunkOffset + length > m_chunkSize || index >= static_cast<long>(m_chunks.size()))
+        return nullptr;
+    return m_chunks[index] + chunkOffset;
+}
+
+long MemoryStream::writeAt(long position, void *buffer, long offset, size_t count) {
+    if (position < 0)
+        throw std::ios_base::failure("position must be non-negative");
+    if (!m_canWrite)
+        throw std::ios_base::failure("stream not writeable");
+    if (count == 0)
+        return 0;
+    ensureCapacity(position + count);
+    // 越过流末尾写入时，中间空洞补0
+    if (position > m_length)
+        zeroFill(m_length, position);
+    copyIn(position, static_cast<byte *>(offset_pointer(buffer, offset)), count);
+    m_length = std::max(m_length, static_cast<long>(position + count));
+    return count;
+}
+
 void MemoryStream::ensureCapacity(long capacity) {
     if (capacity > m_length && capacity > m_capacity) {
+        if (m_view)
+            throw std::ios_base::failure("capacity of memory stream view is fixed");
+        // 分段存储按需追加块，不需要成倍预留
+        if (m_chunkSize > 0) {
+            setCapacity(capacity);
+            return;
+        }
         long newCapacity = std::max(capacity, 256L);
         if (newCapacity < m_capacity * 2) {
             newCapacity = m_capacity * 2;
@@ -79,20 +235,59 @@ void MemoryStream::ensureCapacity(long capacity) {
 void MemoryStream::setCapacity(long capacity) {
 //     m_capacity = capacity;
 //     m_cache->resize(m_capacity);
-    m_capacity = align4k(capacity);
-    byte *buffer = new byte[m_capacity];
-
-    if (mm_cache == nullptr) {
-        mm_cache = buffer;
+    if (m_view) {
+        if (capacity > m_capacity || capacity < m_length)
+            throw std::ios_base::failure("capacity of memory stream view is fixed");
         return;
     }
+    if (m_chunkSize > 0) {
+        // 只增删末尾的块，已有块中的数据保持原地
+        size_t chunkCount = (std::max(capacity, m_length) + m_chunkSize - 1) / m_chunkSize;
+        while (m_chunks.size() < chunkCount)
+            m_chunks.push_back(PageAllocator::allocate(m_chunkSize));
+        while (m_chunks.size() > chunkCount) {
+            PageAllocator::deallocate(m_chunks.back(), m_chunkSize);
+            m_chunks.pop_back();
+        }
+        m_capacity = chunkCount * m_chunkSize;
+        return;
+    }
+    // 大容量走mmap，扩容时mremap不拷贝数据。容量不小于当前长度，缩容不会截断数据
+    long newCapacity = PageAllocator::alignCapacity(std::max({capacity, m_length, 1L}));
+    if (newCapacity == m_capacity && mm_cache != nullptr)
+        return;
+    mm_cache = PageAllocator::reallocate(mm_cache, m_capacity, newCapacity, m_length);
+    m_capacity = newCapacity;
+}
 
-    byte *temp = mm_cache;
-    memcpy(buffer, temp, std::min(m_length, capacity));
-    mm_cache = buffer;
-    delete[] temp;
-    temp = nullptr;
+byte *MemoryStream::detach(long *length, long *capacity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (m_closed)
+        throw std::ios_base::failure("stream is closed");
+    if (m_view)
+        throw std::ios_base::failure("memory stream view does not own its buffer");
+    byte *buffer = nullptr;
+    if (m_chunkSize == 0) {
+        buffer = mm_cache;
+        mm_cache = nullptr;
+        *capacity = m_capacity;
+    } else if (m_chunks.size() == 1) {
+        buffer = m_chunks[0];
+        m_chunks.clear();
+        *capacity = m_chunkSize;
+    } else {
+        *capacity = PageAllocator::alignCapacity(m_length);
+        buffer = PageAllocator::allocate(*capacity);
+        copyOut(0, buffer, m_length);
+    }
+    *length = m_length;
+    m_length = 0;
+    m_position = 0;
+    m_capacity = 0;
+    close();
+    return buffer;
 }
+
 long MemoryStream::getCapacity() const { return m_capacity; }
 
 void MemoryStream::close() {
@@ -108,92 +303,13 @@ void MemoryStream::close() {
 //     delete m_cache;
 //     m_cache = nullptr;
     if (mm_cache != nullptr) {
-        delete[] mm_cache;
+        if (!m_view)
+            PageAllocator::deallocate(mm_cache, m_capacity);
         mm_cache = nullptr;
     }
-}
-
-
-napi_ref MemoryStream::cons = nullptr;
-
-/**
- * MemoryStream构造函数，入参可能是个number或者是个arraybuffer
- * @param env
- * @param info
- * @return
- */
-napi_value MemoryStream::JSConstructor(napi_env env, napi_callback_info info) {
-    GET_JS_INFO_WITHOUT_STREAM(1);
-    napi_valuetype type;
-    NAPI_CALL(env, napi_typeof(env, argv[0], &type))
-//    MemoryStream *stream = new MemoryStream();
-    std::shared_ptr<IStream> stream = std::make_shared<MemoryStream>();
-    if (type != napi_undefined) {
-        if (type == napi_number) {
-            long capacity = getLong(env, argv[0]);
-            ((MemoryStream *)stream.get())->setCapacity(capacity);
-            stream = std::make_shared<MemoryStream>(capacity);
-        } else {
-            void *data = nullptr;
-            size_t length = 0;
-            getBuffer(env, argv[0], &data, &length);
-            if (data != nullptr) {
-                stream->write(data, 0, length);
-            }
-        }
-    }
-//    napi_wrap(env, _this, MakePtr(stream), JSDisposed, nullptr, nullptr);
-//    return _this;
-    return JSBind(env, _this, stream);
-}
-
-//void MemoryStream::JSDisposed(napi_env env, void *data, void *hint) {
-//    MemoryStream *stream = static_cast<MemoryStream *>(data);
-//    stream->close();
-//    delete stream;
-//}
-
-napi_value MemoryStream::JSToArrayBuffer(napi_env env, napi_callback_info info) {
-    GET_JS_INFO(1)
-    void *data = nullptr;
-    napi_value buffer = nullptr;
-    long length = stream->getLength();
-    long offset = 0;
-    if (argc > 0) {
-        getToArrayBufferOptions(env, argv[0], &offset, &length);
-    }
-    NAPI_CALL(env, napi_create_arraybuffer(env, length, &data, &buffer));
-
-    memcpy(data, ((MemoryStream *)stream.get())->getData() + offset, length);
-    return buffer;
-}
-
-napi_value MemoryStream::JSGetCapacity(napi_env env, napi_callback_info info) {
-    GET_JS_INFO(0)
-    RETURN_NAPI_VALUE(napi_create_int64, static_cast<MemoryStream *>(stream.get())->getCapacity());
-}
-napi_value MemoryStream::JSSetCapacity(napi_env env, napi_callback_info info) {
-    GET_JS_INFO(1)
-    long capacity = getLong(env, argv[0]);
-    if (capacity < 0 || capacity < stream->getPosition()) {
-        napi_throw_range_error(env, "MemoryStream::setCapacity", "capacity is out of range");
-    }
-    static_cast<MemoryStream *>(stream.get())->setCapacity(capacity);
-    return nullptr;
-}
-
-
-void MemoryStream::Export(napi_env env, napi_value exports) {
-    napi_property_descriptor desc[] = {
-//        DEFINE_NAPI_ISTREAM_PROPERTY((void *)ClassName.c_str()),
-        DEFINE_NAPI_FUNCTION("capacity", nullptr, JSGetCapacity, JSSetCapacity, nullptr),
-        DEFINE_NAPI_FUNCTION("toArrayBuffer", JSToArrayBuffer, nullptr, nullptr, nullptr),
-    };
-    napi_value napi_cons = nullptr;
-    napi_define_class(env, ClassName.c_str(), NAPI_AUTO_LENGTH, JSConstructor, nullptr, sizeof(desc) / sizeof(desc[0]),
-                      desc, &napi_cons);
-//    napi_create_reference(env, napi_cons, 1, &cons);
-    Extends(env, napi_cons);
-
-    napi_set_named_property(env, exports, ClassName.c_str(), napi_cons);
+    m_capacity = 0;
+    for (byte *chunk : m_chunks)
+        PageAllocator::deallocate(chunk, m_chunkSize);
+    m_chunks.clear();
+    m_chunks.shrink_to_fit();
 }
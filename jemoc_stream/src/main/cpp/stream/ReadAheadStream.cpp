@@ -0,0 +1,253 @@
+//
+// Created on 2025/3/7.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#include "stream/ReadAheadStream.h"
+#include <cstring>
+
+ReadAheadStream::ReadAheadStream(std::shared_ptr<IStream> stream, size_t blockSize, int depth, int maxDepth,
+                                 bool leaveOpen)
+    : m_stream(stream), m_blockSize(std::max<size_t>(blockSize, 512)), m_minDepth(std::max(depth, 1)),
+      m_maxDepth(std::max(maxDepth, std::max(depth, 1))), m_depth(std::max(depth, 1)), m_leaveOpen(leaveOpen) {
+    m_canRead = true;
+    m_canSeek = stream->getCanSeek();
+    m_canGetLength = m_canSeek;
+    // 长度和位置在构造时取一次，之后底层流只在预读线程上访问
+    if (m_canSeek) {
+        m_length = stream->getLength();
+        m_position = stream->getPosition();
+    }
+}
+
+ReadAheadStream::~ReadAheadStream() { close(); }
+
+void ReadAheadStream::start() {
+    m_worker = std::thread(&ReadAheadStream::run, this);
+}
+
+void ReadAheadStream::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_spaceCondition.notify_all();
+    if (m_worker.joinable())
+        m_worker.join();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopping = false;
+}
+
+void ReadAheadStream::run() {
+    while (true) {
+        std::unique_ptr<Block> block;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (!m_stopping && static_cast<int>(m_ready.size()) >= m_depth.load()) {
+                // 队列已满说明读取方更慢，持续如此时减小深度，少占内存
+                if (++m_fullCount >= ShrinkThreshold && m_depth.load() > m_minDepth) {
+                    m_depth--;
+                    m_fullCount = 0;
+                }
+                m_spaceCondition.wait(
+                    lock, [this]() { return m_stopping || static_cast<int>(m_ready.size()) < m_depth.load(); });
+            }
+            if (m_stopping)
+                return;
+            if (!m_free.empty()) {
+                block = std::move(m_free.back());
+                m_free.pop_back();
+            }
+        }
+        if (block == nullptr) {
+            block = std::make_unique<Block>();
+            block->data.reset(new byte[m_blockSize]);
+        }
+
+        long readBytes = 0;
+        try {
+            readBytes = m_stream->read(block->data.get(), 0, m_blockSize);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_error = std::current_exception();
+            m_eof = true;
+            m_readyCondition.notify_all();
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (readBytes <= 0) {
+            m_eof = true;
+            m_free.push_back(std::move(block));
+            m_readyCondition.notify_all();
+            return;
+        }
+        block->length = readBytes;
+        block->offset = 0;
+        m_ready.push_back(std::move(block));
+        m_readyCondition.notify_one();
+    }
+}
+
+std::unique_ptr<ReadAheadStream::Block> ReadAheadStream::nextBlock(bool wait) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    // 第一次读取或seek之后才启动预读线程，到达末尾退出后不再重启
+    if (!m_worker.joinable() && !m_eof)
+        start();
+    if (m_ready.empty() && !m_eof) {
+        if (!wait)
+            return nullptr;
+        // 读取方需要等待说明预读深度不够
+        m_fullCount = 0;
+        int depth = m_depth.load();
+        if (depth < m_maxDepth) {
+            m_depth = std::min(depth * 2, m_maxDepth);
+            m_spaceCondition.notify_one();
+        }
+        m_readyCondition.wait(lock, [this]() { return !m_ready.empty() || m_eof; });
+    }
+    if (m_ready.empty()) {
+        if (m_error) {
+            std::exception_ptr error = m_error;
+            m_error = nullptr;
+            std::rethrow_exception(error);
+        }
+        return nullptr;
+    }
+    std::unique_ptr<Block> block = std::move(m_ready.front());
+    m_ready.pop_front();
+    m_spaceCondition.notify_one();
+    return block;
+}
+
+std::unique_ptr<ReadAheadStream::Block> ReadAheadStream::takeBlock() {
+    if (m_closed)
+        throw std::ios_base::failure("stream is closed");
+    std::unique_ptr<Block> block;
+    if (m_current != nullptr && m_current->offset < m_current->length)
+        block = std::move(m_current);
+    else {
+        if (m_current != nullptr)
+            recycle(std::move(m_current));
+        block = nextBlock(true);
+    }
+    if (block != nullptr)
+        m_position += block->length - block->offset;
+    return block;
+}
+
+void ReadAheadStream::recycle(std::unique_ptr<Block> block) {
+    if (block == nullptr)
+        return;
+    block->length = 0;
+    block->offset = 0;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_free.push_back(std::move(block));
+}
+
+long ReadAheadStream::read(void *buffer, long offset, size_t count) {
+    if (m_closed)
+        throw std::ios_base::failure("stream is closed");
+    byte *dest = static_cast<byte *>(buffer) + offset;
+    long total = 0;
+    while (count > 0) {
+        if (m_current == nullptr || m_current->offset >= m_current->length) {
+            if (m_current != nullptr)
+                recycle(std::move(m_current));
+            // 已经读到数据时不等待下一块，直接返回
+            m_current = nextBlock(total == 0);
+            if (m_current == nullptr)
+                break;
+        }
+        size_t copyBytes = std::min(count, static_cast<size_t>(m_current->length - m_current->offset));
+        memcpy(dest + total, m_current->data.get() + m_current->offset, copyBytes);
+        m_current->offset += copyBytes;
+        total += copyBytes;
+        count -= copyBytes;
+    }
+    m_position += total;
+    return total;
+}
+
+long ReadAheadStream::seek(long offset, SeekOrigin origin) {
+    if (m_closed)
+        throw std::ios_base::failure("stream is closed");
+    if (!m_canSeek)
+        throw std::ios_base::failure("seek not supported");
+    long position = 0;
+    switch (origin) {
+    case Begin:
+        position = offset;
+        break;
+    case Current:
+        position = m_position + offset;
+        break;
+    case End:
+        position = m_length + offset;
+        break;
+    default:
+        throw std::ios_base::failure("origin is out of range");
+    }
+    if (position < 0 || position > m_length)
+        throw std::ios_base::failure("seek error");
+
+    // 目标仍在当前块内时只移动块内位置，不打断预读
+    if (m_current != nullptr) {
+        long blockStart = m_position - m_current->offset;
+        if (position >= blockStart && position < blockStart + m_current->length) {
+            m_current->offset = position - blockStart;
+            m_position = position;
+            return m_position;
+        }
+    }
+
+    stop();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        while (!m_ready.empty()) {
+            m_free.push_back(std::move(m_ready.front()));
+            m_ready.pop_front();
+        }
+        if (m_current != nullptr)
+            m_free.push_back(std::move(m_current));
+        m_eof = false;
+        m_error = nullptr;
+        m_fullCount = 0;
+    }
+    m_stream->seek(position, SeekOrigin::Begin);
+    m_position = position;
+    return m_position;
+}
+
+void ReadAheadStream::copyTo(IStream *stream, long bufferSize) {
+    // 直接写出预读块，不经过中间缓冲区；每次写入不超过bufferSize，bufferSize<=0时整块写出
+    std::unique_ptr<Block> block;
+    while ((block = takeBlock()) != nullptr) {
+        while (block->offset < block->length) {
+            long count = block->length - block->offset;
+            if (bufferSize > 0)
+                count = std::min(count, bufferSize);
+            stream->tracked(StreamStats::Write,
+                            [&]() { return stream->write(block->data.get(), block->offset, count); });
+            block->offset += count;
+        }
+        recycle(std::move(block));
+    }
+}
+
+void ReadAheadStream::close() {
+    if (m_closed)
+        return;
+    stop();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_ready.clear();
+        m_free.clear();
+        m_current = nullptr;
+        m_eof = true;
+    }
+    if (!m_leaveOpen)
+        m_stream->close();
+    IStream::close();
+}
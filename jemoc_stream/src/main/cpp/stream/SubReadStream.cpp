@@ -10,13 +10,23 @@ SubReadStream::SubReadStream(std::shared_ptr<IStream> stream, long startPosition
     : m_stream(stream), m_startInStream(startPosition), m_endInStream(startPosition + maxLength),
       m_leaveOpen(leaveOpen) {
     m_position = 0;
+    m_length = maxLength;
     m_canRead = true;
     m_canWrite = false;
-    m_canSeek = false;
+    m_canSeek = stream->getCanSeek();
+    m_canGetLength = true;
+    m_canGetPosition = true;
 }
 
 SubReadStream::~SubReadStream() { close(); }
 
+std::shared_ptr<IStream> SubReadStream::lockStream() const {
+    auto stream = m_stream.lock();
+    if (stream == nullptr || m_closed)
+        throw std::ios::failure("stream is closed");
+    return stream;
+}
+
 bool SubReadStream::getCanRead() const {
     if (auto stream = m_stream.lock()) {
         return stream->getCanRead() && m_canRead;
@@ -25,19 +35,64 @@ bool SubReadStream::getCanRead() const {
     }
 }
 
-long SubReadStream::read(void *buffer, long offset, size_t count) {
-
+bool SubReadStream::getCanSeek() const {
     if (auto stream = m_stream.lock()) {
-        if ((m_position + m_startInStream) != stream->getPosition()) {
-            stream->seek(m_position + m_startInStream, SeekOrigin::Begin);
-        }
-        size_t _count = std::min((size_t)(m_endInStream - m_startInStream - m_position), count);
-        long result = stream->read(buffer, offset, _count);
-        m_position += result;
-        return result;
+        return stream->getCanSeek() && m_canSeek;
     } else {
-        throw std::ios::failure("stream is closed");
+        return false;
+    }
+}
+
+long SubReadStream::read(void *buffer, long offset, size_t count) {
+    auto stream = lockStream();
+    long result = 0;
+    if (m_canSeek) {
+        result = readAt(m_position, buffer, offset, count);
+    } else {
+        // 父流不可seek时只能紧接着父流当前位置读取
+        if ((m_position + m_startInStream) != stream->getPosition())
+            throw std::ios::failure("stream does not support seeking");
+        size_t _count = std::min(static_cast<size_t>(std::max(m_length - m_position, 0L)), count);
+        result = stream->read(buffer, offset, _count);
+    }
+    m_position += result;
+    return result;
+}
+
+long SubReadStream::readAt(long position, void *buffer, long offset, size_t count) {
+    auto stream = lockStream();
+    if (!m_canSeek)
+        throw std::ios_base::failure("positional read not supported");
+    if (position < 0)
+        throw std::ios_base::failure("position must be non-negative");
+    if (position >= m_length || count == 0)
+        return 0;
+    size_t _count = std::min(static_cast<size_t>(m_length - position), count);
+    // 读满为止，父流的readAt可能返回短读
+    long readBytes = 0;
+    while (static_cast<size_t>(readBytes) < _count) {
+        long result = stream->readAt(m_startInStream + position + readBytes, buffer, offset + readBytes,
+                                     _count - readBytes);
+        if (result <= 0)
+            break;
+        readBytes += result;
     }
+    return readBytes;
+}
+
+long SubReadStream::seek(long offset, SeekOrigin origin) {
+    if (!m_canSeek)
+        throw std::ios_base::failure("stream does not support seeking");
+    return IStream::seek(offset, origin);
+}
+
+const byte *SubReadStream::getSpan(long position, long length) {
+    if (position < 0 || length < 0 || position + length > m_length)
+        throw std::ios_base::failure("span is out of range");
+    auto stream = m_stream.lock();
+    if (stream == nullptr || m_closed)
+        return nullptr;
+    return stream->getSpan(m_startInStream + position, length);
 }
 
 void SubReadStream::close() {
@@ -49,4 +104,4 @@ void SubReadStream::close() {
         stream->close();
         m_stream.reset();
     }
-}
\ No newline at end of file
+}
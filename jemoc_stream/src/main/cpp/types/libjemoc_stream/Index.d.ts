@@ -9,12 +9,71 @@ export interface ToArrayBufferOptions {
   length?: number;
 }
 
+export interface CopyToOptions {
+  bufferSize?: number;
+  maxBufferSize?: number;
+  bufferPool?: BufferPool;
+  pipeline?: boolean;
+  depth?: number;
+}
+
+export interface CopyToStats {
+  bytes: number;
+  elapsedTime: number;
+  readStallTime: number;
+  writeStallTime: number;
+}
+
+export interface StreamOpStats {
+  count: number;
+  bytes: number;
+  totalTime: number;
+  maxTime: number;
+  minorFaults: number;
+  majorFaults: number;
+}
+
+export interface StreamAsyncStats {
+  count: number;
+  queuedTime: number;
+  maxQueuedTime: number;
+  executeTime: number;
+  maxExecuteTime: number;
+}
+
+export interface StreamStats {
+  read: StreamOpStats;
+  write: StreamOpStats;
+  flush: StreamOpStats;
+  seek: StreamOpStats;
+  async: StreamAsyncStats;
+}
+
 export interface DeflateStreamOption {
   leaveOpen?: boolean;
   windowBits?: number;
   uncompressSize?: number;
   bufferSize?: number;
   compressionLevel?: number;
+  threads?: number;
+  blockSize?: number;
+  index?: DeflateIndex;
+}
+
+export class DeflateIndex {
+  constructor(span?: number)
+
+  get span(): number;
+
+  get count(): number;
+
+  get complete(): boolean;
+
+  get length(): number;
+
+  writeTo(stream: IStream): void;
+
+  static readFrom(stream: IStream): DeflateIndex;
 }
 
 export interface BufferPoolStats {
@@ -57,8 +116,12 @@ export abstract class StreamBase {
 
   copyTo(stream: IStream, bufferSize?: number): void
 
+  copyTo(stream: IStream, options: CopyToOptions): void
+
   copyToAsync(stream: IStream, bufferSize?: number): Promise<void>
 
+  copyToAsync(stream: IStream, options: CopyToOptions): Promise<CopyToStats | void>
+
   seek(offset: number, origin: number): void
 
   read(buffer: BufferLike, offset?: number, count?: number): number
@@ -67,6 +130,14 @@ export abstract class StreamBase {
 
   write(buffer: BufferLike, offset?: number, count?: number): number
 
+  readv(buffers: BufferLike[]): number
+
+  writev(buffers: BufferLike[]): number
+
+  readAt(position: number, buffer: BufferLike, offset?: number, count?: number): number
+
+  writeAt(position: number, buffer: BufferLike, offset?: number, count?: number): number
+
   writeAsync(buffer: BufferLike, offset?: number, count?: number): Promise<number>
 
   flush(): void
@@ -76,6 +147,18 @@ export abstract class StreamBase {
   close(): void
 
   closeAsync(): Promise<void>
+
+  get stats(): StreamStats | undefined
+
+  get statsEnabled(): boolean
+
+  set statsEnabled(value: boolean)
+
+  resetStats(): void
+
+  slice(start: number, length?: number): IStream
+
+  static setGlobalStatsEnabled(enabled: boolean): void
 }
 
 export interface IStream {
@@ -94,8 +177,12 @@ export interface IStream {
 
   copyTo(stream: IStream, bufferSize?: number): void
 
+  copyTo(stream: IStream, options: CopyToOptions): void
+
   copyToAsync(stream: IStream, bufferSize?: number): Promise<void>
 
+  copyToAsync(stream: IStream, options: CopyToOptions): Promise<CopyToStats | void>
+
   seek(offset: number, origin: number): void
 
   read(buffer: BufferLike, offset?: number, count?: number): number
@@ -104,6 +191,14 @@ export interface IStream {
 
   write(buffer: BufferLike, offset?: number, count?: number): number
 
+  readv(buffers: BufferLike[]): number
+
+  writev(buffers: BufferLike[]): number
+
+  readAt(position: number, buffer: BufferLike, offset?: number, count?: number): number
+
+  writeAt(position: number, buffer: BufferLike, offset?: number, count?: number): number
+
   writeAsync(buffer: BufferLike, offset?: number, count?: number): Promise<number>
 
   flush(): void
@@ -113,17 +208,46 @@ export interface IStream {
   close(): void
 
   closeAsync(): Promise<void>
+
+  get stats(): StreamStats | undefined
+
+  get statsEnabled(): boolean
+
+  set statsEnabled(value: boolean)
+
+  resetStats(): void
+
+  slice(start: number, length?: number): IStream
+}
+
+export interface MemoryStreamOptions {
+  chunked?: boolean;
+  chunkSize?: number;
+  capacity?: number;
+}
+
+export interface MemoryStreamViewOptions {
+  view?: boolean;
+  writable?: boolean;
 }
 
 export class MemoryStream implements IStream {
   constructor(capacity: number)
 
-  constructor(buffer: BufferLike)
+  constructor(buffer: BufferLike, options?: MemoryStreamViewOptions)
+
+  constructor(options: MemoryStreamOptions)
 
   constructor()
 
+  get chunked(): boolean;
+
+  get chunkSize(): number;
+
   copyToAsync(stream: IStream, bufferSize?: number | undefined): Promise<void>;
 
+  copyToAsync(stream: IStream, options: CopyToOptions): Promise<CopyToStats | void>;
+
   readAsync(buffer: BufferLike, offset?: number | undefined, count?: number | undefined): Promise<number>;
 
   writeAsync(buffer: BufferLike, offset?: number | undefined, count?: number | undefined): Promise<number>;
@@ -132,6 +256,16 @@ export class MemoryStream implements IStream {
 
   closeAsync(): Promise<void>;
 
+  get stats(): StreamStats | undefined;
+
+  get statsEnabled(): boolean;
+
+  set statsEnabled(value: boolean);
+
+  resetStats(): void;
+
+  slice(start: number, length?: number): IStream;
+
   get canSeek(): boolean;
 
   get canRead(): boolean;
@@ -146,12 +280,22 @@ export class MemoryStream implements IStream {
 
   copyTo(stream: IStream, bufferSize?: number | undefined): void;
 
+  copyTo(stream: IStream, options: CopyToOptions): void;
+
   seek(offset: number, origin: number): void;
 
   read(buffer: BufferLike, offset?: number | undefined, count?: number | undefined): number;
 
   write(buffer: BufferLike, offset?: number | undefined, count?: number | undefined): number;
 
+  readv(buffers: BufferLike[]): number;
+
+  writev(buffers: BufferLike[]): number;
+
+  readAt(position: number, buffer: BufferLike, offset?: number, count?: number): number;
+
+  writeAt(position: number, buffer: BufferLike, offset?: number, count?: number): number;
+
   flush(): void;
 
   close(): void
@@ -161,14 +305,16 @@ export class MemoryStream implements IStream {
   set capacity(value: number)
 
   toArrayBuffer(options?: ToArrayBufferOptions): ArrayBuffer
+
+  detachToArrayBuffer(): ArrayBuffer
 }
 
 export class FileStream implements IStream {
-  constructor(path: string, mode?: number)
+  constructor(path: string, mode?: number, bufferSize?: number)
 
-  constructor(fd: number, mode?: number)
+  constructor(fd: number, mode?: number, bufferSize?: number)
 
-  constructor(rawFile: resourceManager.RawFileDescriptor)
+  constructor(rawFile: resourceManager.RawFileDescriptor, mode?: number)
 
 
   get canRead(): boolean;
@@ -185,8 +331,12 @@ export class FileStream implements IStream {
 
   copyTo(stream: IStream, bufferSize?: number | undefined): void;
 
+  copyTo(stream: IStream, options: CopyToOptions): void;
+
   copyToAsync(stream: IStream, bufferSize?: number | undefined): Promise<void>;
 
+  copyToAsync(stream: IStream, options: CopyToOptions): Promise<CopyToStats | void>;
+
   seek(offset: number, origin: number): void;
 
   read(buffer: BufferLike, offset?: number | undefined, count?: number | undefined): number;
@@ -195,6 +345,14 @@ export class FileStream implements IStream {
 
   write(buffer: BufferLike, offset?: number | undefined, count?: number | undefined): number;
 
+  readv(buffers: BufferLike[]): number;
+
+  writev(buffers: BufferLike[]): number;
+
+  readAt(position: number, buffer: BufferLike, offset?: number, count?: number): number;
+
+  writeAt(position: number, buffer: BufferLike, offset?: number, count?: number): number;
+
   writeAsync(buffer: BufferLike, offset?: number | undefined, count?: number | undefined): Promise<number>;
 
   flush(): void;
@@ -204,6 +362,18 @@ export class FileStream implements IStream {
   close(): void;
 
   closeAsync(): Promise<void>;
+
+  preallocate(length: number): boolean;
+
+  get stats(): StreamStats | undefined;
+
+  get statsEnabled(): boolean;
+
+  set statsEnabled(value: boolean);
+
+  resetStats(): void;
+
+  slice(start: number, length?: number): IStream;
 }
 
 export class DeflateStream implements IStream {
@@ -223,8 +393,12 @@ export class DeflateStream implements IStream {
 
   copyTo(stream: IStream, bufferSize?: number | undefined): void;
 
+  copyTo(stream: IStream, options: CopyToOptions): void;
+
   copyToAsync(stream: IStream, bufferSize?: number | undefined): Promise<void>;
 
+  copyToAsync(stream: IStream, options: CopyToOptions): Promise<CopyToStats | void>;
+
   seek(offset: number, origin: number): void;
 
   read(buffer: BufferLike, offset?: number | undefined, count?: number | undefined): number;
@@ -233,6 +407,14 @@ export class DeflateStream implements IStream {
 
   write(buffer: BufferLike, offset?: number | undefined, count?: number | undefined): number;
 
+  readv(buffers: BufferLike[]): number;
+
+  writev(buffers: BufferLike[]): number;
+
+  readAt(position: number, buffer: BufferLike, offset?: number, count?: number): number;
+
+  writeAt(position: number, buffer: BufferLike, offset?: number, count?: number): number;
+
   writeAsync(buffer: BufferLike, offset?: number | undefined, count?: number | undefined): Promise<number>;
 
   flush(): void;
@@ -242,6 +424,16 @@ export class DeflateStream implements IStream {
   close(): void;
 
   closeAsync(): Promise<void>;
+
+  get stats(): StreamStats | undefined;
+
+  get statsEnabled(): boolean;
+
+  set statsEnabled(value: boolean);
+
+  resetStats(): void;
+
+  slice(start: number, length?: number): IStream;
 }
 
 interface ZipCryptoStreamOption {
@@ -266,8 +458,12 @@ export class ZipCryptoStream implements IStream {
 
   copyTo(stream: IStream, bufferSize?: number | undefined): void;
 
+  copyTo(stream: IStream, options: CopyToOptions): void;
+
   copyToAsync(stream: IStream, bufferSize?: number | undefined): Promise<void>;
 
+  copyToAsync(stream: IStream, options: CopyToOptions): Promise<CopyToStats | void>;
+
   seek(offset: number, origin: number): void;
 
   read(buffer: BufferLike, offset?: number | undefined, count?: number | undefined): number;
@@ -276,6 +472,14 @@ export class ZipCryptoStream implements IStream {
 
   write(buffer: BufferLike, offset?: number | undefined, count?: number | undefined): number;
 
+  readv(buffers: BufferLike[]): number;
+
+  writev(buffers: BufferLike[]): number;
+
+  readAt(position: number, buffer: BufferLike, offset?: number, count?: number): number;
+
+  writeAt(position: number, buffer: BufferLike, offset?: number, count?: number): number;
+
   writeAsync(buffer: BufferLike, offset?: number | undefined, count?: number | undefined): Promise<number>;
 
   flush(): void;
@@ -285,6 +489,16 @@ export class ZipCryptoStream implements IStream {
   close(): void;
 
   closeAsync(): Promise<void>;
+
+  get stats(): StreamStats | undefined;
+
+  get statsEnabled(): boolean;
+
+  set statsEnabled(value: boolean);
+
+  resetStats(): void;
+
+  slice(start: number, length?: number): IStream;
 }
 
 interface ZipArchiveOption {
@@ -293,10 +507,17 @@ interface ZipArchiveOption {
   password?: string;
 }
 
+interface ZipEntryOptions {
+  threads?: number;
+  blockSize?: number;
+}
+
 export class ZipArchiveEntry {
   private constructor()
 
-  open(): IStream
+  open(index?: DeflateIndex): IStream
+
+  extractToFile(path: string): void
 
   delete(): void
 
@@ -348,7 +569,7 @@ export class ZipArchive {
 
   getEntry(entryName: string): ZipArchiveEntry | undefined
 
-  createEntry(entryName: string, compressionLevel?: number): ZipArchiveEntry
+  createEntry(entryName: string, compressionLevel?: number, options?: ZipEntryOptions): ZipArchiveEntry
 
   close(): void
 
@@ -415,8 +636,12 @@ export class MemfdStream implements IStream {
 
   copyTo(stream: IStream, bufferSize?: number | undefined): void;
 
+  copyTo(stream: IStream, options: CopyToOptions): void;
+
   copyToAsync(stream: IStream, bufferSize?: number | undefined): Promise<void>;
 
+  copyToAsync(stream: IStream, options: CopyToOptions): Promise<CopyToStats | void>;
+
   seek(offset: number, origin: number): void;
 
   read(buffer: BufferLike, offset?: number | undefined, count?: number | undefined): number;
@@ -425,6 +650,14 @@ export class MemfdStream implements IStream {
 
   write(buffer: BufferLike, offset?: number | undefined, count?: number | undefined): number;
 
+  readv(buffers: BufferLike[]): number;
+
+  writev(buffers: BufferLike[]): number;
+
+  readAt(position: number, buffer: BufferLike, offset?: number, count?: number): number;
+
+  writeAt(position: number, buffer: BufferLike, offset?: number, count?: number): number;
+
   writeAsync(buffer: BufferLike, offset?: number | undefined, count?: number | undefined): Promise<number>;
 
   flush(): void;
@@ -435,6 +668,16 @@ export class MemfdStream implements IStream {
 
   closeAsync(): Promise<void>;
 
+  get stats(): StreamStats | undefined;
+
+  get statsEnabled(): boolean;
+
+  set statsEnabled(value: boolean);
+
+  resetStats(): void;
+
+  slice(start: number, length?: number): IStream;
+
   toArrayBuffer(options?: ToArrayBufferOptions): ArrayBuffer;
 
   get fd(): number;
@@ -446,6 +689,10 @@ export class MemfdStream implements IStream {
   sendFileAsync(fd: number, options?: SendFileOptions): Promise<boolean>
 
   sendFileAsync(path: string, mode: number, options?: SendFileOptions): Promise<boolean>
+
+  seal(): void;
+
+  get sealed(): boolean;
 }
 
 export interface BrotliStreamOptions {
@@ -460,6 +707,38 @@ export class BrotliStream extends StreamBase {
   constructor(stream: IStream, mode: number, options?: BrotliStreamOptions)
 }
 
+export interface AsyncFileStreamOptions {
+  depth?: number;
+  bufferSize?: number;
+}
+
+export class AsyncFileStream extends FileStream {
+  constructor(path: string, mode?: number, options?: AsyncFileStreamOptions)
+
+  constructor(fd: number, mode?: number, options?: AsyncFileStreamOptions)
+
+  registerBuffers(buffers: ArrayBuffer[]): boolean;
+
+  get depth(): number;
+
+  get engine(): string;
+}
+
+export interface ReadAheadStreamOptions {
+  blockSize?: number;
+  depth?: number;
+  maxDepth?: number;
+  leaveOpen?: boolean;
+}
+
+export class ReadAheadStream extends StreamBase {
+  constructor(stream: IStream, options?: ReadAheadStreamOptions)
+
+  readBlock(): ArrayBuffer | undefined;
+
+  get depth(): number;
+}
+
 export interface BrotliConfig {
   quality?: number;
   lgWin?: number;
@@ -476,6 +755,23 @@ export class BrotliUtils {
   static decompressAsync(buffer: BufferLike | string): Promise<ArrayBuffer>
 }
 
+export interface DeflateUtilsOptions {
+  level?: number;
+  windowBits?: number;
+  strategy?: number;
+  uncompressSize?: number;
+}
+
+export class DeflateUtils {
+  static compress(buffer: BufferLike | string, options?: DeflateUtilsOptions): ArrayBuffer;
+
+  static decompress(buffer: BufferLike | string, options?: DeflateUtilsOptions): ArrayBuffer;
+
+  static compressAsync(buffer: BufferLike | string, options?: DeflateUtilsOptions): Promise<ArrayBuffer>;
+
+  static decompressAsync(buffer: BufferLike | string, options?: DeflateUtilsOptions): Promise<ArrayBuffer>;
+}
+
 // export abstract class TextReader {
 //   abstract read(buffer?: ArrayBuffer): number;
 //
@@ -525,8 +821,14 @@ export namespace reader {
     abstract close: void;
   }
 
+  export interface StreamReaderOptions {
+    detectEncodingFromByteOrderMarks?: boolean;
+    encoding?: string;
+    leaveOpen?: boolean
+  }
+
   export class StreamReader extends TextReader {
-    constructor(target: string | IStream, { detectEncodingFromByteOrderMarks: boolean, encoding: string })
+    constructor(target: string | IStream, options?: StreamReaderOptions)
 
     readToEnd(): string;
 
@@ -541,7 +843,42 @@ export namespace reader {
     readLine(): string;
 
     get encoding(): string;
+
+    get endOfStream(): boolean;
+  }
+
+  export class XmlReader {
+    constructor(target: string | TextReader)
+
+    read(): boolean;
+
+    get name(): string;
+
+    get value(): string;
+
+    get nodeType(): XmlNodeType;
+
+    getAttribute(attribute: string): string;
+
+    get attributes(): Record<string, string>
+
+    get isEmptyElement(): boolean;
+
+    close(): void;
   }
 
-  export class XmlReader {}
+  export enum XmlNodeType {
+    None,
+    Element,
+    Attribute,
+    Text,
+    CDATA,
+    Comment,
+    Document,
+    EndElement,
+    XmlDeclaration,
+    DocumentType,
+    ProcessingInstruction,
+    Whitespace
+  }
 }
\ No newline at end of file
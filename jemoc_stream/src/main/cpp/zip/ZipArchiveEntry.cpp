@@ -6,6 +6,7 @@
 
 #include "zip/ZipArchiveEntry.h"
 #include "stream/DeflateStream.h"
+#include "stream/FileStream.h"
 #include "stream/SubReadStream.h"
 #include "zip/CheckSumAndSizeWriteStream.h"
 #include "zip/DirectToArchiveWriterStream.h"
@@ -13,6 +14,8 @@
 #include "zip/ZipArchive.h"
 #include "zip/ZipCryptoStream.h"
 #include "zip/ZipRecord.h"
+#include <cstring>
+#include <unistd.h>
 
 
 static ushort mapCompressionLevel(ushort flag, ushort compressionMethod) {
@@ -165,6 +168,11 @@ void ZipArchiveEntry::setIsEncrypted(const bool &value) {
 }
 CompressionLevel ZipArchiveEntry::getCompressionLevel() const { return CompressionLevel((flags & 0x6) >> 1); }
 void ZipArchiveEntry::setCompressionLevel(CompressionLevel level) { flags = flags & 0xf9 | (level << 1); }
+
+void ZipArchiveEntry::setDeflateThreads(int threads, size_t blockSize) {
+    m_deflateThreads = std::max(threads, 1);
+    m_deflateBlockSize = blockSize;
+}
 bool ZipArchiveEntry::getHasDataDescriptor() const { return flags & GeneralPurposeBitFlag_DataDescriptor; }
 void ZipArchiveEntry::setHasDataDescriptor(bool value) {
     flags = flags & ~GeneralPurposeBitFlag_DataDescriptor | (value << 3);
@@ -219,10 +227,10 @@ long ZipArchiveEntry::getOffsetOfCompressedData() {
 }
 
 
-std::shared_ptr<IStream> ZipArchiveEntry::open() {
+std::shared_ptr<IStream> ZipArchiveEntry::open(std::shared_ptr<DeflateIndex> index) {
     switch (m_archive->getMode()) {
     case ZipArchiveMode_Read:
-        return openInReadMode();
+        return openInReadMode(index);
     case ZipArchiveMode_Create:
         return openInCreateMode();
     case ZipArchiveMode_Update:
@@ -230,6 +238,42 @@ std::shared_ptr<IStream> ZipArchiveEntry::open() {
     }
 }
 
+void ZipArchiveEntry::extractToFile(const std::string &path) {
+    if (m_archive->getMode() == ZipArchiveMode_Create)
+        throw std::ios::failure("cannot extract entries in create mode.");
+    if (m_currentlyOpenForWrite)
+        throw std::ios::failure("cannot extract an entry currently open for writing.");
+    // 原样保留在归档中的条目直接解压，不经过open()：update模式下open()会把条目标记为已修改，
+    // 关闭归档时重新压缩，并且先把整个条目解压到内存。只有修改过的条目才从内存中的数据写出
+    bool modified = m_everOpenedForWrite || !m_originallyInArchive;
+    std::shared_ptr<IStream> source;
+    if (modified) {
+        source = getUncompressedData();
+        source->seek(0, SeekOrigin::Begin);
+    } else {
+        source = openInReadMode();
+    }
+    bool created = false;
+    try {
+        FileStream target(path, FILE_MODE(FILE_MODE_WRITE | FILE_MODE_TRUNC), 64 * 1024);
+        created = true;
+        // 修改过的条目大小已经不可信，不预留
+        if (!modified && uncompressedSize > 0)
+            target.preallocate(uncompressedSize);
+        source->copyTo(&target, 64 * 1024);
+        target.close();
+    } catch (...) {
+        // 不留下只写了一部分的文件
+        if (created)
+            ::unlink(path.c_str());
+        if (!modified)
+            source->close();
+        throw;
+    }
+    if (!modified)
+        source->close();
+}
+
 void ZipArchiveEntry::Delete() {
     if (m_archive->isClosed())
         return;
@@ -249,7 +293,7 @@ void ZipArchiveEntry::setFullName(const std::string &entryName) {
     memcpy(fileName, m_stored_fullname.c_str(), fileNameLength);
 }
 
-std::shared_ptr<IStream> ZipArchiveEntry::openInReadMode() {
+std::shared_ptr<IStream> ZipArchiveEntry::openInReadMode(std::shared_ptr<DeflateIndex> index) {
 //    IStream *stream =
 //        new SubReadStream(m_archive->getArchiveStream(), getOffsetOfCompressedData(), compressedSize, true);
     std::shared_ptr<IStream> stream = std::make_shared<SubReadStream>(
@@ -259,7 +303,7 @@ std::shared_ptr<IStream> ZipArchiveEntry::openInReadMode() {
 //        stream = new ZipCryptoStream(stream, CryptoMode_Decode, this, false);
 //         stream = new ZipCryptoStream(stream, CryptoMode_Decode, m_archive->getPassword(), false, crc);
     }
-    return getDataDecompressor(stream);
+    return getDataDecompressor(stream, index);
 }
 
 std::shared_ptr<IStream> ZipArchiveEntry::openInUpdateMode() {
@@ -295,7 +339,8 @@ std::shared_ptr<IStream> ZipArchiveEntry::getUncompressedData() {
 }
 
 
-std::shared_ptr<IStream> ZipArchiveEntry::getDataDecompressor(std::shared_ptr<IStream> stream) {
+std::shared_ptr<IStream> ZipArchiveEntry::getDataDecompressor(std::shared_ptr<IStream> stream,
+                                                             std::shared_ptr<DeflateIndex> index) {
 //    IStream *decompressor = stream;
     std::shared_ptr<IStream> decompressor = stream;
     if (compressionMethod == CompressionMethod::Deflate || compressionMethod == CompressionMethod::Deflate64) {
@@ -303,6 +348,8 @@ std::shared_ptr<IStream> ZipArchiveEntry::getDataDecompressor(std::shared_ptr<IS
 //                                         m_compression_level, false, 8192, uncompressedSize);
         decompressor = std::make_shared<DeflateStream>(stream, DeflateMode_Decompress, -15, m_compression_level, false,
                                                        8192, uncompressedSize);
+        if (index != nullptr)
+            static_cast<DeflateStream *>(decompressor.get())->setIndex(index);
     }
 
     return decompressor;
@@ -325,9 +372,9 @@ std::shared_ptr<IStream> ZipArchiveEntry::getDataCompressor(std::shared_ptr<IStr
     case CompressionMethod::Deflate:
     case CompressionMethod::Deflate64:
     default:
-        compressorStream = std::make_shared<DeflateStream>(compressorStream, DeflateMode_Compress, -15,
-                                                           getZlibCompressionLevel(getCompressionLevel()),
-                                                           isBase ? leaveOpen && true : false);
+        compressorStream = std::make_shared<DeflateStream>(
+            compressorStream, DeflateMode_Compress, -15, getZlibCompressionLevel(getCompressionLevel()),
+            isBase ? leaveOpen && true : false, DEFAULT_BUFFER_SIZE, -1, m_deflateThreads, m_deflateBlockSize);
 //            new DeflateStream(compressorStream, DeflateMode_Compress, -15,
 //                              getZlibCompressionLevel(getCompressionLevel()), isBase ? leaveOpen && true :
         //                              false);
@@ -367,13 +414,16 @@ std::shared_ptr<IStream> ZipArchiveEntry::openInCreateMode() {
 
 CompressionMethod ZipArchiveEntry::getCompressionMethod() const { return CompressionMethod(compressionMethod); }
 
-bool ZipArchiveEntry::writeLocalFileHeader() {
+bool ZipArchiveEntry::writeLocalFileHeader(bool isEmptyFile) {
+    // 空条目按存储方式写入，中央目录与本地文件头保持一致
+    if (isEmptyFile)
+        compressionMethod = Stored;
     headerOffset = m_archive->getArchiveStream()->getPosition();
     ZipLocalFileHeader header;
     header.signature = ZIP_LOCALFILEHEADER_SIGNATURE;
     header.version = versionToExtract;
     header.flags = flags;
-    header.compression = uncompressedSize == 0 ? CompressionLevel_NoCompression : compressionMethod;
+    header.compression = compressionMethod;
     header.lastModifier = lastModifier;
     header.crc = crc;
     header.compressedSize = compressedSize;
@@ -439,11 +489,11 @@ void ZipArchiveEntry::writeLocalFileHeaderAndDataIfNeeded() {
         entryWriter->close();
         delete entryWriter;
         entryWriter = nullptr;
-    } else {
+    } else if (compressedBytes != nullptr) {
         if (uncompressedSize == 0) {
             compressedSize = 0;
         }
-        writeLocalFileHeader();
+        writeLocalFileHeader(uncompressedSize == 0);
 
         if (uncompressedSize != 0) {
             m_archive->getArchiveStream()->write((void *)compressedBytes->getData(), 0, compressedBytes->getLength());
@@ -452,6 +502,11 @@ void ZipArchiveEntry::writeLocalFileHeaderAndDataIfNeeded() {
 //            delete compressedBytes;
             compressedBytes = nullptr;
         }
+    } else if (m_archive->getMode() == ZipArchiveMode_Update || !m_everOpenedForWrite) {
+        // 没有数据的条目仍需写入文件头，create模式下已经直接写入归档流的条目不再重复写入
+        m_everOpenedForWrite = true;
+        compressedSize = 0;
+        writeLocalFileHeader(true);
     }
 }
 
@@ -531,285 +586,3 @@ void ZipArchiveEntry::closeStream() {
 
 
 ZipArchive *ZipArchiveEntry::getArchive() { return m_archive; }
-
-
-#ifndef DEFINE_ZipArchiveEntry_NAPI
-#define DEFINE_ZipArchiveEntry_NAPI
-#define GET_ZIPARCHIVE_ENTRY_INFO(number)                                                                              \
-    napi_value argv[number];                                                                                           \
-    size_t argc = number;                                                                                              \
-    napi_value _this = nullptr;                                                                                        \
-    NAPI_CALL(env, napi_get_cb_info(env, info, &argc, argv, &_this, nullptr))
-
-#define GET_ZIPARCHIVE_ENTRY_INFO_WITH_ENTRY(number)                                                                   \
-    GET_ZIPARCHIVE_ENTRY_INFO(number)                                                                                  \
-    ZipArchiveEntry *entry = getEntry(env, _this);                                                                     \
-    if (entry == nullptr)                                                                                              \
-        napi_throw_error(env, "ZipArchiveEntry", "entry is null");
-
-
-std::string ZipArchiveEntry::ClassName = "ZipArchiveEntry";
-
-napi_ref ZipArchiveEntry::cons = nullptr;
-
-void ZipArchiveEntry::Export(napi_env env, napi_value exports) {
-    napi_property_descriptor desc[] = {
-        DEFINE_NAPI_FUNCTION("open", JSOpen, nullptr, nullptr, nullptr),
-        DEFINE_NAPI_FUNCTION("isEncrypted", nullptr, JSGetIsEncrypted, JSSetIsEncrypted, nullptr),
-        DEFINE_NAPI_FUNCTION("compressionLevel", nullptr, JSGetCompressionLevel, JSSetCompressionLevel, nullptr),
-        DEFINE_NAPI_FUNCTION("fileComment", nullptr, JSGetFileComment, JSSetFileComment, nullptr),
-        DEFINE_NAPI_FUNCTION("fullName", nullptr, JSGetFullName, JSSetFullName, nullptr),
-        DEFINE_NAPI_FUNCTION("compressionMethod", nullptr, JSGetCompressionMethod, JSSetCompressionMethod, nullptr),
-        DEFINE_NAPI_FUNCTION("lastModifier", nullptr, JSGetLastModifier, JSSetLastModifier, nullptr),
-        DEFINE_NAPI_FUNCTION("isOpened", nullptr, JSGetIsOpened, nullptr, nullptr),
-        DEFINE_NAPI_FUNCTION("crc32", nullptr, JSGetCRC, nullptr, nullptr),
-        DEFINE_NAPI_FUNCTION("delete", JSDelete, nullptr, nullptr, nullptr),
-        DEFINE_NAPI_FUNCTION("isDeleted", nullptr, JSGetIsDeleted, nullptr, nullptr),
-        DEFINE_NAPI_FUNCTION("uncompressedSize", nullptr, JSGetUnCompressedSize, nullptr, nullptr),
-        DEFINE_NAPI_FUNCTION("compressedSize", nullptr, JSGetCompressedSize, nullptr, nullptr)
-
-    };
-    napi_value napi_cons = nullptr;
-    NAPI_CALL(env, napi_define_class(env, ClassName.c_str(), NAPI_AUTO_LENGTH, JSConstructor, nullptr,
-                                     sizeof(desc) / sizeof(desc[0]), desc, &napi_cons))
-    NAPI_CALL(env, napi_set_named_property(env, exports, ClassName.c_str(), napi_cons))
-    NAPI_CALL(env, napi_create_reference(env, napi_cons, 1, &cons))
-}
-
-napi_value ZipArchiveEntry::JSConstructor(napi_env env, napi_callback_info info) {
-    GET_ZIPARCHIVE_ENTRY_INFO(0)
-    return _this;
-}
-
-
-ZipArchiveEntry *ZipArchiveEntry::getEntry(napi_env env, napi_value value) {
-    napi_valuetype type;
-    NAPI_CALL(env, napi_typeof(env, value, &type))
-    if (napi_undefined == type)
-        return nullptr;
-    void *result = nullptr;
-    napi_unwrap(env, value, &result);
-    return static_cast<ZipArchiveEntry *>(result);
-}
-
-void ZipArchiveEntry::JSDispose(napi_env env, void *data, void *hint) {
-    ZipArchiveEntry *entry = static_cast<ZipArchiveEntry *>(data);
-    delete entry;
-    entry = nullptr;
-}
-
-napi_value ZipArchiveEntry::open(napi_env env) {
-    std::shared_ptr<IStream> stream = open();
-//    openingStream = stream;
-    napi_value result = IStream::JSCreateInterface(env, stream);
-//     NAPI_CALL(env, napi_create_reference(env, result, 1, &jsOpeningStream))
-    return result;
-}
-
-napi_value ZipArchiveEntry::JSOpen(napi_env env, napi_callback_info info) {
-    GET_ZIPARCHIVE_ENTRY_INFO_WITH_ENTRY(0)
-    try {
-        return entry->open(env);
-    } catch (const std::exception &e) {
-        napi_throw_error(env, "ZipArchiveEntry", (std::string("open failed: ") + e.what()).c_str());
-    }
-    return nullptr;
-}
-
-napi_value ZipArchiveEntry::getJSEntry(napi_env env) {
-    napi_value result = nullptr;
-    if (jsEntry != nullptr) {
-        NAPI_CALL(env, napi_get_reference_value(env, jsEntry, &result));
-    } else {
-        napi_value napi_cons = nullptr;
-        NAPI_CALL(env, napi_get_reference_value(env, cons, &napi_cons))
-        NAPI_CALL(env, napi_new_instance(env, napi_cons, 0, nullptr, &result))
-        napi_wrap(env, result, this, JSDispose, nullptr, &jsEntry);
-    }
-    return result;
-}
-
-void ZipArchiveEntry::releaseJSEntry(napi_env env) {
-    if (jsEntry == nullptr)
-        return;
-
-    napi_value value = nullptr;
-    NAPI_CALL(env, napi_get_reference_value(env, jsEntry, &value))
-    if (value == nullptr)
-        return;
-
-    uint ref_count = 0;
-    NAPI_CALL(env, napi_reference_unref(env, jsEntry, &ref_count))
-    if (ref_count > 0) {
-        NAPI_CALL(env, napi_delete_reference(env, jsEntry))
-    }
-    void *_this = nullptr;
-    NAPI_CALL(env, napi_remove_wrap(env, value, &_this))
-
-
-    jsEntry = nullptr;
-}
-
-napi_value ZipArchiveEntry::JSSetIsEncrypted(napi_env env, napi_callback_info info) {
-    GET_ZIPARCHIVE_ENTRY_INFO_WITH_ENTRY(1)
-    if (entry->m_archive->getMode() == ZipArchiveMode_Read)
-        napi_throw_error(env, ClassName.c_str(), "can not set isEncrypted in read mode.");
-    if (entry->m_everOpenedForWrite)
-        napi_throw_error(env, ClassName.c_str(), "can not set isEncrypted after open.");
-    bool isEncrypted = false;
-    NAPI_CALL(env, napi_get_value_bool(env, argv[0], &isEncrypted))
-    entry->setIsEncrypted(isEncrypted);
-    return nullptr;
-}
-
-napi_value ZipArchiveEntry::JSGetIsEncrypted(napi_env env, napi_callback_info info) {
-    GET_ZIPARCHIVE_ENTRY_INFO_WITH_ENTRY(0)
-    napi_value result = nullptr;
-    NAPI_CALL(env, napi_get_boolean(env, entry->getIsEncrypted(), &result))
-    return result;
-}
-
-napi_value ZipArchiveEntry::JSGetCompressionLevel(napi_env env, napi_callback_info info) {
-    GET_ZIPARCHIVE_ENTRY_INFO_WITH_ENTRY(0)
-    napi_value result = nullptr;
-    NAPI_CALL(env, napi_create_int32(env, entry->getCompressionLevel(), &result))
-    return result;
-}
-
-napi_value ZipArchiveEntry::JSSetCompressionLevel(napi_env env, napi_callback_info info) {
-    GET_ZIPARCHIVE_ENTRY_INFO_WITH_ENTRY(1)
-    if (entry->m_archive->getMode() == ZipArchiveMode_Read)
-        napi_throw_error(env, ClassName.c_str(), "can not set compression level in read mode.");
-    if (entry->m_everOpenedForWrite)
-        napi_throw_error(env, ClassName.c_str(), "can not set compression level after open.");
-    int level = 0;
-    NAPI_CALL(env, napi_get_value_int32(env, argv[0], &level))
-    entry->setCompressionLevel(CompressionLevel(level));
-    return nullptr;
-}
-
-napi_value ZipArchiveEntry::JSSetFileComment(napi_env env, napi_callback_info info) {
-    GET_ZIPARCHIVE_ENTRY_INFO_WITH_ENTRY(1)
-    if (entry->m_archive->getMode() == ZipArchiveMode_Read)
-        napi_throw_error(env, ClassName.c_str(), "can not set file comment in read mode.");
-    std::string comment = getString(env, argv[0]);
-    entry->setComment(comment);
-    return nullptr;
-}
-
-napi_value ZipArchiveEntry::JSGetFileComment(napi_env env, napi_callback_info info) {
-    GET_ZIPARCHIVE_ENTRY_INFO_WITH_ENTRY(1)
-    napi_value result = nullptr;
-    NAPI_CALL(env, napi_create_string_utf8(env, entry->getComment().c_str(), NAPI_AUTO_LENGTH, &result))
-    return result;
-}
-
-napi_value ZipArchiveEntry::JSGetFullName(napi_env env, napi_callback_info info) {
-    GET_ZIPARCHIVE_ENTRY_INFO_WITH_ENTRY(1)
-    napi_value result = nullptr;
-    NAPI_CALL(env, napi_create_string_utf8(env, entry->getFullName().c_str(), NAPI_AUTO_LENGTH, &result))
-    return result;
-}
-napi_value ZipArchiveEntry::JSSetFullName(napi_env env, napi_callback_info info) {
-    GET_ZIPARCHIVE_ENTRY_INFO_WITH_ENTRY(1)
-    if (entry->m_archive->getMode() == ZipArchiveMode_Read)
-        napi_throw_error(env, ClassName.c_str(), "can not set fullName in read mode.");
-    std::string name = getString(env, argv[0]);
-    entry->setFullName(name);
-    return nullptr;
-}
-napi_value ZipArchiveEntry::JSGetCompressionMethod(napi_env env, napi_callback_info info) {
-    GET_ZIPARCHIVE_ENTRY_INFO_WITH_ENTRY(0)
-    napi_value result = nullptr;
-    NAPI_CALL(env, napi_create_int32(env, entry->getCompressionMethod(), &result))
-    return result;
-}
-napi_value ZipArchiveEntry::JSSetCompressionMethod(napi_env env, napi_callback_info info) {
-    GET_ZIPARCHIVE_ENTRY_INFO_WITH_ENTRY(1)
-    if (entry->m_archive->getMode() == ZipArchiveMode_Read)
-        napi_throw_error(env, ClassName.c_str(), "can not set compression method in read mode.");
-    if (entry->m_everOpenedForWrite)
-        napi_throw_error(env, ClassName.c_str(), "can not set compression method after open.");
-    int method = 0;
-    NAPI_CALL(env, napi_get_value_int32(env, argv[0], &method))
-    entry->setCompressionMethod(CompressionMethod(method));
-    return nullptr;
-}
-napi_value ZipArchiveEntry::JSSetLastModifier(napi_env env, napi_callback_info info) {
-    GET_ZIPARCHIVE_ENTRY_INFO_WITH_ENTRY(1)
-    double timestamp = 0;
-    NAPI_CALL(env, napi_get_date_value(env, argv[0], &timestamp))
-    entry->setLastModifier(timestamp);
-    return nullptr;
-}
-
-napi_value ZipArchiveEntry::JSGetLastModifier(napi_env env, napi_callback_info info) {
-    GET_ZIPARCHIVE_ENTRY_INFO_WITH_ENTRY(0)
-    napi_value result = nullptr;
-    NAPI_CALL(env, napi_create_date(env, entry->getLastModifier(), &result))
-    return result;
-}
-
-napi_value ZipArchiveEntry::JSGetIsOpened(napi_env env, napi_callback_info info) {
-    GET_ZIPARCHIVE_ENTRY_INFO_WITH_ENTRY(0)
-    napi_value result = nullptr;
-    NAPI_CALL(env, napi_get_boolean(env, entry->m_everOpenedForWrite, &result))
-    return result;
-}
-
-napi_value ZipArchiveEntry::JSGetCRC(napi_env env, napi_callback_info info) {
-    GET_ZIPARCHIVE_ENTRY_INFO_WITH_ENTRY(0)
-    napi_value result = nullptr;
-    NAPI_CALL(env, napi_create_uint32(env, entry->crc, &result))
-    return result;
-}
-
-void ZipArchiveEntry::Delete(napi_env env) {
-    Delete();
-    releaseJSEntry(env);
-}
-
-napi_value ZipArchiveEntry::JSDelete(napi_env env, napi_callback_info info) {
-    GET_ZIPARCHIVE_ENTRY_INFO_WITH_ENTRY(0)
-    try {
-        entry->Delete(env);
-    } catch (const std::exception &e) {
-        napi_throw_error(env, ClassName.c_str(), e.what());
-    }
-    return nullptr;
-}
-
-napi_value ZipArchiveEntry::JSGetIsDeleted(napi_env env, napi_callback_info info) {
-    GET_ZIPARCHIVE_ENTRY_INFO(0)
-    ZipArchiveEntry *entry = getEntry(env, _this);
-    bool value = entry == nullptr;
-    napi_value result = nullptr;
-    NAPI_CALL(env, napi_get_boolean(env, value, &result))
-    return result;
-}
-
-napi_value ZipArchiveEntry::JSGetUnCompressedSize(napi_env env, napi_callback_info info) {
-    GET_ZIPARCHIVE_ENTRY_INFO_WITH_ENTRY(0)
-    napi_value result = nullptr;
-    long size = 0;
-    entry->getArchive()->getMode();
-    if (entry->getArchive()->getMode() != ZipArchiveMode_Create && !entry->m_everOpenedForWrite) {
-        size = entry->uncompressedSize;
-    }
-    NAPI_CALL(env, napi_create_int64(env, size, &result));
-    return result;
-}
-napi_value ZipArchiveEntry::JSGetCompressedSize(napi_env env, napi_callback_info info) {
-    GET_ZIPARCHIVE_ENTRY_INFO_WITH_ENTRY(0)
-    napi_value result = nullptr;
-    long size = 0;
-    entry->getArchive()->getMode();
-    if (entry->getArchive()->getMode() != ZipArchiveMode_Create && !entry->m_everOpenedForWrite) {
-        size = entry->compressedSize;
-    }
-    NAPI_CALL(env, napi_create_int64(env, size, &result));
-    return result;
-}
-
-
-#endif // DEFINE_ZipArchiveEntry_NAPI
@@ -8,11 +8,9 @@
 #include "zip/ZipArchive.h"
 #include "zip/ZipArchiveEntry.h"
 #include <cstdint>
+#include <cstring>
 
 
-std::string ZipCryptoStream::ClassName = "ZipCryptoStream";
-napi_ref ZipCryptoStream::cons = nullptr;
-
 ZipCryptoStream::ZipCryptoStream(std::shared_ptr<IStream> stream, CryptoMode mode, const std::string &password,
                                  bool leaveOpen, unsigned long crc, size_t bufferSize)
     : m_stream(stream), m_mode(mode), m_password(password), m_leaveOpen(leaveOpen), m_crc(crc),
@@ -188,52 +186,3 @@ void ZipCryptoStream::close() {
 
 long ZipCryptoStream::getPosition() const { throw std::ios::failure("ZipCryptoStream: not support get position"); }
 long ZipCryptoStream::getLength() const { throw std::ios::failure("ZipCryptoStream: not support get length."); }
-
-napi_value ZipCryptoStream::JSConstructor(napi_env env, napi_callback_info info) {
-    GET_JS_INFO_WITHOUT_STREAM(5)
-    std::shared_ptr<IStream> stream = IStream::GetStream(env, argv[0]);
-
-    if (stream == nullptr)
-        napi_throw_error(env, "ZipCryptoStream", "argument stream is null");
-    int mode = getInt(env, argv[1]);
-    std::string passwd = getString(env, argv[2]);
-    unsigned char crc = getLong(env, argv[3]);
-    long bufferSize = 8192;
-    bool leaveOpen = false;
-    napi_value value = nullptr;
-    napi_valuetype type;
-    GET_OBJ(argv[4], "bufferSize", napi_get_value_int64, bufferSize);
-    GET_OBJ(argv[4], "leaveOpen", napi_get_value_bool, leaveOpen);
-
-    try {
-        std::shared_ptr<IStream> cryptoStream =
-            std::make_shared<ZipCryptoStream>(stream, CryptoMode(mode), passwd, leaveOpen, crc, bufferSize);
-//        ZipCryptoStream *cryptoStream =
-//            new ZipCryptoStream(stream, CryptoMode(mode), passwd, leaveOpen, crc, bufferSize);
-        if (napi_ok != napi_wrap(env, _this, new SharedPtrWrapper(cryptoStream), JSDispose, nullptr, nullptr))
-            throw std::ios::failure("napi_wrap failed");
-    } catch (const std::ios::failure &e) {
-        napi_throw_error(env, "ZipCryptoStream", e.what());
-        return nullptr;
-    }
-
-    return _this;
-}
-
-void ZipCryptoStream::JSDispose(napi_env env, void *data, void *hint) {
-//    ZipCryptoStream *stream = static_cast<ZipCryptoStream *>(data);
-//    stream->close();
-    SharedPtrWrapper *wrapper = static_cast<SharedPtrWrapper *>(data);
-    delete wrapper;
-}
-
-void ZipCryptoStream::Export(napi_env env, napi_value exports) {
-    napi_property_descriptor desc[] = {
-        DEFINE_NAPI_ISTREAM_PROPERTY((void *)ClassName.c_str()),
-    };
-    napi_value napi_cons = nullptr;
-    napi_define_class(env, ClassName.c_str(), NAPI_AUTO_LENGTH, JSConstructor, nullptr, sizeof(desc) / sizeof(desc[0]),
-                      desc, &napi_cons);
-    napi_create_reference(env, napi_cons, 1, &cons);
-    napi_set_named_property(env, exports, ClassName.c_str(), napi_cons);
-}
\ No newline at end of file
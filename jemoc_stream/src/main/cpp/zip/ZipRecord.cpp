@@ -6,6 +6,7 @@
 
 #include "zip/ZipRecord.h"
 #include <cstdint>
+#include <cstring>
 
 bool ZipEndOfCentralDirectoryRecord::tryReadRecord(IStream *stream, ZipEndOfCentralDirectoryRecord *record) {
     stream->read(record, 0, sizeof(ZipEndOfCentralDirectoryRecord));
@@ -1,6 +1,6 @@
-import { IStream } from './IStream'
+import { IStream, SeekOrigin } from './IStream'
 
-const chunkSize: number = 1024 * 8;
+const DEFAULT_CHUNK_SIZE: number = 1024 * 8;
 
 /**
  * 分块迭代器实现
@@ -17,24 +17,49 @@ export class ChunkIterator implements AsyncIterable<Uint8Array>, Iterable<Uint8A
       throw new Error('Stream is not readable');
     }
     this.baseStream = stream;
-    this.chunkSize = Math.max(1, chunkSize ?? chunkSize);
+    this.chunkSize = Math.max(1, chunkSize ?? DEFAULT_CHUNK_SIZE);
   }
 
   async * [Symbol.asyncIterator]() {
+    // 可seek的流在返回当前块之前先提交下一块的读取，读取队列按提交顺序执行；提前结束时退回预读的数据。
+    // 不可seek的流无法退回预读的数据，不预读
+    let readAhead = this.baseStream.canSeek;
     let buffer = new Uint8Array(this.chunkSize);
-    let actualRead: number;
+    let pending: Promise<number> = this.baseStream.readAsync(buffer);
+    let prefetching = false;
+    let actualRead: number = 0;
 
-    while (true) {
-      try {
-        actualRead = await this.baseStream.readAsync(buffer);
-        if (actualRead <= 0) {
-          break;
+    try {
+      while (true) {
+        try {
+          actualRead = await pending;
+          prefetching = false;
+          if (actualRead <= 0) {
+            break;
+          }
+        } catch (e) {
+          throw new Error(`Async stream read failed: ${e.message}`);
+        }
+        let chunk = buffer.subarray(0, actualRead);
+        // 每块使用新的缓冲区，进行中的读取不会覆盖调用方仍持有的块
+        buffer = new Uint8Array(this.chunkSize);
+        if (readAhead) {
+          pending = this.baseStream.readAsync(buffer);
+          prefetching = true;
+        }
+        yield chunk;
+        if (!readAhead) {
+          pending = this.baseStream.readAsync(buffer);
+        }
+      }
+    } finally {
+      // 提前结束迭代时丢弃预读的块，并将指针退回到已返回数据的末尾
+      if (prefetching) {
+        let prefetched = await pending.catch((): number => 0);
+        if (prefetched > 0) {
+          this.baseStream.seek(-prefetched, SeekOrigin.Current);
         }
-      } catch (e) {
-        throw new Error(`Async stream read failed: ${e.message}`);
       }
-      // Directly use the buffer view with actual read bytes
-      yield buffer.subarray(0, actualRead);
     }
   }
 
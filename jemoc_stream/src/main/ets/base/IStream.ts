@@ -1,7 +1,103 @@
+import { BufferPool } from '../bufferpool/Index'
+
 export enum SeekOrigin { Begin, Current, End }
 
 type BufferLike = ArrayBufferLike | Uint8Array
 
+export interface CopyToOptions {
+  /**
+   * 拷贝缓冲大小，默认8192
+   */
+  bufferSize?: number;
+  /**
+   * copyTo写入非原生流时块大小的上限，块大小从bufferSize开始随写入吞吐逐步翻倍，默认1MB
+   */
+  maxBufferSize?: number;
+  /**
+   * copyTo写入非原生流时暂存buffer的缓冲池，多次调用间复用同一块内存
+   */
+  bufferPool?: BufferPool;
+  /**
+   * 是否启用流水线拷贝，读和写分别在两个线程上进行
+   */
+  pipeline?: boolean;
+  /**
+   * 流水线缓冲区个数，默认4，取值范围2~64
+   */
+  depth?: number;
+}
+
+export interface CopyToStats {
+  /**
+   * 拷贝的字节数
+   */
+  bytes: number;
+  /**
+   * 总耗时，单位毫秒
+   */
+  elapsedTime: number;
+  /**
+   * 读线程等待空闲缓冲区的时间，单位毫秒。该值较大说明写入是瓶颈
+   */
+  readStallTime: number;
+  /**
+   * 写线程等待数据的时间，单位毫秒。该值较大说明读取(解压)是瓶颈
+   */
+  writeStallTime: number;
+}
+
+export interface StreamOpStats {
+  /**
+   * 调用次数
+   */
+  count: number;
+  /**
+   * 读写的字节数，flush和seek恒为0
+   */
+  bytes: number;
+  /**
+   * 累计耗时，单位毫秒
+   */
+  totalTime: number;
+  /**
+   * 单次调用的最大耗时，单位毫秒
+   */
+  maxTime: number;
+  /**
+   * 调用期间当前线程发生的缺页次数(不需要读盘)
+   */
+  minorFaults: number;
+  /**
+   * 调用期间当前线程发生的需要读盘的缺页次数
+   */
+  majorFaults: number;
+}
+
+export interface StreamAsyncStats {
+  /**
+   * readAsync/writeAsync/flushAsync的调用次数
+   */
+  count: number;
+  /**
+   * 任务从提交到开始执行的累计排队时间，单位毫秒
+   */
+  queuedTime: number;
+  maxQueuedTime: number;
+  /**
+   * 任务在工作线程上的累计执行时间，单位毫秒
+   */
+  executeTime: number;
+  maxExecuteTime: number;
+}
+
+export interface StreamStats {
+  read: StreamOpStats;
+  write: StreamOpStats;
+  flush: StreamOpStats;
+  seek: StreamOpStats;
+  async: StreamAsyncStats;
+}
+
 export interface IStream {
   /**
    * 流是否可读
@@ -46,6 +142,14 @@ export interface IStream {
    */
   copyTo(stream: IStream, bufferSize?: number): void
 
+  /**
+   * 拷贝从指针位置到流末端的数据到指定流（Stream)中.并推动指针到末端
+   * 目标为js实现的流时，块大小在bufferSize与maxBufferSize之间自适应，可通过bufferPool复用暂存buffer
+   * @param stream 拷贝接收对象
+   * @param options 拷贝选项
+   */
+  copyTo(stream: IStream, options: CopyToOptions): void
+
   /**
    * 拷贝从指针位置到流末端的数据到指定流（Stream)中.并推动指针到末端
    * @param stream 拷贝接收对象
@@ -53,6 +157,14 @@ export interface IStream {
    */
   copyToAsync(stream: IStream, bufferSize?: number): Promise<void>
 
+  /**
+   * 拷贝从指针位置到流末端的数据到指定流（Stream)中.并推动指针到末端
+   * 设置pipeline为true时读写在两个线程上流水线进行，返回拷贝统计
+   * @param stream 拷贝接收对象
+   * @param options 拷贝选项
+   */
+  copyToAsync(stream: IStream, options: CopyToOptions): Promise<CopyToStats | void>
+
   /**
    * 随机访问，指定指针位置
    * @param offset 相对偏移
@@ -92,6 +204,40 @@ export interface IStream {
    */
   writeAsync(buffer: BufferLike, offset?: number, count?: number): Promise<number>
 
+  /**
+   * 分散读，按顺序把流中的数据依次填满buffers中的每个buffer，并推动指针位置
+   * @param buffers 接受数据的buffer数组
+   * @returns 实际读取大小，读到流末尾时可能小于buffers总长度
+   */
+  readv(buffers: BufferLike[]): number
+
+  /**
+   * 集中写，把buffers中的数据按顺序一次写入流中，并推动指针位置
+   * @param buffers 要写入的buffer数组
+   * @returns 实际写入大小
+   */
+  writev(buffers: BufferLike[]): number
+
+  /**
+   * 从流的指定位置读取数据到buffer中，不移动流指针，可供多个线程并发读取
+   * @param position 流中的读取位置
+   * @param buffer 接受buffer
+   * @param offset buffer地址偏移。offset不可为负数
+   * @param count 读取大小
+   * @returns 实际读取大小
+   */
+  readAt(position: number, buffer: BufferLike, offset?: number, count?: number): number
+
+  /**
+   * 将buffer数据写入流的指定位置，不移动流指针
+   * @param position 流中的写入位置
+   * @param buffer 要写入的数据
+   * @param offset 数据buffer的地址偏移。offset不可为负数
+   * @param count 写入大小
+   * @returns 实际写入大小
+   */
+  writeAt(position: number, buffer: BufferLike, offset?: number, count?: number): number
+
   /**
    * 刷新流
    */
@@ -111,4 +257,21 @@ export interface IStream {
    * 关闭流对象，并释放流
    */
   closeAsync(): Promise<void>
+
+  /**
+   * 流的吞吐和耗时统计，从未开启统计时为undefined
+   */
+  get stats(): StreamStats | undefined
+
+  /**
+   * 是否开启统计，也可通过StreamBase.setGlobalStatsEnabled对之后创建的流统一开启
+   */
+  get statsEnabled(): boolean
+
+  set statsEnabled(value: boolean)
+
+  /**
+   * 清空已记录的统计
+   */
+  resetStats(): void
 }
\ No newline at end of file